@@ -0,0 +1,361 @@
+#include "CrashCorpus.h"
+#include "CrashSignature.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QMultiMap>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+
+const QString CrashCorpus::INDEX_FILE_NAME = QString::fromUtf8(".megacrashindex");
+
+namespace
+{
+const quint32 INDEX_MAGIC = 0x4d434958;
+const quint32 INDEX_VERSION = 2;
+
+const char BANNER[] = "MEGAprivate ERROR DUMP";
+const char APPLICATION_PREFIX[] = "Application: ";
+const char VERSION_PREFIX[] = "Version code: ";
+
+bool startsWith(const char* line, qint64 length, const char* prefix)
+{
+    qint64 prefixLength = static_cast<qint64>(strlen(prefix));
+    return length >= prefixLength && !memcmp(line, prefix, static_cast<size_t>(prefixLength));
+}
+}
+
+bool CrashCorpus::load(const QString& folder)
+{
+    QDir dir(folder);
+    if (!dir.exists())
+    {
+        return false;
+    }
+
+    mFolder = folder;
+    mFiles.clear();
+    mReports.clear();
+    mGroups.clear();
+
+    QHash<QString, FileEntry> indexed;
+    readIndex(indexed);
+
+    bool changed = false;
+    QFileInfoList fiList = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::Time);
+    for (const QFileInfo& fi : fiList)
+    {
+        if (fi.fileName() == INDEX_FILE_NAME)
+        {
+            continue;
+        }
+
+        FileEntry entry;
+        auto it = indexed.constFind(fi.fileName());
+        if (it != indexed.constEnd()
+                && it->size == fi.size()
+                && it->lastModified == fi.lastModified().toMSecsSinceEpoch())
+        {
+            entry = it.value();
+        }
+        else
+        {
+            entry.name = fi.fileName();
+            entry.size = fi.size();
+            entry.lastModified = fi.lastModified().toMSecsSinceEpoch();
+            entry.reports = parseFile(fi.absoluteFilePath());
+            changed = true;
+        }
+
+        addToGroups(mFiles.size(), entry);
+        mFiles.append(entry);
+    }
+
+    if (changed || indexed.size() != mFiles.size())
+    {
+        writeIndex();
+    }
+    return true;
+}
+
+QStringList CrashCorpus::versions() const
+{
+    QMultiMap<int, QString> sortedMap;
+    for (auto it = mGroups.constBegin(); it != mGroups.constEnd(); ++it)
+    {
+        sortedMap.insert(crashCount(it.key()), it.key());
+    }
+
+    QStringList sortedVersions = sortedMap.values();
+    std::reverse(sortedVersions.begin(), sortedVersions.end());
+    return sortedVersions;
+}
+
+int CrashCorpus::crashCount(const QString& version) const
+{
+    int count = 0;
+    const auto versionGroups = mGroups.value(version);
+    for (auto it = versionGroups.constBegin(); it != versionGroups.constEnd(); ++it)
+    {
+        count += it->reports.size();
+    }
+    return count;
+}
+
+QVector<CrashCorpus::Group> CrashCorpus::groups(const QString& version) const
+{
+    QVector<Group> result;
+    const auto versionGroups = mGroups.value(version);
+    for (auto it = versionGroups.constBegin(); it != versionGroups.constEnd(); ++it)
+    {
+        result.append(it.value());
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const Group& a, const Group& b)
+    {
+        return a.reports.size() > b.reports.size();
+    });
+    return result;
+}
+
+QString CrashCorpus::reportText(int report) const
+{
+    const Report& info = mReports.at(report);
+    QFile file(reportFile(report));
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(info.offset))
+    {
+        return QString();
+    }
+
+    QString text = QString::fromUtf8(file.read(info.length));
+    text.replace(QString::fromUtf8("\r\n"), QString::fromUtf8("\n"));
+    return text.trimmed();
+}
+
+QString CrashCorpus::reportFile(int report) const
+{
+    return QDir(mFolder).absoluteFilePath(mFiles.at(mReports.at(report).file).name);
+}
+
+const CrashCorpus::Report& CrashCorpus::report(int report) const
+{
+    return mReports.at(report);
+}
+
+QVector<CrashCorpus::ParsedReport> CrashCorpus::parseFile(const QString& path)
+{
+    QVector<ParsedReport> reports;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || !file.size())
+    {
+        return reports;
+    }
+
+    qint64 size = file.size();
+    const char* data = reinterpret_cast<const char*>(file.map(0, size));
+    QByteArray buffer;
+    if (!data)
+    {
+        // Some file systems cannot be mapped
+        buffer = file.readAll();
+        data = buffer.constData();
+        size = buffer.size();
+    }
+
+    // Reports start at each banner and end at the next one
+    const QByteArray content = QByteArray::fromRawData(data, static_cast<int>(size));
+    const int bannerLength = static_cast<int>(strlen(BANNER));
+    int begin = content.indexOf(BANNER);
+    while (begin >= 0)
+    {
+        int end = content.indexOf(BANNER, begin + bannerLength);
+        ParsedReport report;
+        if (parseReport(data, begin + bannerLength, end < 0 ? size : end, report))
+        {
+            reports.append(report);
+        }
+        begin = end;
+    }
+    return reports;
+}
+
+bool CrashCorpus::parseReport(const char* data, qint64 begin, qint64 end, ParsedReport& report)
+{
+    enum { HEADER, ERROR_LINE, FRAMES, COMMENT, DONE } state = HEADER;
+
+    bool hasApplication = false;
+    bool hasFrames = false;
+    qint64 reportEnd = end;
+    CrashSignature signature;
+    QByteArray comment;
+
+    qint64 pos = begin;
+    while (pos < end && state != DONE)
+    {
+        const char* lineStart = data + pos;
+        const char* newLine = static_cast<const char*>(memchr(lineStart, '\n', static_cast<size_t>(end - pos)));
+        qint64 length = newLine ? newLine - lineStart : end - pos;
+        qint64 next = pos + length + 1;
+        if (length && lineStart[length - 1] == '\r')
+        {
+            length--;
+        }
+
+        if (startsWith(lineStart, length, CrashSignature::SEPARATOR))
+        {
+            if (state == COMMENT)
+            {
+                state = DONE;
+            }
+            else
+            {
+                // User comments follow the report between separators
+                reportEnd = pos;
+                state = COMMENT;
+            }
+        }
+        else if (state == COMMENT)
+        {
+            comment.append(lineStart, static_cast<int>(length));
+            comment.append('\n');
+        }
+        else if (state == HEADER)
+        {
+            if (startsWith(lineStart, length, APPLICATION_PREFIX))
+            {
+                hasApplication = true;
+            }
+            else if (startsWith(lineStart, length, VERSION_PREFIX))
+            {
+                report.version = QString::fromUtf8(lineStart, static_cast<int>(length));
+            }
+            else if (startsWith(lineStart, length, CrashSignature::ERROR_INFO_HEADER))
+            {
+                state = ERROR_LINE;
+            }
+            else if (startsWith(lineStart, length, CrashSignature::STACKTRACE_HEADER))
+            {
+                state = FRAMES;
+            }
+        }
+        else if (state == ERROR_LINE)
+        {
+            QByteArray error(lineStart, static_cast<int>(length));
+            signature.addErrorLine(error);
+            report.location = QString::fromUtf8(CrashSignature::normalizeError(error));
+            state = HEADER;
+        }
+        else if (state == FRAMES && length)
+        {
+            QByteArray line(lineStart, static_cast<int>(length));
+            signature.addFrameLine(line);
+            QByteArray frame = CrashSignature::normalizeFrame(line);
+            if (!hasFrames && !frame.isEmpty())
+            {
+                // The first frame identifies the crash location, the error if there are no frames
+                report.location = QString::fromUtf8(frame);
+                hasFrames = true;
+            }
+        }
+        pos = next;
+    }
+
+    if (!hasApplication || report.version.isEmpty())
+    {
+        return false;
+    }
+
+    report.offset = begin - static_cast<qint64>(strlen(BANNER));
+    report.length = reportEnd - report.offset;
+    report.signature = signature.result();
+    report.comment = QString::fromUtf8(comment).trimmed();
+    return true;
+}
+
+bool CrashCorpus::readIndex(QHash<QString, FileEntry>& entries) const
+{
+    QFile file(QDir(mFolder).absoluteFilePath(INDEX_FILE_NAME));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 fileCount = 0;
+    stream >> magic >> version >> fileCount;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION || fileCount < 0)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < fileCount && stream.status() == QDataStream::Ok; i++)
+    {
+        FileEntry entry;
+        qint32 reportCount = 0;
+        stream >> entry.name >> entry.size >> entry.lastModified >> reportCount;
+        for (int j = 0; j < reportCount && stream.status() == QDataStream::Ok; j++)
+        {
+            ParsedReport report;
+            stream >> report.offset >> report.length >> report.version
+                   >> report.signature >> report.location >> report.comment;
+            entry.reports.append(report);
+        }
+        entries.insert(entry.name, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+void CrashCorpus::writeIndex() const
+{
+    QSaveFile file(QDir(mFolder).absoluteFilePath(INDEX_FILE_NAME));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << INDEX_MAGIC << INDEX_VERSION << static_cast<qint32>(mFiles.size());
+    for (const FileEntry& entry : mFiles)
+    {
+        stream << entry.name << entry.size << entry.lastModified << static_cast<qint32>(entry.reports.size());
+        for (const ParsedReport& report : entry.reports)
+        {
+            stream << report.offset << report.length << report.version
+                   << report.signature << report.location << report.comment;
+        }
+    }
+    file.commit();
+}
+
+void CrashCorpus::addToGroups(int fileIndex, const FileEntry& entry)
+{
+    for (const ParsedReport& parsed : entry.reports)
+    {
+        Report report;
+        report.file = fileIndex;
+        report.offset = parsed.offset;
+        report.length = parsed.length;
+        report.comment = parsed.comment;
+
+        Group& group = mGroups[parsed.version][parsed.signature];
+        if (group.reports.isEmpty())
+        {
+            group.signature = QString::fromLatin1(parsed.signature.toHex());
+            group.location = parsed.location;
+        }
+        group.reports.append(mReports.size());
+        mReports.append(report);
+    }
+}
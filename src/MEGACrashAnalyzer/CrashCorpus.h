@@ -0,0 +1,79 @@
+#ifndef CRASHCORPUS_H
+#define CRASHCORPUS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Crash reports of a folder, grouped by version and by their CrashSignature, which is the
+// "Hash:" the app writes in the reports it sends.
+// Files are memory mapped and scanned without splitting them into lines, and only the position of
+// each report is kept in memory. The parsed records are saved to an index file in the folder, so
+// reopening it only parses the files that were added or changed since.
+class CrashCorpus
+{
+public:
+    struct Report
+    {
+        int file = 0;
+        qint64 offset = 0;
+        qint64 length = 0;
+        QString comment;
+    };
+
+    struct Group
+    {
+        QString signature;
+        // First frame without absolute addresses, shown to identify the group
+        QString location;
+        QVector<int> reports;
+    };
+
+    static const QString INDEX_FILE_NAME;
+
+    bool load(const QString& folder);
+
+    QStringList versions() const;           // Sorted by number of crashes, descending
+    int crashCount(const QString& version) const;
+    QVector<Group> groups(const QString& version) const;    // Sorted by size, descending
+
+    QString reportText(int report) const;
+    QString reportFile(int report) const;
+    const Report& report(int report) const;
+
+private:
+    struct ParsedReport
+    {
+        qint64 offset = 0;
+        qint64 length = 0;
+        QString version;
+        QByteArray signature;
+        QString location;
+        QString comment;
+    };
+
+    struct FileEntry
+    {
+        QString name;
+        qint64 size = 0;
+        qint64 lastModified = 0;
+        QVector<ParsedReport> reports;
+    };
+
+    static QVector<ParsedReport> parseFile(const QString& path);
+    static bool parseReport(const char* data, qint64 begin, qint64 end, ParsedReport& report);
+
+    bool readIndex(QHash<QString, FileEntry>& entries) const;
+    void writeIndex() const;
+    void addToGroups(int fileIndex, const FileEntry& entry);
+
+    QString mFolder;
+    QVector<FileEntry> mFiles;
+    QVector<Report> mReports;
+    // version -> signature -> group
+    QHash<QString, QHash<QByteArray, Group>> mGroups;
+};
+
+#endif // CRASHCORPUS_H
@@ -1,8 +1,64 @@
 #include "MainWindow.h"
+#include "CrashCorpus.h"
+
 #include <QApplication>
+#include <QTextStream>
+
+#include <cstring>
+
+namespace
+{
+// Headless triage: MEGACrashAnalyzer --cli <folder> [--top <groups per version>]
+int runCli(const QStringList& args)
+{
+    QTextStream out(stdout);
+    int folderIndex = args.indexOf(QString::fromUtf8("--cli")) + 1;
+    if (folderIndex >= args.size())
+    {
+        out << "Usage: MEGACrashAnalyzer --cli <folder> [--top <groups>]" << endl;
+        return 1;
+    }
+
+    int top = 10;
+    int topIndex = args.indexOf(QString::fromUtf8("--top"));
+    if (topIndex >= 0 && topIndex + 1 < args.size())
+    {
+        top = args.at(topIndex + 1).toInt();
+    }
+
+    CrashCorpus corpus;
+    if (!corpus.load(args.at(folderIndex)))
+    {
+        out << "Unable to open " << args.at(folderIndex) << endl;
+        return 1;
+    }
+
+    for (const QString& version : corpus.versions())
+    {
+        out << version << ": " << corpus.crashCount(version) << " crashes" << endl;
+        QVector<CrashCorpus::Group> groups = corpus.groups(version);
+        for (int i = 0; i < groups.size() && (top <= 0 || i < top); i++)
+        {
+            const CrashCorpus::Group& group = groups.at(i);
+            out << "    " << group.reports.size() << "\t" << group.signature << "\t" << group.location << endl;
+            out << "        " << corpus.reportFile(group.reports.first()) << endl;
+        }
+    }
+    return 0;
+}
+}
 
 int main(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--cli"))
+        {
+            QCoreApplication app(argc, argv);
+            return runCli(app.arguments());
+        }
+    }
+
     QApplication app(argc, argv);
     MainWindow mainWindow;
     mainWindow.show();
@@ -14,10 +14,16 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 TARGET = MEGACrashAnalyzer
 TEMPLATE = app
 
+INCLUDEPATH += ../MEGASync/control
+
 HEADERS += \
+    ../MEGASync/control/CrashSignature.h \
+    CrashCorpus.h \
     MainWindow.h
 
 SOURCES += \
+    ../MEGASync/control/CrashSignature.cpp \
+    CrashCorpus.cpp \
     MEGACrashAnalyzer.cpp \
     MainWindow.cpp
 
@@ -6,7 +6,6 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QDebug>
-#include <QMultiMap>
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
@@ -46,134 +45,13 @@ void MainWindow::on_bSourceFolder_clicked()
 
 void MainWindow::parseCrashes(QString folder)
 {
-    QDir dir(folder);
-    QFileInfoList fiList = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::Time);
-    for (int i = 0; i < fiList.size(); i++)
-    {
-        QFile file(fiList[i].absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly))
-        {
-            continue;
-        }
-
-        QString fileContents = QString::fromUtf8(file.readAll());
-        fileContents.replace(QString::fromUtf8("\r\n"), QString::fromUtf8("\n"));
-        QStringList crashReports = fileContents.split(QString::fromUtf8("MEGAprivate ERROR DUMP"), QString::SkipEmptyParts);
-        if ((crashReports.size() - 2) >= 0
-                && crashReports[crashReports.size() - 2].split(QString::fromUtf8("\n")).size() < 3)
-        {
-            crashReports.removeLast();
-        }
-
-        for (int j = 0; j < crashReports.size() - 1; j++)
-        {
-            QString crashReport = crashReports[j];
-            file.close();
-
-            QStringList lines = crashReport.split(QString::fromUtf8("\n"));
-            while (lines.size() && !lines.at(0).startsWith(QString::fromUtf8("Application: ")))
-            {
-                lines.removeAt(0);
-            }
-
-            if ((lines.size() < 5)
-                    || (!lines.at(0).startsWith(QString::fromUtf8("Application: ")))
-                    || (!lines.at(1).startsWith(QString::fromUtf8("Version"))))
-            {
-                continue;
-            }
-
-            int locationIndex = 0;
-            if (lines.at(3).startsWith(QString::fromUtf8("Operating")))
-            {
-                locationIndex = 5;
-            }
-            if (lines.at(4).startsWith(QString::fromUtf8("System")))
-            {
-                locationIndex = 8;
-            }
-
-            if (!locationIndex || lines.size() <= locationIndex)
-            {
-                continue;
-            }
-
-            QHash<QString, QStringList> &version = reports[lines.at(1)];
-            if (!reports.contains(lines.at(1)))
-            {
-                reports.insert(lines.at(1), QHash<QString, QStringList>());
-            }
-
-            if (!version.contains(lines.at(locationIndex)))
-            {
-                version.insert(lines.at(locationIndex), QStringList());
-            }
-
-            QStringList &fullReports = version[lines.at(locationIndex)];
-            for (int i = locationIndex; i < lines.size(); i++)
-            {
-                if (lines.at(i).contains("------------------------------"))
-                {
-                    int init = i;
-                    int j = i + 1;
-                    while (j < lines.size() && !lines.at(j).contains("------------------------------"))
-                    {
-                        j++;
-                    }
-
-                    QString comment;
-                    if (j != lines.size())
-                    {
-                        i++;
-                        while (i < j)
-                        {
-                            comment.append(lines.at(i));
-                            i++;
-                        }
-                        comment = comment.trimmed();
-                    }
+    corpus.load(folder);
 
-                    while (lines.size() > init)
-                    {
-                        lines.removeAt(lines.size() - 1);
-                    }
-
-                    if (comment.size() > 3)
-                    {
-                        comment.append(QString::fromUtf8("\n\nCrash report:\n"));
-                        comment.append(lines.join("\n"));
-                        //QMegaMessageBox::warning(this, tr("Crash analyzer"), comment);
-                        qDebug() << QString::fromUtf8("User comment: %1\n\n").arg(comment);
-                    }
-
-                    break;
-                }
-            }
-
-            crashReport = lines.join(QString::fromUtf8("\n"));
-            fullReports.append(crashReport);
-        }
-    }
-
-    QStringList versions = reports.keys();
+    QStringList versions = corpus.versions();
     ui->cVersion->clear();
     if (versions.size())
     {
-        QMultiMap<int, QString> sortedMap;
-        for (int i=0; i < versions.size(); i++)
-        {
-            QHash<QString, QStringList> &hVersion = reports[versions.at(i)];
-            QStringList crashLocations = hVersion.keys();
-            int acum = 0;
-            for (int j = 0; j < crashLocations.size(); j++)
-            {
-                acum += hVersion.value(crashLocations[j]).size();
-            }
-            sortedMap.insert(acum, versions.at(i));
-        }
-        QStringList sortedVersions = sortedMap.values();
-        std::reverse(sortedVersions.begin(), sortedVersions.end());
-        ui->cVersion->addItems(sortedVersions);
+        ui->cVersion->addItems(versions);
         ui->cVersion->setCurrentIndex(0);
     }
     else
@@ -184,27 +62,17 @@ void MainWindow::parseCrashes(QString folder)
 
 void MainWindow::on_cVersion_currentIndexChanged(const QString &version)
 {
-    QHash<QString, QStringList> &hVersion = reports[version];
-    QStringList crashLocations = hVersion.keys();
+    currentGroups = corpus.groups(version);
     ui->cLocation->clear();
-    if (crashLocations.size())
+    if (currentGroups.size())
     {
-        QMultiMap<int, QString> sortedMap;
-        for (int i=0; i< crashLocations.size(); i++)
+        for (int i = 0; i < currentGroups.size(); i++)
         {
-            sortedMap.insert(hVersion.value(crashLocations.at(i)).size(), crashLocations.at(i));
+            const CrashCorpus::Group& group = currentGroups.at(i);
+            ui->cLocation->addItem(QString::fromUtf8("[%1] %2").arg(group.reports.size()).arg(group.location));
         }
-        QStringList sortedLocations = sortedMap.values();
-        std::reverse(sortedLocations.begin(), sortedLocations.end());
-        ui->cLocation->addItems(sortedLocations);
         ui->cLocation->setCurrentIndex(0);
-
-        int acum = 0;
-        for (int i = 0; i < crashLocations.size(); i++)
-        {
-            acum += hVersion.value(crashLocations[i]).size();
-        }
-        ui->eVersion->setText(QString::number(acum));
+        ui->eVersion->setText(QString::number(corpus.crashCount(version)));
     }
     else
     {
@@ -213,17 +81,16 @@ void MainWindow::on_cVersion_currentIndexChanged(const QString &version)
     }
 }
 
-void MainWindow::on_cLocation_currentIndexChanged(const QString &location)
+void MainWindow::on_cLocation_currentIndexChanged(int index)
 {
-    QHash<QString, QStringList> &hVersion = reports[ui->cVersion->currentText()];
-    QStringList fullReports = hVersion.value(location);
-    ui->eLocation->setText(QString::number(fullReports.size()));
-    if (fullReports.size())
+    int count = (index >= 0 && index < currentGroups.size()) ? currentGroups.at(index).reports.size() : 0;
+    ui->eLocation->setText(QString::number(count));
+    if (count)
     {
         ui->sReports->setMinimum(1);
-        ui->sReports->setMaximum(fullReports.size());
+        ui->sReports->setMaximum(count);
         ui->sReports->setValue(1);
-        ui->eReport->setText(fullReports[0]);
+        showReport(currentGroups.at(index).reports.at(0));
     }
     else
     {
@@ -236,14 +103,25 @@ void MainWindow::on_cLocation_currentIndexChanged(const QString &location)
 
 void MainWindow::on_sReports_valueChanged(int selected)
 {
-    if (selected > 0)
+    int index = ui->cLocation->currentIndex();
+    if (selected > 0 && index >= 0 && index < currentGroups.size()
+            && selected <= currentGroups.at(index).reports.size())
     {
-        QHash<QString, QStringList> &hVersion = reports[ui->cVersion->currentText()];
-        QStringList fullReports = hVersion.value(ui->cLocation->currentText());
-        ui->eReport->setText(fullReports[selected-1]);
+        showReport(currentGroups.at(index).reports.at(selected - 1));
     }
     else
     {
         ui->eReport->clear();
     }
 }
+
+void MainWindow::showReport(int report)
+{
+    QString text = corpus.reportText(report);
+    const QString& comment = corpus.report(report).comment;
+    if (comment.size() > 3)
+    {
+        text.append(QString::fromUtf8("\n\nUser comment:\n%1").arg(comment));
+    }
+    ui->eReport->setText(text);
+}
@@ -1,8 +1,9 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "CrashCorpus.h"
+
 #include <QMainWindow>
-#include <QHash>
 #include <QString>
 
 namespace Ui {
@@ -20,13 +21,15 @@ public:
 private slots:
     void on_bSourceFolder_clicked();
     void on_cVersion_currentIndexChanged(const QString &version);
-    void on_cLocation_currentIndexChanged(const QString &location);
+    void on_cLocation_currentIndexChanged(int index);
     void on_sReports_valueChanged(int selected);
 
 private:
     Ui::MainWindow *ui;
-    QHash<QString, QHash<QString, QStringList> > reports;
+    CrashCorpus corpus;
+    QVector<CrashCorpus::Group> currentGroups;
     void parseCrashes(QString folder);
+    void showReport(int report);
 };
 
 #endif // MAINWINDOW_H
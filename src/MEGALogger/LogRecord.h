@@ -0,0 +1,96 @@
+#ifndef LOGRECORD_H
+#define LOGRECORD_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtEndian>
+
+// Log line as sent by MEGAsync (MegaSyncLogger) through the MEGA_LOGGER socket.
+// Every record is little endian:
+//   quint32 size of the rest of the record
+//   qint64  microseconds since epoch
+//   quint8  log level (MegaApi::LOG_LEVEL_*)
+//   quint64 thread id
+//   message, UTF-8, up to the end of the record
+struct LogRecord
+{
+    qint64 time = 0;
+    int level = 0;
+    quint64 threadId = 0;
+    QByteArray message;
+};
+
+namespace LogRecordStream
+{
+constexpr int SIZE_BYTES = 4;
+constexpr int HEADER_BYTES = 8 + 1 + 8;
+// Larger records can only come from a corrupted stream
+constexpr quint32 MAX_RECORD_BYTES = 1024 * 1024;
+
+// Appends the complete records at the beginning of buffer to records and removes them from it.
+// Returns false if the stream is corrupted
+inline bool takeRecords(QByteArray& buffer, QVector<LogRecord>& records)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(buffer.constData());
+    int offset = 0;
+    bool valid = true;
+    while (buffer.size() - offset >= SIZE_BYTES)
+    {
+        const quint32 size = qFromLittleEndian<quint32>(data + offset);
+        if (size < HEADER_BYTES || size > MAX_RECORD_BYTES)
+        {
+            valid = false;
+            break;
+        }
+        if (static_cast<quint32>(buffer.size() - offset - SIZE_BYTES) < size)
+        {
+            break;
+        }
+
+        const uchar* record = data + offset + SIZE_BYTES;
+        LogRecord logRecord;
+        logRecord.time = qFromLittleEndian<qint64>(record);
+        logRecord.level = record[8];
+        logRecord.threadId = qFromLittleEndian<quint64>(record + 9);
+        logRecord.message = QByteArray(reinterpret_cast<const char*>(record + HEADER_BYTES),
+                                       static_cast<int>(size) - HEADER_BYTES);
+        records.append(logRecord);
+        offset += SIZE_BYTES + static_cast<int>(size);
+    }
+
+    buffer.remove(0, valid ? offset : buffer.size());
+    return valid;
+}
+
+// Number of complete records in buffer
+inline int countRecords(const QByteArray& buffer)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(buffer.constData());
+    int offset = 0;
+    int count = 0;
+    while (buffer.size() - offset >= SIZE_BYTES)
+    {
+        const quint32 size = qFromLittleEndian<quint32>(data + offset);
+        if (size > static_cast<quint32>(buffer.size() - offset - SIZE_BYTES))
+        {
+            break;
+        }
+        offset += SIZE_BYTES + static_cast<int>(size);
+        count++;
+    }
+    return count;
+}
+
+inline void appendRecord(QByteArray& buffer, const LogRecord& record)
+{
+    uchar header[SIZE_BYTES + HEADER_BYTES];
+    qToLittleEndian<quint32>(static_cast<quint32>(HEADER_BYTES + record.message.size()), header);
+    qToLittleEndian<qint64>(record.time, header + SIZE_BYTES);
+    header[SIZE_BYTES + 8] = static_cast<uchar>(record.level);
+    qToLittleEndian<quint64>(record.threadId, header + SIZE_BYTES + 9);
+    buffer.append(reinterpret_cast<const char*>(header), sizeof(header));
+    buffer.append(record.message);
+}
+}
+
+#endif // LOGRECORD_H
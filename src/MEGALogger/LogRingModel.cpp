@@ -0,0 +1,258 @@
+#include "LogRingModel.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Records checked against a new filter before letting the event loop run
+constexpr quint64 FILTER_SLICE = 20000;
+constexpr int MAX_LOG_LEVEL = 5;
+}
+
+LogRingModel::LogRingModel(int capacity, QObject *parent)
+    : QAbstractTableModel(parent),
+      mCapacity(capacity),
+      mRing(capacity),
+      mFirst(0),
+      mNext(0),
+      mFilterColumn(-1),
+      mMaxLevel(MAX_LOG_LEVEL),
+      mFilterCursor(0)
+{
+    mFilterTimer.setInterval(0);
+    connect(&mFilterTimer, &QTimer::timeout, this, &LogRingModel::filterNextSlice);
+}
+
+int LogRingModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(mVisible.size());
+}
+
+int LogRingModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant LogRingModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid()
+            || index.row() >= static_cast<int>(mVisible.size()))
+    {
+        return QVariant();
+    }
+    return columnText(record(mVisible[index.row()]), index.column());
+}
+
+QVariant LogRingModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    {
+        return QVariant();
+    }
+
+    switch (section)
+    {
+        case TIMESTAMP_COLUMN:
+            return QString::fromUtf8("Timestamp");
+        case LEVEL_COLUMN:
+            return QString::fromUtf8("Message Type");
+        case THREAD_COLUMN:
+            return QString::fromUtf8("Thread");
+        case MESSAGE_COLUMN:
+            return QString::fromUtf8("Message");
+    }
+    return QVariant();
+}
+
+void LogRingModel::append(const QVector<LogRecord> &records)
+{
+    // Records that would be dropped right away are skipped
+    const int skipped = std::max(0, records.size() - mCapacity);
+    if (records.size() == skipped)
+    {
+        return;
+    }
+
+    const quint64 next = mNext + static_cast<quint64>(records.size());
+    const quint64 first = std::max(mFirst, next - std::min(next, static_cast<quint64>(mCapacity)));
+
+    auto evictedEnd = std::lower_bound(mVisible.begin(), mVisible.end(), first);
+    if (evictedEnd != mVisible.begin())
+    {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(evictedEnd - mVisible.begin()) - 1);
+        mVisible.erase(mVisible.begin(), evictedEnd);
+        endRemoveRows();
+    }
+
+    // New records are checked here unless a filter scan still has to reach them
+    const bool filtering = isFiltering();
+    mFirst = first;
+    mFilterCursor = std::max(mFilterCursor, first);
+
+    std::vector<quint64> shown;
+    quint64 sequence = mNext + static_cast<quint64>(skipped);
+    for (int i = skipped; i < records.size(); ++i, ++sequence)
+    {
+        mRing[static_cast<int>(sequence % mCapacity)] = records[i];
+        if (!filtering && matches(records[i]))
+        {
+            shown.push_back(sequence);
+        }
+    }
+    mNext = next;
+    if (!filtering)
+    {
+        mFilterCursor = mNext;
+    }
+
+    if (!shown.empty())
+    {
+        const int row = static_cast<int>(mVisible.size());
+        beginInsertRows(QModelIndex(), row, row + static_cast<int>(shown.size()) - 1);
+        mVisible.insert(mVisible.end(), shown.begin(), shown.end());
+        endInsertRows();
+    }
+}
+
+void LogRingModel::clear()
+{
+    beginResetModel();
+    mRing = QVector<LogRecord>(mCapacity);
+    mFirst = mNext;
+    mFilterCursor = mNext;
+    mVisible.clear();
+    mFilterTimer.stop();
+    endResetModel();
+}
+
+QVector<LogRecord> LogRingModel::records() const
+{
+    QVector<LogRecord> result;
+    result.reserve(static_cast<int>(mNext - mFirst));
+    for (quint64 sequence = mFirst; sequence < mNext; ++sequence)
+    {
+        result.append(record(sequence));
+    }
+    return result;
+}
+
+void LogRingModel::setFilter(const QRegExp &pattern, int column, int maxLevel)
+{
+    beginResetModel();
+    mPattern = pattern;
+    mFilterColumn = column;
+    mMaxLevel = maxLevel;
+    mVisible.clear();
+    mFilterCursor = mFirst;
+    endResetModel();
+
+    filterNextSlice();
+}
+
+bool LogRingModel::isFiltering() const
+{
+    return mFilterCursor != mNext;
+}
+
+QString LogRingModel::levelName(int level)
+{
+    switch (level)
+    {
+        case 0:
+            return QString::fromUtf8("CRIT");
+        case 1:
+            return QString::fromUtf8("ERR");
+        case 2:
+            return QString::fromUtf8("WARN");
+        case 3:
+            return QString::fromUtf8("INFO");
+        case 4:
+            return QString::fromUtf8("DBG");
+        case 5:
+            return QString::fromUtf8("DTL");
+    }
+    return QString::number(level);
+}
+
+void LogRingModel::filterNextSlice()
+{
+    const quint64 end = std::min(mNext, mFilterCursor + FILTER_SLICE);
+    std::vector<quint64> shown;
+    for (; mFilterCursor < end; ++mFilterCursor)
+    {
+        if (matches(record(mFilterCursor)))
+        {
+            shown.push_back(mFilterCursor);
+        }
+    }
+
+    if (!shown.empty())
+    {
+        const int row = static_cast<int>(mVisible.size());
+        beginInsertRows(QModelIndex(), row, row + static_cast<int>(shown.size()) - 1);
+        mVisible.insert(mVisible.end(), shown.begin(), shown.end());
+        endInsertRows();
+    }
+
+    if (!isFiltering())
+    {
+        mFilterTimer.stop();
+    }
+    else if (!mFilterTimer.isActive())
+    {
+        mFilterTimer.start();
+    }
+}
+
+const LogRecord &LogRingModel::record(quint64 sequence) const
+{
+    return mRing[static_cast<int>(sequence % mCapacity)];
+}
+
+QString LogRingModel::columnText(const LogRecord &record, int column) const
+{
+    switch (column)
+    {
+        case TIMESTAMP_COLUMN:
+        {
+            const QDateTime time = QDateTime::fromMSecsSinceEpoch(record.time / 1000, Qt::UTC);
+            return time.toString(QString::fromUtf8("MM/dd-hh:mm:ss."))
+                    + QString::number(record.time % 1000000).rightJustified(6, QLatin1Char('0'));
+        }
+        case LEVEL_COLUMN:
+            return levelName(record.level);
+        case THREAD_COLUMN:
+            return QString::number(record.threadId, 16);
+        case MESSAGE_COLUMN:
+            return QString::fromUtf8(record.message);
+    }
+    return QString();
+}
+
+bool LogRingModel::matches(const LogRecord &record) const
+{
+    if (record.level > mMaxLevel)
+    {
+        return false;
+    }
+    if (mPattern.isEmpty())
+    {
+        return true;
+    }
+
+    if (mFilterColumn >= 0)
+    {
+        return mPattern.indexIn(columnText(record, mFilterColumn)) != -1;
+    }
+    for (int column = 0; column < COLUMN_COUNT; ++column)
+    {
+        if (mPattern.indexIn(columnText(record, column)) != -1)
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,75 @@
+#ifndef LOGRINGMODEL_H
+#define LOGRINGMODEL_H
+
+#include "LogRecord.h"
+
+#include <QAbstractTableModel>
+#include <QRegExp>
+#include <QTimer>
+#include <QVector>
+
+#include <deque>
+
+// Keeps the last records received in a fixed-capacity ring; the oldest ones are dropped as new
+// ones arrive. Rows are only formatted when the view asks for them.
+// The model filters by itself: it keeps the sequence numbers of the records that match the
+// current filter, and when the filter changes the ring is scanned again in slices, so the
+// window keeps responding while the rows show up.
+class LogRingModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        TIMESTAMP_COLUMN = 0,
+        LEVEL_COLUMN,
+        THREAD_COLUMN,
+        MESSAGE_COLUMN,
+        COLUMN_COUNT
+    };
+
+    explicit LogRingModel(int capacity, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void append(const QVector<LogRecord> &records);
+    void clear();
+
+    // Records from the oldest to the newest, whether they match the filter or not
+    QVector<LogRecord> records() const;
+
+    // An empty pattern matches everything; column is a Column or -1 for all of them
+    void setFilter(const QRegExp &pattern, int column, int maxLevel);
+    bool isFiltering() const;
+
+    static QString levelName(int level);
+
+private slots:
+    void filterNextSlice();
+
+private:
+    const LogRecord &record(quint64 sequence) const;
+    QString columnText(const LogRecord &record, int column) const;
+    bool matches(const LogRecord &record) const;
+
+    const int mCapacity;
+    QVector<LogRecord> mRing;
+    // Sequence numbers of the oldest record and of the next one to arrive
+    quint64 mFirst;
+    quint64 mNext;
+    // Sequence numbers of the records shown, in order
+    std::deque<quint64> mVisible;
+
+    QRegExp mPattern;
+    int mFilterColumn;
+    int mMaxLevel;
+    // Next record to check against a new filter, mNext when done
+    quint64 mFilterCursor;
+    QTimer mFilterTimer;
+};
+
+#endif // LOGRINGMODEL_H
@@ -13,10 +13,13 @@ TEMPLATE = app
 
 
 SOURCES += main.cpp \
-    MegaDebugServer.cpp
+    MegaDebugServer.cpp \
+    LogRingModel.cpp
 
 HEADERS  += \
-    MegaDebugServer.h
+    MegaDebugServer.h \
+    LogRecord.h \
+    LogRingModel.h
 
 FORMS    += \
     MegaDebugServer.ui
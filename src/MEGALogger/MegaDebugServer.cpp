@@ -1,10 +1,14 @@
 #include "MegaDebugServer.h"
 #include "ui_MegaDebugServer.h"
+#include <QDateTime>
+#include <QScrollBar>
 #include <iostream>
 
 #define MEGA_LOGGER "MEGA_LOGGER"
 #define ENABLE_MEGASYNC_LOGS "MEGA_ENABLE_LOGS"
-#define MAX_LOG_MESSAGES 16384
+#define MAX_LOG_MESSAGES 100000
+// Saved logs start with it once uncompressed, older ones are XML
+#define LOG_FILE_MAGIC "MEGALOG1"
 
 using namespace std;
 
@@ -19,21 +23,30 @@ MegaDebugServer::MegaDebugServer(QWidget *parent) :
     megaSyncClient = NULL;
     megaServer = NULL;
     debugDataModel = NULL;
-    debugProxyModel = NULL;
-    reader = NULL;
 
     ui->filterTypeComboBox->addItem("Regular Expression", QRegExp::RegExp);
     ui->filterTypeComboBox->addItem("Wildcard", QRegExp::Wildcard);
     ui->filterTypeComboBox->addItem("Fixed string", QRegExp::FixedString);
 
-    ui->columnComboBox->addItem("Timestamp");
-    ui->columnComboBox->addItem("Message Type");
-    ui->columnComboBox->addItem("Message");
+    ui->columnComboBox->addItem("Timestamp", LogRingModel::TIMESTAMP_COLUMN);
+    ui->columnComboBox->addItem("Message Type", LogRingModel::LEVEL_COLUMN);
+    ui->columnComboBox->addItem("Thread", LogRingModel::THREAD_COLUMN);
+    ui->columnComboBox->addItem("Message", LogRingModel::MESSAGE_COLUMN);
+    ui->columnComboBox->addItem("All", -1);
+    ui->columnComboBox->setCurrentIndex(ui->columnComboBox->findData(LogRingModel::MESSAGE_COLUMN));
 
-    connect(ui->filterPatternLineEdit, SIGNAL(textChanged(QString)), this, SLOT(filterTextRegExp()));
-    connect(ui->filterTypeComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(filterTextRegExp()));
-    connect(ui->columnComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(filterColumn()));
-    connect(ui->caseSensitivecheckBox, SIGNAL(toggled(bool)), this, SLOT(filterCaseSensitive()));
+    // Levels up to the selected one are shown
+    for (int level = 0; level <= 5; level++)
+    {
+        ui->levelComboBox->addItem(LogRingModel::levelName(level), level);
+    }
+    ui->levelComboBox->setCurrentIndex(ui->levelComboBox->count() - 1);
+
+    connect(ui->filterPatternLineEdit, SIGNAL(textChanged(QString)), this, SLOT(updateFilter()));
+    connect(ui->filterTypeComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(updateFilter()));
+    connect(ui->columnComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(updateFilter()));
+    connect(ui->levelComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(updateFilter()));
+    connect(ui->caseSensitivecheckBox, SIGNAL(toggled(bool)), this, SLOT(updateFilter()));
     connect(&timer, SIGNAL(timeout()), this, SLOT(tryConnect()));
 
     connect(ui->actionSave, SIGNAL(triggered()), this, SLOT(saveToFile()));
@@ -41,19 +54,15 @@ MegaDebugServer::MegaDebugServer(QWidget *parent) :
     connect(ui->actionClear, SIGNAL(triggered()), this, SLOT(clearDebugWindow()));
     connect(ui->actionStop, SIGNAL(triggered()), this, SLOT(startstop()));
 
-    debugDataModel = new QStandardItemModel(0, 3, this);
-    debugDataModel->setHeaderData(0, Qt::Horizontal,QString::fromUtf8("Timestamp"), Qt::DisplayRole);
-    debugDataModel->setHeaderData(1, Qt::Horizontal,QString::fromUtf8("Message Type"), Qt::DisplayRole);
-    debugDataModel->setHeaderData(2, Qt::Horizontal,QString::fromUtf8("Message"), Qt::DisplayRole);
-
-    debugProxyModel = new QSortFilterProxyModel;
-    debugProxyModel->setSourceModel(debugDataModel);
-    ui->messagesTreeView->setModel(debugProxyModel);
+    debugDataModel = new LogRingModel(MAX_LOG_MESSAGES, this);
+    ui->messagesTreeView->setModel(debugDataModel);
+    ui->messagesTreeView->setRootIsDecorated(false);
+    ui->messagesTreeView->setUniformRowHeights(true);
 
-    ui->messagesTreeView->sortByColumn(1, Qt::AscendingOrder);
-    ui->messagesTreeView->resizeColumnToContents(0);
-    ui->messagesTreeView->resizeColumnToContents(1);
-    ui->messagesTreeView->resizeColumnToContents(2);
+    ui->messagesTreeView->resizeColumnToContents(LogRingModel::TIMESTAMP_COLUMN);
+    ui->messagesTreeView->resizeColumnToContents(LogRingModel::LEVEL_COLUMN);
+    ui->messagesTreeView->resizeColumnToContents(LogRingModel::THREAD_COLUMN);
+    ui->messagesTreeView->resizeColumnToContents(LogRingModel::MESSAGE_COLUMN);
 
     setWindowTitle(tr("MEGAsync Debug Window"));
     startstop();
@@ -78,58 +87,68 @@ void MegaDebugServer::clientConnected()
         megaSyncClient->disconnectFromServer();
         megaSyncClient->deleteLater();
     }
-    reader = new QXmlStreamReader(megaSyncClient);
+    pendingData.clear();
 
     connect(megaSyncClient, SIGNAL(readyRead()), this, SLOT(readDebugMsg()));
     connect(megaSyncClient, SIGNAL(disconnected()), this, SLOT(disconnected()));
     connect(megaSyncClient, SIGNAL(error(QLocalSocket::LocalSocketError)), SLOT(disconnected()));
 }
 
+// Logs saved before the binary format
 void MegaDebugServer::parseReader(QXmlStreamReader *reader)
 {    
+    QVector<LogRecord> records;
     do
     {
         QXmlStreamReader::TokenType token = reader->readNext();
         if (token == QXmlStreamReader::StartElement && reader->name() == "log")
         {
             QXmlStreamAttributes attr = reader->attributes();
-            DebugRow dr;
-            dr.timeStamp = attr.value(QString::fromUtf8("timestamp")).toString();
-            dr.messageType = attr.value(QString::fromUtf8("type")).toString();
-            dr.content = attr.value(QString::fromUtf8("content")).toString();
-            appendDebugRow(&dr);
+            LogRecord record;
+            QTime time = QTime::fromString(attr.value(QString::fromUtf8("timestamp")).toString(),
+                                           QString::fromUtf8("hh:mm:ss"));
+            if (time.isValid())
+            {
+                record.time = QDateTime(QDate::currentDate(), time, Qt::UTC).toMSecsSinceEpoch() * 1000;
+            }
+            record.level = attr.value(QString::fromUtf8("type")).toString().toInt();
+            record.message = attr.value(QString::fromUtf8("content")).toString().toUtf8();
+            records.append(record);
         }
     } while (!reader->error());
+    appendRecords(records);
 }
 
 void MegaDebugServer::readDebugMsg()
 {
-    parseReader(reader);
-}
-
-void MegaDebugServer::appendDebugRow(DebugRow *dr)
-{
-    int index = debugDataModel->rowCount();
+    if (!megaSyncClient)
+    {
+        return;
+    }
 
-    if (index >= MAX_LOG_MESSAGES)
+    pendingData.append(megaSyncClient->readAll());
+    QVector<LogRecord> records;
+    bool valid = LogRecordStream::takeRecords(pendingData, records);
+    appendRecords(records);
+    if (!valid)
     {
-        QList<QStandardItem*> items = debugDataModel->takeRow(0);
-        for (int i = 0; i < items.size(); i++)
-        {
-            delete items[i];
-        }
-        index--;
+        disconnected();
+        ui->statusBar->showMessage(tr("Invalid data received"));
     }
+}
 
-    QStandardItem *ts = new QStandardItem(dr->timeStamp);
-    QStandardItem *mt = new QStandardItem(dr->messageType);
-    QStandardItem *c = new QStandardItem(dr->content);
+void MegaDebugServer::appendRecords(const QVector<LogRecord> &records)
+{
+    // Follow the new messages only if they were being followed
+    QScrollBar *scrollBar = ui->messagesTreeView->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
 
-    debugDataModel->setItem(index, 0, ts);
-    debugDataModel->setItem(index, 1, mt);
-    debugDataModel->setItem(index, 2, c);
+    debugDataModel->append(records);
 
-    ui->messagesTreeView->scrollToBottom();
+    if (atBottom)
+    {
+        ui->messagesTreeView->scrollToBottom();
+    }
 }
 
 void MegaDebugServer::startstop()
@@ -167,11 +186,10 @@ void MegaDebugServer::disconnected()
 {
     if (megaServer)
     {
-        delete reader;
         megaServer->deleteLater();
-        reader = NULL;
         megaServer = NULL;
         megaSyncClient = NULL;
+        pendingData.clear();
         ui->actionSave->setEnabled(true);
         ui->actionLoad->setEnabled(true);
         ui->statusBar->showMessage(tr("Disconnected"));
@@ -185,24 +203,14 @@ void MegaDebugServer::tryConnect()
     client.connectToServer(ENABLE_MEGASYNC_LOGS);
 }
 
-void MegaDebugServer::filterTextRegExp()
+void MegaDebugServer::updateFilter()
 {
-    qDebug() << ui->filterTypeComboBox->itemData(ui->filterTypeComboBox->currentIndex()).toInt();
     QRegExp::PatternSyntax syntax = QRegExp::PatternSyntax(ui->filterTypeComboBox->itemData(ui->filterTypeComboBox->currentIndex()).toInt());
     Qt::CaseSensitivity caseSensitivity = ui->caseSensitivecheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
     QRegExp regExp(ui->filterPatternLineEdit->text(), caseSensitivity, syntax);
-    qDebug() << regExp;
-    debugProxyModel->setFilterRegExp(regExp);
-}
-
-void MegaDebugServer::filterColumn()
-{
-    debugProxyModel->setFilterKeyColumn(ui->columnComboBox->currentIndex());
-}
-
-void MegaDebugServer::filterCaseSensitive()
-{
-    debugProxyModel->setSortCaseSensitivity(ui->caseSensitivecheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    int column = ui->columnComboBox->itemData(ui->columnComboBox->currentIndex()).toInt();
+    int maxLevel = ui->levelComboBox->itemData(ui->levelComboBox->currentIndex()).toInt();
+    debugDataModel->setFilter(regExp, column, maxLevel);
 }
 
 void MegaDebugServer::saveToFile()
@@ -223,30 +231,16 @@ void MegaDebugServer::saveToFile()
         return;
     }
 
-    QByteArray ba;
-    QXmlStreamWriter xmlWriterLog(&ba);
+    QByteArray ba(LOG_FILE_MAGIC);
     QDataStream out(&file);
     out.setVersion(QDataStream::Qt_4_8);
-    qint32 n(debugDataModel->rowCount());
 
-    /* Writes a document start with the XML version number. */
-    xmlWriterLog.writeStartDocument();
-    xmlWriterLog.writeStartElement("MEGA");
-    for (int i = 0; i < n; i++)
+    const QVector<LogRecord> records = debugDataModel->records();
+    for (const LogRecord &record : records)
     {
-        xmlWriterLog.writeStartElement("log");
-        //Add timestamp and value
-        xmlWriterLog.writeAttribute("timestamp", debugDataModel->item(i,0)->text());
-        //Add type and value
-        xmlWriterLog.writeAttribute("type", debugDataModel->item(i,1)->text());
-        //Add content and value
-        xmlWriterLog.writeAttribute("content", debugDataModel->item(i,2)->text());
-        xmlWriterLog.writeEndElement();
+        LogRecordStream::appendRecord(ba, record);
     }
 
-    //Close tags
-    xmlWriterLog.writeEndElement();
-    xmlWriterLog.writeEndDocument();
     out << qCompress(ba);
     file.close();
 }
@@ -275,20 +269,31 @@ void MegaDebugServer::loadFromFile()
     QDataStream in(&file);
     QByteArray ba;
     in >> ba;
+    ba = qUncompress(ba);
+    file.close();
+
+    if (ba.startsWith(LOG_FILE_MAGIC))
+    {
+        ba.remove(0, int(strlen(LOG_FILE_MAGIC)));
+        QVector<LogRecord> records;
+        if (!LogRecordStream::takeRecords(ba, records))
+        {
+            ui->statusBar->showMessage(tr("Invalid log file"));
+        }
+        appendRecords(records);
+        return;
+    }
 
-    QXmlStreamReader xmlLoad(qUncompress(ba));
+    QXmlStreamReader xmlLoad(ba);
     parseReader(&xmlLoad);
-    file.close();
 }
 
 void MegaDebugServer::clearDebugWindow()
 {
-    debugDataModel->removeRows(0,debugDataModel->rowCount());
+    debugDataModel->clear();
 }
 MegaDebugServer::~MegaDebugServer()
 {
     disconnected();
-    delete debugDataModel;
-    delete debugProxyModel;
     delete ui;
 }
@@ -5,20 +5,12 @@
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QObject>
-#include <QSortFilterProxyModel>
-#include <QStandardItemModel>
 #include <QXmlStreamReader>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QTimer>
 
-struct DebugRow
-{
-    QString timeStamp;
-    QString messageType;
-    QString content;
-
-};
+#include "LogRingModel.h"
 
 namespace Ui {
 class MegaDebugServer;
@@ -37,11 +29,10 @@ private:
     Ui::MegaDebugServer *ui;
     QLocalServer *megaServer;
     QLocalSocket *megaSyncClient;
-    QXmlStreamReader *reader;
+    QByteArray pendingData;
     QLocalSocket client;
 
-    QSortFilterProxyModel *debugProxyModel;
-    QStandardItemModel *debugDataModel;
+    LogRingModel *debugDataModel;
     QTimer timer;
 
 private slots:
@@ -51,11 +42,9 @@ private slots:
     void disconnected();
     void tryConnect();
 
-    void filterTextRegExp();
-    void filterColumn();
-    void filterCaseSensitive();
+    void updateFilter();
 
-    void appendDebugRow(DebugRow *);
+    void appendRecords(const QVector<LogRecord> &records);
 
     void saveToFile();
     void loadFromFile();
@@ -0,0 +1,181 @@
+#include "mega_sync_roots.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// canonical folders kept before starting over
+#define MAX_CACHED_FOLDERS 1024
+
+typedef struct _MEGASyncRootNode MEGASyncRootNode;
+
+struct _MEGASyncRootNode {
+    GHashTable *children; // path component -> MEGASyncRootNode, NULL if there are none
+    gboolean is_root; // TRUE if the path up to here is a sync folder
+};
+
+struct _MEGASyncRoots {
+    MEGASyncRootNode *root;
+    GHashTable *h_canonical; // folder path -> canonical folder path
+};
+
+static void mega_sync_root_node_free(gpointer data)
+{
+    MEGASyncRootNode *node = data;
+    if (node->children)
+        g_hash_table_destroy(node->children);
+    g_free(node);
+}
+
+static MEGASyncRootNode *mega_sync_root_node_new(void)
+{
+    return g_new0(MEGASyncRootNode, 1);
+}
+
+// copy the next component of the path to component, and return the position after it
+// return NULL if there are no more components
+static const gchar *next_component(const gchar *p, gchar *component)
+{
+    const gchar *end;
+    gsize len;
+
+    while (*p == '/')
+        p++;
+    if (!*p)
+        return NULL;
+
+    end = strchr(p, '/');
+    len = end ? (gsize)(end - p) : strlen(p);
+    if (len > NAME_MAX)
+        len = NAME_MAX;
+    memcpy(component, p, len);
+    component[len] = '\0';
+    return p + len;
+}
+
+MEGASyncRoots *mega_sync_roots_new(void)
+{
+    MEGASyncRoots *roots = g_new0(MEGASyncRoots, 1);
+    roots->root = mega_sync_root_node_new();
+    roots->h_canonical = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    return roots;
+}
+
+void mega_sync_roots_free(MEGASyncRoots *roots)
+{
+    if (!roots)
+        return;
+    mega_sync_root_node_free(roots->root);
+    g_hash_table_destroy(roots->h_canonical);
+    g_free(roots);
+}
+
+void mega_sync_roots_add(MEGASyncRoots *roots, const gchar *path)
+{
+    MEGASyncRootNode *node = roots->root;
+    gchar component[NAME_MAX + 1];
+    const gchar *p = path;
+
+    while ((p = next_component(p, component))) {
+        MEGASyncRootNode *child = NULL;
+        if (!node->children)
+            node->children = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, mega_sync_root_node_free);
+        else
+            child = g_hash_table_lookup(node->children, component);
+
+        if (!child) {
+            child = mega_sync_root_node_new();
+            g_hash_table_insert(node->children, g_strdup(component), child);
+        }
+        node = child;
+    }
+    node->is_root = TRUE;
+    g_hash_table_remove_all(roots->h_canonical);
+}
+
+// return TRUE if node is left without sync folders below it
+static gboolean mega_sync_root_node_remove(MEGASyncRootNode *node, const gchar *p)
+{
+    gchar component[NAME_MAX + 1];
+    const gchar *next = next_component(p, component);
+
+    if (!next) {
+        node->is_root = FALSE;
+    } else if (node->children) {
+        MEGASyncRootNode *child = g_hash_table_lookup(node->children, component);
+        if (child && mega_sync_root_node_remove(child, next))
+            g_hash_table_remove(node->children, component);
+
+        if (!g_hash_table_size(node->children)) {
+            g_hash_table_destroy(node->children);
+            node->children = NULL;
+        }
+    }
+    return !node->is_root && !node->children;
+}
+
+void mega_sync_roots_remove(MEGASyncRoots *roots, const gchar *path)
+{
+    mega_sync_root_node_remove(roots->root, path);
+    g_hash_table_remove_all(roots->h_canonical);
+}
+
+gboolean mega_sync_roots_contains(const MEGASyncRoots *roots, const gchar *path)
+{
+    const MEGASyncRootNode *node = roots->root;
+    gchar component[NAME_MAX + 1];
+    const gchar *p = path;
+
+    while (!node->is_root) {
+        if (!node->children)
+            return FALSE;
+        p = next_component(p, component);
+        if (!p)
+            return FALSE;
+        node = g_hash_table_lookup(node->children, component);
+        if (!node)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean mega_sync_roots_path_in_sync(MEGASyncRoots *roots, const gchar *path)
+{
+    const gchar *name;
+    const gchar *canonical;
+    gchar folder[PATH_MAX];
+    gchar resolved[PATH_MAX];
+    gsize len;
+
+    if (mega_sync_roots_contains(roots, path))
+        return TRUE;
+
+    // the path may still reach a sync through a symlink
+    name = strrchr(path, '/');
+    if (!name || name == path)
+        return FALSE;
+
+    len = name - path;
+    if (len >= PATH_MAX)
+        return FALSE;
+    memcpy(folder, path, len);
+    folder[len] = '\0';
+
+    // the cache is only dropped when a sync folder is added or removed
+    canonical = g_hash_table_lookup(roots->h_canonical, folder);
+    if (!canonical) {
+        if (g_hash_table_size(roots->h_canonical) >= MAX_CACHED_FOLDERS)
+            g_hash_table_remove_all(roots->h_canonical);
+
+        canonical = g_strdup(realpath(folder, resolved) ? resolved : folder);
+        g_hash_table_insert(roots->h_canonical, g_strdup(folder), (gpointer)canonical);
+    }
+
+    // nothing to resolve
+    if (!strcmp(canonical, folder))
+        return FALSE;
+
+    if (strlen(canonical) + strlen(name) >= PATH_MAX)
+        return FALSE;
+    g_snprintf(resolved, PATH_MAX, "%s%s", canonical, name);
+    return mega_sync_roots_contains(roots, resolved);
+}
@@ -0,0 +1,25 @@
+#ifndef MEGA_SYNC_ROOTS_H
+#define MEGA_SYNC_ROOTS_H
+
+#include <glib.h>
+
+// Paths of the sync folders, kept in a trie with one level per path component, so that checking
+// whether a path is in a sync is a single walk over the path, without system calls.
+// The canonical paths (symlinks resolved) of the folders of the checked paths are cached
+// until a sync folder is added or removed, as reported by the notification server.
+// Shared by the Nautilus, Nemo and Thunar extensions.
+typedef struct _MEGASyncRoots MEGASyncRoots;
+
+MEGASyncRoots *mega_sync_roots_new(void);
+void mega_sync_roots_free(MEGASyncRoots *roots);
+
+void mega_sync_roots_add(MEGASyncRoots *roots, const gchar *path);
+void mega_sync_roots_remove(MEGASyncRoots *roots, const gchar *path);
+
+// return TRUE if path is a sync folder or is located in one, without resolving symlinks
+gboolean mega_sync_roots_contains(const MEGASyncRoots *roots, const gchar *path);
+
+// return TRUE if path, or path with the symlinks of its folder resolved, is located in a sync folder
+gboolean mega_sync_roots_path_in_sync(MEGASyncRoots *roots, const gchar *path);
+
+#endif
@@ -12,6 +12,17 @@ HEADERS += MEGAShellExt.h \
     mega_ext_client.h \
     mega_notify_client.h
 
+# mega_sync_roots is shared by the Linux extensions. The source tarballs carry it next to the
+# other files
+exists($$PWD/mega_sync_roots.c) {
+    COMMON_PATH = $$PWD
+} else {
+    COMMON_PATH = $$PWD/../MEGAShellExtCommon
+}
+INCLUDEPATH += $$COMMON_PATH
+SOURCES += $$COMMON_PATH/mega_sync_roots.c
+HEADERS += $$COMMON_PATH/mega_sync_roots.h
+
 NAUTILUS_EXT = $$system(pkg-config --list-all | grep libnautilus-extension | head -n1 | cut -f1 -d\" \")
 NAUTILUS_EXT_API_VERSION = $$system(pkg-config $${NAUTILUS_EXT} --variable=extensions_api_version)
 
@@ -84,6 +84,8 @@ void mega_notify_client_destroy(MEGAExt *mega_ext)
         close(mega_ext->notify_sock);
     mega_ext->notify_sock = -1;
     mega_ext->syncs_received = FALSE;
+    // the app may come back with another language
+    g_hash_table_remove_all(mega_ext->h_strings);
 }
 
 static gboolean mega_notify_client_read(GIOChannel *notify_chan, GIOCondition condition, gpointer data)
@@ -141,6 +143,9 @@ static gboolean mega_notify_client_read(GIOChannel *notify_chan, GIOCondition co
         case 'D': // sync folder deleted
             mega_ext_on_sync_del(mega_ext, p);
             break;
+        case 'L': // language changed
+            mega_ext_on_language_changed(mega_ext, p);
+            break;
         default:
             g_warning("Failed to read data!");
             g_free(in_line);
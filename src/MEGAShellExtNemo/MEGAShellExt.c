@@ -9,9 +9,19 @@
 
 static GObjectClass *parent_class;
 
+static void mega_ext_finalize(GObject *object)
+{
+    MEGAExt *mega_ext = MEGA_EXT(object);
+
+    mega_sync_roots_free(mega_ext->sync_roots);
+    g_hash_table_destroy(mega_ext->h_strings);
+    parent_class->finalize(object);
+}
+
 static void mega_ext_class_init(MEGAExtClass *class)
 {
     parent_class = g_type_class_peek_parent(class);
+    G_OBJECT_CLASS(class)->finalize = mega_ext_finalize;
 }
 
 static void mega_ext_instance_init(MEGAExt *mega_ext)
@@ -20,11 +30,8 @@ static void mega_ext_instance_init(MEGAExt *mega_ext)
     mega_ext->notify_sock = -1;
     mega_ext->chan = NULL;
     mega_ext->num_retries = 2;
-    mega_ext->h_syncs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
-    mega_ext->string_getlink = NULL;
-    mega_ext->string_viewonmega = NULL;
-    mega_ext->string_viewprevious = NULL;
-    mega_ext->string_upload = NULL;
+    mega_ext->sync_roots = mega_sync_roots_new();
+    mega_ext->h_strings = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
     mega_ext->syncs_received = FALSE;
 
     // ignore SIGPIPE as we most likely will write to a closed socket in mega_notify_client_read()
@@ -53,6 +60,7 @@ static const gchar *file_state_to_str(FileState state)
 void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path)
 {
     GFile *f;
+
     f = g_file_new_for_path(path);
     if (!f) {
         g_debug("No file found for %s!", path);
@@ -110,13 +118,19 @@ void mega_ext_on_sync_add(MEGAExt *mega_ext, const gchar *path)
     if (!strcmp(path, "."))
         return;
     g_debug("New sync path: %s", path);
-    g_hash_table_insert(mega_ext->h_syncs, g_strdup(path), GINT_TO_POINTER(1));
+    mega_sync_roots_add(mega_ext->sync_roots, path);
 }
 
 void mega_ext_on_sync_del(MEGAExt *mega_ext, const gchar *path)
 {
     g_debug("Deleted sync path: %s", path);
-    g_hash_table_remove(mega_ext->h_syncs, path);
+    mega_sync_roots_remove(mega_ext->sync_roots, path);
+}
+
+void mega_ext_on_language_changed(MEGAExt *mega_ext, const gchar *language)
+{
+    g_debug("Language changed: %s", language);
+    g_hash_table_remove_all(mega_ext->h_strings);
 }
 
 
@@ -140,33 +154,7 @@ void expanselocalpath(char *path, char *absolutepath)
 // return TRUE if path located in one of the sync folders
 static gboolean mega_ext_path_in_sync(MEGAExt *mega_ext, const gchar *path)
 {
-    GList *l, *p;
-    gboolean found = FALSE;
-
-    l = g_hash_table_get_keys(mega_ext->h_syncs);
-    for (p = g_list_first(l); p; p = g_list_next(p)) {
-        const gchar *sync = p->data;
-        // sync must be a prefix of path
-        if (strlen(sync) <= strlen(path)) {
-            if (!strncmp(sync, path, strlen(sync))) {
-                found = TRUE;
-                break;
-            }
-        }
-
-        char canonical[PATH_MAX];
-        expanselocalpath(path,canonical);
-        if (strlen(sync) <= strlen(canonical)) {
-            if (!strncmp(sync, canonical, strlen(sync))) {
-                found = TRUE;
-                break;
-            }
-        }
-    }
-
-    g_list_free(l);
-
-    return found;
+    return mega_sync_roots_path_in_sync(mega_ext->sync_roots, path);
 }
 
 // user clicked on "Get MEGA link" menu item
@@ -383,8 +371,6 @@ static GList *mega_ext_get_file_items(NemoMenuProvider *provider, G_GNUC_UNUSED
 
         out = mega_ext_client_get_string(mega_ext, STRING_UPLOAD, unsyncedFiles, unsyncedFolders);
         item = nemo_menu_item_new("MEGAExtension::upload_to_mega", out, "Upload files to you MEGA account", "mega");
-        g_free(mega_ext->string_upload);
-        mega_ext->string_upload = g_strdup(out);
         g_free(out);
 
         g_signal_connect(item, "activate", G_CALLBACK(mega_ext_on_upload_selected), provider);
@@ -400,8 +386,6 @@ static GList *mega_ext_get_file_items(NemoMenuProvider *provider, G_GNUC_UNUSED
 
         out = mega_ext_client_get_string(mega_ext, STRING_GETLINK, syncedFiles, syncedFolders);
         item = nemo_menu_item_new("MEGAExtension::get_mega_link", out, "Get MEGA link", "mega");
-        g_free(mega_ext->string_getlink);
-        mega_ext->string_getlink = g_strdup(out);
         g_free(out);
 
         g_signal_connect(item, "activate", G_CALLBACK(mega_ext_on_get_link_selected), provider);
@@ -415,8 +399,6 @@ static GList *mega_ext_get_file_items(NemoMenuProvider *provider, G_GNUC_UNUSED
             {
                 out = mega_ext_client_get_string(mega_ext, STRING_VIEW_ON_MEGA, 0, 0);
                 item = nemo_menu_item_new("MEGAExtension::view_on_mega", out, "View on MEGA", "mega");
-                g_free(mega_ext->string_viewonmega);
-                mega_ext->string_viewonmega = g_strdup(out);
                 g_free(out);
 
                 g_signal_connect(item, "activate", G_CALLBACK(mega_ext_on_view_on_mega_selected), provider);
@@ -428,8 +410,6 @@ static GList *mega_ext_get_file_items(NemoMenuProvider *provider, G_GNUC_UNUSED
             {
                 out = mega_ext_client_get_string(mega_ext, STRING_VIEW_VERSIONS, 0, 0);
                 item = nemo_menu_item_new("MEGAExtension::view_previous_versions", out, "View previous versions", "mega");
-                g_free(mega_ext->string_viewprevious);
-                mega_ext->string_viewprevious = g_strdup(out);
                 g_free(out);
 
                 g_signal_connect(item, "activate", G_CALLBACK(mega_ext_on_open_previous_selected), provider);
@@ -2,6 +2,7 @@
 #define MEGASHELLEXT_H
 
 #include <glib-object.h>
+#include "mega_sync_roots.h"
 
 G_BEGIN_DECLS
 
@@ -21,11 +22,8 @@ struct _MEGAExt {
     gint num_retries; // reconnection retries
     gboolean syncs_received; // TRUE if the list with sync folders is received
 
-    GHashTable *h_syncs; // table of paths of shared folders
-    gchar *string_upload; // cached string
-    gchar *string_getlink; // cached string
-    gchar *string_viewonmega; // cached string
-    gchar *string_viewprevious; // cached string
+    MEGASyncRoots *sync_roots; // paths of the sync folders
+    GHashTable *h_strings; // translated strings, by request, until the language changes
 
 };
 
@@ -59,5 +57,6 @@ G_END_DECLS
 void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path);
 void mega_ext_on_sync_add(MEGAExt *mega_ext, const gchar *path);
 void mega_ext_on_sync_del(MEGAExt *mega_ext, const gchar *path);
+void mega_ext_on_language_changed(MEGAExt *mega_ext, const gchar *language);
 
 #endif
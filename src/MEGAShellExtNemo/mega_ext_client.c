@@ -15,6 +15,9 @@ const gchar OP_STRING      = 'T'; //Get Translated String
 const gchar OP_VIEW        = 'V'; //View on MEGA
 const gchar OP_PREVIOUS    = 'R'; //View previous versions
 
+// translated strings kept before starting over
+#define MAX_CACHED_STRINGS 64
+
 static void mega_ext_client_disconnect(MEGAExt *mega_ext);
 
 // try to connect to the server
@@ -147,14 +150,29 @@ static gchar *mega_ext_client_send_request(MEGAExt *mega_ext, gchar type, const
 }
 
 // return a newly-allocated string
+// strings are cached until the notification server reports a language change
 gchar *mega_ext_client_get_string(MEGAExt *mega_ext, int stringID, int numFiles, int numFolders)
 {
     gchar *in;
     gchar *out;
 
     in = g_strdup_printf("%d:%d:%d", stringID, numFiles, numFolders);
+    out = g_hash_table_lookup(mega_ext->h_strings, in);
+    if (out) {
+        g_free(in);
+        return g_strdup(out);
+    }
+
     out = mega_ext_client_send_request(mega_ext, OP_STRING, in);
-    g_free(in);
+    // strings can't be invalidated without the notification server
+    if (!out || !mega_ext->notify_chan) {
+        g_free(in);
+        return out;
+    }
+
+    if (g_hash_table_size(mega_ext->h_strings) >= MAX_CACHED_STRINGS)
+        g_hash_table_remove_all(mega_ext->h_strings);
+    g_hash_table_insert(mega_ext->h_strings, in, g_strdup(out));
 
     return out;
 }
@@ -62,6 +62,7 @@ static void mega_ext_class_init(MEGAExtClass *klass)
 
 static void mega_ext_finalize(GObject *object)
 {
+    mega_sync_roots_free(MEGA_EXT(object)->sync_roots);
     (*G_OBJECT_CLASS (mega_ext_parent_class)->finalize)(object);
 }
 
@@ -70,7 +71,7 @@ static void mega_ext_init(MEGAExt *mega_ext)
     mega_ext->srv_sock = -1;
     mega_ext->chan = NULL;
     mega_ext->num_retries = 2;
-    mega_ext->h_syncs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    mega_ext->sync_roots = mega_sync_roots_new();
     mega_ext->string_getlink = NULL;
     mega_ext->string_viewonmega = NULL;
     mega_ext->string_viewprevious = NULL;
@@ -570,31 +571,5 @@ static GList* mega_ext_get_folder_actions(ThunarxMenuProvider *provider, G_GNUC_
 // return TRUE if path located in one of the sync folders
 static gboolean mega_ext_path_in_sync(MEGAExt *mega_ext, const gchar *path)
 {
-    GList *l, *p;
-    gboolean found = FALSE;
-
-    l = g_hash_table_get_keys(mega_ext->h_syncs);
-    for (p = g_list_first(l); p; p = g_list_next(p)) {
-        const gchar *sync = p->data;
-        // sync must be a prefix of path
-        if (strlen(sync) <= strlen(path)) {
-            if (!strncmp(sync, path, strlen(sync))) {
-                found = TRUE;
-                break; 
-            }
-        }
-
-        char canonical[PATH_MAX];
-        expanselocalpath(path,canonical);
-        if (strlen(sync) <= strlen(canonical)) {
-            if (!strncmp(sync, canonical, strlen(sync))) {
-                found = TRUE;
-                break;
-            }
-        }
-    }
-
-    g_list_free(l);
-
-    return found;
+    return mega_sync_roots_path_in_sync(mega_ext->sync_roots, path);
 }
@@ -3,6 +3,7 @@
 #define _MEGA_SYNC_EXT_PLUGIN_H_
 
 #include <thunarx/thunarx.h>
+#include "mega_sync_roots.h"
 
 G_BEGIN_DECLS;
 
@@ -32,7 +33,7 @@ struct _MEGAExt
     gint num_retries; // reconnection retries
     gboolean syncs_received; // TRUE if the list with sync folders is received
 
-    GHashTable *h_syncs; // table of paths of shared folders
+    MEGASyncRoots *sync_roots; // paths of the sync folders
     gchar *string_upload; // cached string
     gchar *string_getlink; // cached string
     gchar *string_viewonmega; // cached string
@@ -9,6 +9,17 @@ SOURCES += MEGAShellExt.c \
 HEADERS += MEGAShellExt.h \
     mega_ext_client.h
 
+# mega_sync_roots is shared by the Linux extensions. The source tarballs carry it next to the
+# other files
+exists($$PWD/mega_sync_roots.c) {
+    COMMON_PATH = $$PWD
+} else {
+    COMMON_PATH = $$PWD/../MEGAShellExtCommon
+}
+INCLUDEPATH += $$COMMON_PATH
+SOURCES += $$COMMON_PATH/mega_sync_roots.c
+HEADERS += $$COMMON_PATH/mega_sync_roots.h
+
 CONFIG += link_pkgconfig
 
 system(pkg-config --exists thunarx-2) {
@@ -67,42 +67,39 @@ DesktopNotifications::DesktopNotifications(const QString &appName, QSystemTrayIc
     appDir.mkdir(iconFolderName);
     copyIconsToAppFolder(getIconsPath());
 
-    QObject::connect(&mRemovedSharedNotificator, &RemovedSharesNotificator::sendClusteredAlert, this, &DesktopNotifications::receiveClusteredAlert);
+    QObject::connect(&mAlertAggregator, &UserAlertAggregator::summaryReady, this, &DesktopNotifications::onAlertSummaryReady);
 }
 
-QString DesktopNotifications::getItemsAddedText(mega::MegaUserAlert *info)
+QString DesktopNotifications::getUserName(const QString& email) const
 {
-    const int updatedItems = static_cast<int>(info->getNumber(1) + info->getNumber(0));
-    auto FullNameRequest = mUserAttributes.value(QString::fromUtf8(info->getEmail()));
-    QString message(tr("[A] added %n item", "", updatedItems));
-    if(FullNameRequest)
+    auto fullNameRequest = mUserAttributes.value(email);
+    if (!fullNameRequest && !email.isEmpty())
     {
-        return message
-                .replace(QString::fromUtf8("[A]"), FullNameRequest->getFullName());
-    }
-    else
-    {
-        return message
-                .replace(QString::fromUtf8("[A]"), QString::fromUtf8(info->getEmail()));
+        fullNameRequest = UserAttributes::FullName::requestFullName(email.toUtf8().constData());
     }
+
+    const QString fullName = fullNameRequest ? fullNameRequest->getFullName() : QString();
+    return fullName.isEmpty() ? email : fullName;
+}
+
+QString DesktopNotifications::getItemsAddedText(long long items, const QString& email) const
+{
+    return tr("[A] added %n item", "", static_cast<int>(items))
+            .replace(QString::fromUtf8("[A]"), getUserName(email));
+}
+
+QString DesktopNotifications::getItemsRemovedText(long long items, const QString& email) const
+{
+    return QCoreApplication::translate("OsNotifications", "[A] removed %n item", "", static_cast<int>(items))
+            .replace(QString::fromUtf8("[A]"), getUserName(email));
 }
 
-QString DesktopNotifications::createDeletedShareMessage(mega::MegaUserAlert* info)
+QString DesktopNotifications::createDeletedShareMessage(mega::MegaUserAlert* info) const
 {
     QString message;
-    QString name;
+    const QString name = getUserName(QString::fromUtf8(info->getEmail()));
 
     const bool someoneLeftTheFolder{info->getNumber(0) == 0};
-    auto FullNameRequest = mUserAttributes.value(QString::fromUtf8(info->getEmail()));
-    if(FullNameRequest)
-    {
-        name = FullNameRequest->getFullName();
-    }
-    else
-    {
-        name = QString::fromUtf8(info->getEmail());
-    }
-
     if (someoneLeftTheFolder)
     {
         message = tr("[A] has left the shared folder")
@@ -118,6 +115,25 @@ QString DesktopNotifications::createDeletedShareMessage(mega::MegaUserAlert* inf
     return message;
 }
 
+long long DesktopNotifications::getNewItems(mega::MegaUserAlert* alert, long long total)
+{
+    // A big enough history: alerts are only updated while they are recent
+    constexpr int maxTrackedAlerts{1000};
+    if (mAlertItemTotals.size() > maxTrackedAlerts)
+    {
+        mAlertItemTotals.clear();
+    }
+
+    const long long previousTotal = mAlertItemTotals.value(alert->getId(), 0);
+    mAlertItemTotals.insert(alert->getId(), total);
+    if (total < previousTotal)
+    {
+        // Not an update of the same alert
+        return total;
+    }
+    return total - previousTotal;
+}
+
 int DesktopNotifications::countUnseenAlerts(mega::MegaUserAlertList *alertList)
 {
     auto count = 0;
@@ -146,6 +162,8 @@ void DesktopNotifications::addUserAlertList(mega::MegaUserAlertList *alertList)
         mIsFirstTime = false;
     }
 
+    // The full name of each user is only requested once per list
+    QHash<QString, std::shared_ptr<const UserAttributes::FullName>> requestedNames;
     for(int iAlert = 0; iAlert < alertList->size(); iAlert++)
     {
         const auto alert = alertList->get(iAlert);
@@ -157,7 +175,12 @@ void DesktopNotifications::addUserAlertList(mega::MegaUserAlertList *alertList)
 
             if(!userEmail.isEmpty())
             {
-                auto fullNameUserAttributes = UserAttributes::FullName::requestFullName(userEmail.toUtf8().constData());
+                auto requestedName = requestedNames.constFind(userEmail);
+                if (requestedName == requestedNames.constEnd())
+                {
+                    requestedName = requestedNames.insert(userEmail, UserAttributes::FullName::requestFullName(userEmail.toUtf8().constData()));
+                }
+                auto fullNameUserAttributes = requestedName.value();
                 if(fullNameUserAttributes && !mUserAttributes.contains(userEmail))
                 {
                     mUserAttributes.insert(userEmail, fullNameUserAttributes);
@@ -185,15 +208,7 @@ void DesktopNotifications::addUserAlertList(mega::MegaUserAlertList *alertList)
 void DesktopNotifications::processAlert(mega::MegaUserAlert* alert)
 {
     QString email = QString::fromUtf8(alert->getEmail());
-    QString fullName = email;
-    if (!email.isEmpty())
-    {
-        auto FullNameRequest = mUserAttributes.value(email);
-        if (FullNameRequest)
-        {
-            fullName = FullNameRequest->getFullName();
-        }
-    }
+    QString fullName = getUserName(email);
 
     switch (alert->getType())
     {
@@ -262,9 +277,8 @@ void DesktopNotifications::processAlert(mega::MegaUserAlert* alert)
     {
         if(mPreferences->isNotificationEnabled(Preferences::NotificationsTypes::NEW_FOLDERS_SHARED_WITH_ME))
         {
-            const QString message{tr("New shared folder from [A]")
-                        .replace(QString::fromUtf8("[A]"), fullName)};
-            notifySharedUpdate(alert, message, NEW_SHARE);
+            // New shares of the same user are grouped together
+            aggregateAlert(alert, mega::INVALID_HANDLE, 1);
         }
         break;
     }
@@ -272,7 +286,7 @@ void DesktopNotifications::processAlert(mega::MegaUserAlert* alert)
     {
         if(mPreferences->isNotificationEnabled(Preferences::NotificationsTypes::FOLDERS_SHARED_WITH_ME_DELETED))
         {
-            notifySharedUpdate(alert, createDeletedShareMessage(alert), DELETE_SHARE);
+            aggregateAlert(alert, alert->getNodeHandle(), 1);
         }
         break;
     }
@@ -280,7 +294,11 @@ void DesktopNotifications::processAlert(mega::MegaUserAlert* alert)
     {
         if(mPreferences->isNotificationEnabled(Preferences::NotificationsTypes::NODES_SHARED_WITH_ME_CREATED_OR_REMOVED))
         {
-            notifySharedUpdate(alert, getItemsAddedText(alert), NEW_SHARED_NODES);
+            const auto newItems = getNewItems(alert, alert->getNumber(0) + alert->getNumber(1));
+            if(newItems > 0)
+            {
+                aggregateAlert(alert, alert->getNodeHandle(), newItems);
+            }
         }
         break;
     }
@@ -288,7 +306,11 @@ void DesktopNotifications::processAlert(mega::MegaUserAlert* alert)
     {
         if(mPreferences->isNotificationEnabled(Preferences::NotificationsTypes::NODES_SHARED_WITH_ME_CREATED_OR_REMOVED))
         {
-            mRemovedSharedNotificator.addUserAlert(alert, fullName);
+            const auto removedItems = getNewItems(alert, alert->getNumber(0));
+            if(removedItems > 0)
+            {
+                aggregateAlert(alert, alert->getNodeHandle(), removedItems);
+            }
         }
         break;
     }
@@ -319,6 +341,52 @@ void DesktopNotifications::processAlert(mega::MegaUserAlert* alert)
     }
 }
 
+void DesktopNotifications::aggregateAlert(mega::MegaUserAlert* alert, mega::MegaHandle node, long long items)
+{
+    mAlertAggregator.addUserAlert(alert, alert->getType(), QString::fromUtf8(alert->getEmail()), node, items);
+}
+
+void DesktopNotifications::onAlertSummaryReady(const UserAlertAggregator::Summary& summary)
+{
+    const auto alert = summary.alert.get();
+    switch (summary.type)
+    {
+    case mega::MegaUserAlert::TYPE_NEWSHARE:
+    {
+        if(summary.alerts == 1)
+        {
+            const QString message{tr("New shared folder from [A]")
+                        .replace(QString::fromUtf8("[A]"), getUserName(summary.email))};
+            notifySharedUpdate(alert, message, NEW_SHARE);
+        }
+        else
+        {
+            const QString message{tr("[A] shared %n folder with you", "", summary.alerts)
+                        .replace(QString::fromUtf8("[A]"), getUserName(summary.email))};
+            notifySharesSummary(tr("Shared Folder Received"), message);
+        }
+        break;
+    }
+    case mega::MegaUserAlert::TYPE_DELETEDSHARE:
+    {
+        notifySharedUpdate(alert, createDeletedShareMessage(alert), DELETE_SHARE);
+        break;
+    }
+    case mega::MegaUserAlert::TYPE_NEWSHAREDNODES:
+    {
+        notifySharedUpdate(alert, getItemsAddedText(summary.items, summary.email), NEW_SHARED_NODES);
+        break;
+    }
+    case mega::MegaUserAlert::TYPE_REMOVEDSHAREDNODES:
+    {
+        notifySharedUpdate(alert, getItemsRemovedText(summary.items, summary.email), REMOVED_SHARED_NODES);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
 MegaNotification* DesktopNotifications::CreateContacNotification(const QString& title,
                                                                  const QString& message,
                                                                  const QString& email,
@@ -432,6 +500,18 @@ void DesktopNotifications::notifyUnreadNotifications() const
     mNotificator->notify(notification);
 }
 
+void DesktopNotifications::notifySharesSummary(const QString& title, const QString& message) const
+{
+    auto notification = new MegaNotification();
+    notification->setTitle(title);
+    notification->setText(message);
+    notification->setImage(mAppIcon);
+    notification->setImagePath(mFolderIconPath);
+    notification->setActions(QStringList() << tr("View"));
+    QObject::connect(notification, &MegaNotification::activated, this, &DesktopNotifications::viewOnInfoDialogNotifications);
+    mNotificator->notify(notification);
+}
+
 QString DesktopNotifications::createTakeDownMessage(mega::MegaUserAlert* alert, bool isReinstated) const
 {
     const auto megaApi = static_cast<MegaApplication*>(qApp)->getMegaApi();
@@ -697,17 +777,6 @@ void DesktopNotifications::viewShareOnWebClient(MegaNotification::Action action)
     }
 }
 
-void DesktopNotifications::receiveClusteredAlert(mega::MegaUserAlert *alert, const QString &message) const
-{
-    switch (alert->getType())
-    {
-    case mega::MegaUserAlert::TYPE_REMOVEDSHAREDNODES:
-    {
-        notifySharedUpdate(alert, message, REMOVED_SHARED_NODES);
-    }
-    }
-}
-
 void DesktopNotifications::replayNewShareReceived(MegaNotification::Action action) const
 {
     const bool actionIsViewOnWebClient{checkIfActionIsValid(action)};
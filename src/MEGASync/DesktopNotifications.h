@@ -1,6 +1,6 @@
 #pragma once
 #include "notificator.h"
-#include "RemovedSharesNotificator.h"
+#include "UserAlertAggregator.h"
 #include "Preferences.h"
 #include "QTMegaRequestListener.h"
 
@@ -42,24 +42,29 @@ public slots:
     void redirectToPayBusiness(MegaNotification::Action activationButton) const;
     void showInFolder(MegaNotification::Action action) const;
     void viewShareOnWebClient(MegaNotification::Action action) const;
-    void receiveClusteredAlert(mega::MegaUserAlert* alert, const QString& message) const;
     void replayNewShareReceived(MegaNotification::Action action) const;
     void viewOnInfoDialogNotifications(MegaNotification::Action action) const;
 
 private slots:
     void OnUserAttributesReady();
+    void onAlertSummaryReady(const UserAlertAggregator::Summary& summary);
 
 private:
     void notifyTakeDown(mega::MegaUserAlert* alert, bool isReinstated = false) const;
     void notifySharedUpdate(mega::MegaUserAlert* alert, const QString& message, int type) const;
     void notifyUnreadNotifications() const;
+    void notifySharesSummary(const QString& title, const QString& message) const;
 
-    QString getItemsAddedText(mega::MegaUserAlert* info);
-    QString createDeletedShareMessage(mega::MegaUserAlert* info);
+    QString getUserName(const QString& email) const;
+    QString getItemsAddedText(long long items, const QString& email) const;
+    QString getItemsRemovedText(long long items, const QString& email) const;
+    QString createDeletedShareMessage(mega::MegaUserAlert* info) const;
+    long long getNewItems(mega::MegaUserAlert* alert, long long total);
     QString createTakeDownMessage(mega::MegaUserAlert* alert, bool isReinstated = false) const;
     int countUnseenAlerts(mega::MegaUserAlertList *alertList);
 
     void processAlert(mega::MegaUserAlert* alert);
+    void aggregateAlert(mega::MegaUserAlert* alert, mega::MegaHandle node, long long items);
     MegaNotification* CreateContacNotification(const QString& title,
                                                const QString& message,
                                                const QString& email,
@@ -69,7 +74,9 @@ private:
     QIcon mAppIcon;
     QString mNewContactIconPath, mStorageQuotaFullIconPath, mStorageQuotaWarningIconPath;
     QString mFolderIconPath, mFileDownloadSucceedIconPath;
-    RemovedSharesNotificator mRemovedSharedNotificator;
+    UserAlertAggregator mAlertAggregator;
+    // Alerts about shared nodes are updated with the running total of items, by alert id
+    QHash<unsigned, long long> mAlertItemTotals;
     std::shared_ptr<Preferences> mPreferences;
     bool mIsFirstTime;//Check first time alerts are added to show unified message of unread.
 
@@ -132,6 +132,8 @@ unix:!macx {
 
 DEPENDPATH += $$PWD
 INCLUDEPATH += $$PWD
+# LogRecord.h, shared with MEGAlogger
+INCLUDEPATH += $$PWD/../MEGALogger
 
 DEFINES += QT_NO_CAST_FROM_ASCII QT_NO_CAST_TO_ASCII
 
@@ -141,9 +143,8 @@ DEFINES += QT_NO_CAST_FROM_ASCII QT_NO_CAST_TO_ASCII
 
 SOURCES += $$PWD/MegaApplication.cpp \
     $$PWD/DesktopNotifications.cpp \
-    $$PWD/RemovedSharesNotificator.cpp \
+    $$PWD/UserAlertAggregator.cpp \
     $$PWD/TransferQuota.cpp \
-    $$PWD/UserAlertTimedClustering.cpp \
     $$PWD/ScaleFactorManager.cpp \
     $$PWD/CommonMessages.cpp \
     $$PWD/ScanStageController.cpp \
@@ -159,9 +160,8 @@ SOURCES += $$PWD/MegaApplication.cpp \
 
 HEADERS += $$PWD/MegaApplication.h \
     $$PWD/DesktopNotifications.h \
-    $$PWD/RemovedSharesNotificator.h \
+    $$PWD/UserAlertAggregator.h \
     $$PWD/TransferQuota.h \
-    $$PWD/UserAlertTimedClustering.h \
     $$PWD/ScaleFactorManager.h \
     $$PWD/CommonMessages.h \
     $$PWD/ScanStageController.h \
@@ -5,6 +5,8 @@
 #include "control/AppStatsEvents.h"
 #include "control/Utilities.h"
 #include "control/CrashHandler.h"
+#include "control/DebrisSizeAccountant.h"
+#include "control/DirectoryWalker.h"
 #include "control/ExportProcessor.h"
 #include "EventUpdater.h"
 #include "platform/Platform.h"
@@ -47,6 +49,8 @@
 #ifndef WIN32
 //sleep
 #include <unistd.h>
+//getrusage
+#include <sys/resource.h>
 #else
 #include <Windows.h>
 #include <Psapi.h>
@@ -205,6 +209,7 @@ MegaApplication::MegaApplication(int &argc, char **argv) :
     logger.reset(new MegaSyncLogger(this, dataPath, desktopPath, logToStdout));
 #if defined(LOG_TO_FILE)
     logger->setDebug(true);
+    startTracing();
 #endif
 
     mThreadPool = ThreadPoolSingleton::getInstance();
@@ -316,11 +321,15 @@ MegaApplication::MegaApplication(int &argc, char **argv) :
     storageOverquotaDialog = NULL;
     infoWizard = NULL;
     mTransferManager = nullptr;
-    cleaningSchedulerExecution = 0;
+    mTaskScheduler = nullptr;
+    mStartup = new StartupOrchestrator(this);
     lastUserActivityExecution = 0;
     lastTsBusinessWarning = 0;
     lastTsErrorMessageShown = 0;
     maxMemoryUsage = 0;
+#ifdef Q_OS_LINUX
+    mResourceSampler = nullptr;
+#endif
     nUnviewedTransfers = 0;
     completedTabActive = false;
     nodescurrent = false;
@@ -340,9 +349,6 @@ MegaApplication::MegaApplication(int &argc, char **argv) :
     }
     queuedStorageUserStatsReason = 0;
 
-#ifdef __APPLE__
-    scanningTimer = NULL;
-#endif
 
     mDisableGfx = args.contains(QLatin1String("--nogfx")) || args.contains(QLatin1String("/nogfx"));
     folderTransferListener = std::make_shared<FolderTransferListener>(nullptr);
@@ -429,6 +435,68 @@ void MegaApplication::initialize()
     isLinux = false;
 #endif
 
+    mStartup->addPhase(QString::fromUtf8("preferences"), StartupOrchestrator::IMMEDIATE, QStringList(), [this]()
+    {
+        initPreferences();
+    });
+    mStartup->addPhase(QString::fromUtf8("sdk"), StartupOrchestrator::IMMEDIATE,
+                       QStringList() << QString::fromUtf8("preferences"), [this]()
+    {
+        initSdk();
+    });
+#ifdef _WIN32
+    mStartup->addPhase(QString::fromUtf8("installationPermissions"), StartupOrchestrator::BACKGROUND,
+                       QStringList() << QString::fromUtf8("preferences"), [this]()
+    {
+        fixInstallationPermissions();
+    });
+#endif
+    // Registering the job can be slow (the Windows task scheduler) and nothing waits for it
+    mStartup->addPhase(QString::fromUtf8("updateJob"), StartupOrchestrator::DEFERRED,
+                       QStringList() << QString::fromUtf8("preferences"), [this]()
+    {
+        if (!preferences->isOneTimeActionDone(Preferences::ONE_TIME_ACTION_REGISTER_UPDATE_TASK))
+        {
+            bool success = Platform::registerUpdateJob();
+            if (success)
+            {
+                preferences->setOneTimeActionDone(Preferences::ONE_TIME_ACTION_REGISTER_UPDATE_TASK, true);
+            }
+        }
+    });
+    mStartup->addPhase(QString::fromUtf8("crashRecovery"), StartupOrchestrator::IMMEDIATE,
+                       QStringList() << QString::fromUtf8("sdk"), [this]()
+    {
+        checkCrashRecovery();
+    });
+    mStartup->addPhase(QString::fromUtf8("services"), StartupOrchestrator::IMMEDIATE,
+                       QStringList() << QString::fromUtf8("sdk"), [this]()
+    {
+        initServices();
+    });
+    // Starts the transfer event thread. Nothing uses the model before the login, which needs the
+    // event loop, so it is not created before the first window can be shown
+    mStartup->addPhase(QString::fromUtf8("transfersModel"), StartupOrchestrator::DEFERRED,
+                       QStringList() << QString::fromUtf8("services"), [this]()
+    {
+        mTransfersModel = new TransfersModel(nullptr);
+        connect(mTransfersModel.data(), &TransfersModel::transfersCountUpdated, this, &MegaApplication::onTransfersModelUpdate);
+    });
+    // When there is a session the local servers are started after the login, see TYPE_LOGIN
+    mStartup->addPhase(QString::fromUtf8("localServer"), StartupOrchestrator::DEFERRED,
+                       QStringList() << QString::fromUtf8("services"), [this]()
+    {
+        if (!preferences->logged())
+        {
+            initLocalServer();
+        }
+    });
+
+    mStartup->run();
+}
+
+void MegaApplication::initPreferences()
+{
     //Register own url schemes
     QDesktopServices::setUrlHandler(QString::fromUtf8("mega"), this, "handleMEGAurl");
     QDesktopServices::setUrlHandler(QString::fromUtf8("local"), this, "handleLocalPath");
@@ -470,7 +538,10 @@ void MegaApplication::initialize()
     {
         toggleLogging();
     }
+}
 
+void MegaApplication::initSdk()
+{
     QString basePath = QDir::toNativeSeparators(dataPath + QString::fromUtf8("/"));
     megaApi = new MegaApi(Preferences::CLIENT_KEY, basePath.toUtf8().constData(), Preferences::USER_AGENT);
     megaApi->disableGfxFeatures(mDisableGfx);
@@ -540,40 +611,31 @@ void MegaApplication::initialize()
             &scanStageController, &ScanStageController::startDelayedScanStage);
     connect(downloader, &MegaDownloader::folderTransferUpdated, this, &MegaApplication::onFolderTransferUpdate);
 
-    connectivityTimer = new QTimer(this);
-    connectivityTimer->setSingleShot(true);
-    connectivityTimer->setInterval(Preferences::MAX_LOGIN_TIME_MS);
-    connect(connectivityTimer, SIGNAL(timeout()), this, SLOT(runConnectivityCheck()));
-
-    proExpirityTimer.setSingleShot(true);
-    connect(&proExpirityTimer, SIGNAL(timeout()), this, SLOT(proExpirityTimedOut()));
+#ifdef __APPLE__
+    MEGA_SET_PERMISSIONS;
+#endif
+}
 
 #ifdef _WIN32
+void MegaApplication::fixInstallationPermissions()
+{
     if (isPublic && prevVersion <= 3104 && preferences->canUpdate(appPath))
     {
-        megaApi->log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Fixing permissions for other users in the computer").toUtf8().constData());
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Fixing permissions for other users in the computer").toUtf8().constData());
         QDirIterator it (appDirPath, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
         while (it.hasNext())
         {
             Platform::makePubliclyReadable((LPTSTR)QDir::toNativeSeparators(it.next()).utf16());
         }
     }
+}
 #endif
 
-#ifdef __APPLE__
-    MEGA_SET_PERMISSIONS;
-#endif
-
-    if (!preferences->isOneTimeActionDone(Preferences::ONE_TIME_ACTION_REGISTER_UPDATE_TASK))
-    {
-        bool success = Platform::registerUpdateJob();
-        if (success)
-        {
-            preferences->setOneTimeActionDone(Preferences::ONE_TIME_ACTION_REGISTER_UPDATE_TASK, true);
-        }
-    }
-
-    if (preferences->isCrashed())
+void MegaApplication::checkCrashRecovery()
+{
+    // The crash signal handler cannot write the preferences, it leaves a marker file instead
+    const bool crashMarker = CrashHandler::instance()->consumeCrashMarker();
+    if (preferences->isCrashed() || crashMarker)
     {
         MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Force reloading (isCrashed true)").toUtf8().constData());
         preferences->setCrashed(false);
@@ -631,15 +693,46 @@ void MegaApplication::initialize()
                 QMegaMessageBox::information(nullptr, QString::fromUtf8("MEGAsync"), tr("Thank you for your collaboration"));
 #endif
             }
+            else
+            {
+                // Declined reports are not offered again
+                CrashHandler::instance()->discardPendingCrashReports();
+            }
         }
     }
+}
+
+void MegaApplication::initServices()
+{
+    connectivityTimer = new QTimer(this);
+    connectivityTimer->setSingleShot(true);
+    connectivityTimer->setInterval(Preferences::MAX_LOGIN_TIME_MS);
+    connect(connectivityTimer, SIGNAL(timeout()), this, SLOT(runConnectivityCheck()));
+
+    proExpirityTimer.setSingleShot(true);
+    connect(&proExpirityTimer, SIGNAL(timeout()), this, SLOT(proExpirityTimedOut()));
 
     transferQuota = std::make_shared<TransferQuota>(mOsNotifications);
     connect(transferQuota.get(), &TransferQuota::waitTimeIsOver, this, &MegaApplication::updateStatesAfterTransferOverQuotaTimeHasExpired);
 
-    periodicTasksTimer = new QTimer(this);
-    periodicTasksTimer->start(Preferences::STATE_REFRESH_INTERVAL_MS);
-    connect(periodicTasksTimer, SIGNAL(timeout()), this, SLOT(periodicTasks()));
+    initPeriodicTasks();
+
+#ifdef Q_OS_LINUX
+    mResourceSampler = new ResourceSampler(this);
+    mResourceSampler->addProbe(QString::fromUtf8("transfer rows"), [this]()
+    {
+        return mTransfersModel ? static_cast<long long>(mTransfersModel->rowCount(QModelIndex())) : 0LL;
+    });
+    mResourceSampler->addProbe(QString::fromUtf8("alerts"), [this]()
+    {
+        return notificationsModel ? static_cast<long long>(notificationsModel->rowCount(QModelIndex())) : 0LL;
+    });
+    mResourceSampler->addProbe(QString::fromUtf8("queued log bytes"), [this]()
+    {
+        return logger ? logger->getQueuedBytes() : 0LL;
+    });
+    mResourceSampler->start();
+#endif
 
     networkCheckTimer = new QTimer(this);
     networkCheckTimer->start(Preferences::NETWORK_REFRESH_INTERVAL_MS);
@@ -694,10 +787,6 @@ void MegaApplication::initialize()
         watcher->addPath(appShowInterfacePath);
         connect(watcher, SIGNAL(fileChanged(QString)), this, SLOT(showInterface(QString)));
     }
-
-    mTransfersModel = new TransfersModel(nullptr);
-
-    connect(mTransfersModel.data(), &TransfersModel::transfersCountUpdated, this, &MegaApplication::onTransfersModelUpdate);
 }
 
 QString MegaApplication::applicationFilePath()
@@ -731,6 +820,8 @@ void MegaApplication::changeLanguage(QString languageCode)
         return;
     }
 
+    const QString previousLanguageCode = currentLanguageCode;
+
     if (!translator.load(Preferences::TRANSLATION_FOLDER
                             + Preferences::TRANSLATION_PREFIX
                             + languageCode))
@@ -745,267 +836,80 @@ void MegaApplication::changeLanguage(QString languageCode)
         currentLanguageCode = languageCode;
     }
 
-    createTrayIcon();
-}
-
-#ifdef Q_OS_LINUX
-void MegaApplication::setTrayIconFromTheme(QString icon)
-{
-    QString name = QString(icon).replace(QString::fromUtf8("://images/"), QString::fromUtf8("mega")).replace(QString::fromUtf8(".svg"),QString::fromUtf8(""));
-    const bool needsToBeUpdated{name != trayIcon->icon().name()};
-    if(needsToBeUpdated)
+    if (!previousLanguageCode.isEmpty() && previousLanguageCode != currentLanguageCode)
     {
-        trayIcon->setIcon(QIcon::fromTheme(name, QIcon(icon)));
+        Platform::notifyLanguageChange(currentLanguageCode);
     }
+
+    createTrayIcon();
 }
-#endif
 
 void MegaApplication::updateTrayIcon()
 {
-    if (appfinished || !trayIcon)
+    if (appfinished || !trayIcon || !mTrayState)
     {
         return;
     }
 
-    QString tooltipState;
-    QString icon;
-
-    static std::map<std::string, QString> icons = {
-    #ifndef __APPLE__
-        #ifdef _WIN32
-            { "warning", QString::fromUtf8("://images/warning_ico.ico") },
-            { "synching", QString::fromUtf8("://images/tray_sync.ico") },
-            { "uptodate", QString::fromUtf8("://images/app_ico.ico") },
-            { "paused", QString::fromUtf8("://images/tray_pause.ico") },
-            { "logging", QString::fromUtf8("://images/login_ico.ico") },
-            { "alert", QString::fromUtf8("://images/alert_ico.ico") },
-            { "someissues", QString::fromUtf8("://images/warning_ico.ico") }
-
-        #else
-            { "warning", QString::fromUtf8("://images/warning.svg") },
-            { "synching", QString::fromUtf8("://images/synching.svg") },
-            { "uptodate", QString::fromUtf8("://images/uptodate.svg") },
-            { "paused", QString::fromUtf8("://images/paused.svg") },
-            { "logging", QString::fromUtf8("://images/logging.svg") },
-            { "alert", QString::fromUtf8("://images/alert.svg") },
-            { "someissues", QString::fromUtf8("://images/warning.svg") }
-        #endif
-    #else
-            { "warning", QString::fromUtf8("://images/icon_overquota_mac.png") },
-            { "synching", QString::fromUtf8("://images/icon_syncing_mac.png") },
-            { "uptodate", QString::fromUtf8("://images/icon_synced_mac.png") },
-            { "paused", QString::fromUtf8("://images/icon_paused_mac.png") },
-            { "logging", QString::fromUtf8("://images/icon_logging_mac.png") },
-            { "alert", QString::fromUtf8("://images/icon_alert_mac.png") },
-            { "someissues", QString::fromUtf8("://images/icon_overquota_mac.png") }
-    #endif
-        };
+    markPeriodicTaskDirty("trayIcon");
 
     const bool isOverQuotaOrPaywall{appliedStorageState == MegaApi::STORAGE_STATE_RED ||
                 transferQuota->isOverQuota() ||
                 appliedStorageState == MegaApi::STORAGE_STATE_PAYWALL};
-    if (isOverQuotaOrPaywall)
-    {
-        tooltipState = tr("Over quota");
-
-        icon = icons["warning"];
+    mTrayState->setOverQuota(isOverQuotaOrPaywall);
+    mTrayState->setBlocked(blockState);
 
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
-    }
-    else if (blockState)
+    int disabledSyncs = TrayStateMachine::NO_DISABLED_SYNCS;
+    if (model->hasUnattendedDisabledSyncs(MegaSync::TYPE_TWOWAY))
     {
-        tooltipState = tr("Locked account");
-
-        icon = icons["alert"];
-
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
+        disabledSyncs |= TrayStateMachine::DISABLED_SYNCS;
     }
-    else if (model->hasUnattendedDisabledSyncs({MegaSync::TYPE_TWOWAY, MegaSync::TYPE_BACKUP}))
+    if (model->hasUnattendedDisabledSyncs(MegaSync::TYPE_BACKUP))
     {
-        if (model->hasUnattendedDisabledSyncs(MegaSync::TYPE_TWOWAY)
-            && model->hasUnattendedDisabledSyncs(MegaSync::TYPE_BACKUP))
-        {
-            tooltipState = tr("Some syncs and backups have been disabled");
-        }
-        else if (model->hasUnattendedDisabledSyncs(MegaSync::TYPE_BACKUP))
-        {
-            tooltipState = tr("One or more backups have been disabled");
-        }
-        else
-        {
-            tooltipState = tr("One or more syncs have been disabled");
-        }
-
-        icon = icons["alert"];
-
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
-
+        disabledSyncs |= TrayStateMachine::DISABLED_BACKUPS;
     }
-    else if (!megaApi->isLoggedIn())
-    {
-        if (!infoDialog)
-        {
-            tooltipState = tr("Logging in");
-            icon = icons["synching"];
-    #ifdef __APPLE__
-            if (!scanningTimer->isActive())
-            {
-                scanningAnimationIndex = 1;
-                scanningTimer->start();
-            }
-    #endif
-        }
-        else
-        {
-            tooltipState = tr("You are not logged in");
-            icon = icons["uptodate"];
+    mTrayState->setDisabledSyncs(disabledSyncs);
 
-    #ifdef __APPLE__
-            if (scanningTimer->isActive())
-            {
-                scanningTimer->stop();
-            }
-    #endif
-        }
+    if (!megaApi->isLoggedIn())
+    {
+        mTrayState->setSession(infoDialog ? TrayStateMachine::Session::LOGGED_OUT
+                                          : TrayStateMachine::Session::LOGGING_IN);
     }
     else if (!nodescurrent || !getRootNode())
     {
-        tooltipState = tr("Fetching file list...");
-        icon = icons["synching"];
-
-#ifdef __APPLE__
-        if (!scanningTimer->isActive())
-        {
-            scanningAnimationIndex = 1;
-            scanningTimer->start();
-        }
-#endif
+        mTrayState->setSession(TrayStateMachine::Session::FETCHING_NODES);
     }
-    else if (paused)
+    else
     {
-        long long transfersFailed(mTransfersModel ? mTransfersModel->failedTransfers() : 0);
-
-        if(transfersFailed > 0)
-        {
-            tooltipState = QCoreApplication::translate("TransferManager","Issue found", "", transfersFailed);
-            icon = icons["someissues"];
-        }
-        else
-        {
-            tooltipState = tr("Paused");
-            icon = icons["paused"];
-        }
-
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
+        mTrayState->setSession(TrayStateMachine::Session::READY);
     }
-    else if (indexing || waiting || syncing || transferring)
-    {
-        if (indexing)
-        {
-            tooltipState = tr("Scanning");
-        }
-        else if (syncing)
-        {
-            tooltipState = tr("Syncing");
-        }
-        else if (waiting)
-        {
-            tooltipState = tr("Waiting");
-        }
-        else
-        {
-            tooltipState = tr("Transferring");
-        }
-
-        icon = icons["synching"];
 
-#ifdef __APPLE__
-        if (!scanningTimer->isActive())
-        {
-            scanningAnimationIndex = 1;
-            scanningTimer->start();
-        }
-#endif
-    }
-    else
+    TrayStateMachine::Activity activity = TrayStateMachine::Activity::NONE;
+    if (indexing)
     {
-        long long transfersFailed(mTransfersModel ? mTransfersModel->failedTransfers() : 0);
-
-        if(transfersFailed > 0)
-        {
-            tooltipState = QCoreApplication::translate("TransferManager","Issue found", "", transfersFailed);
-            icon = icons["someissues"];
-        }
-        else
-        {
-            tooltipState = tr("Up to date");
-            icon = icons["uptodate"];
-        }
-
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
-        if (reboot)
-        {
-            rebootApplication();
-        }
+        activity = TrayStateMachine::Activity::INDEXING;
     }
-
-    if (!networkConnectivity)
+    else if (syncing)
     {
-        //Override the current state
-        tooltipState = tr("No Internet connection");
-        icon = icons["logging"];
+        activity = TrayStateMachine::Activity::SYNCING;
     }
-
-    QString tooltip = QString::fromUtf8("%1 %2\n%3").arg(QCoreApplication::applicationName()).arg(Preferences::VERSION_STRING).arg(tooltipState);
-
-    if (updateAvailable)
+    else if (waiting)
     {
-        tooltip += QString::fromUtf8("\n") + tr("Update available!");
+        activity = TrayStateMachine::Activity::WAITING;
     }
-
-    if (!icon.isEmpty())
+    else if (transferring)
     {
-#ifndef __APPLE__
-    #ifdef _WIN32
-        trayIcon->setIcon(QIcon(icon));
-    #else
-        setTrayIconFromTheme(icon);
-    #endif
-#else
-    QIcon ic = QIcon(icon);
-    ic.setIsMask(true);
-    trayIcon->setIcon(ic);
-#endif
+        activity = TrayStateMachine::Activity::TRANSFERRING;
     }
+    mTrayState->setActivity(activity);
+    mTrayState->setPaused(paused);
+    mTrayState->setFailedTransfers(mTransfersModel ? mTransfersModel->failedTransfers() : 0);
+    mTrayState->setConnected(networkConnectivity);
+    mTrayState->setUpdateAvailable(updateAvailable);
 
-    if (!tooltip.isEmpty())
+    if (reboot && mTrayState->isIdle())
     {
-        trayIcon->setToolTip(tooltip);
+        rebootApplication();
     }
 }
 
@@ -1060,24 +964,7 @@ void MegaApplication::start()
     if (notificationsDelegate) notificationsDelegate->deleteLater();
     notificationsDelegate = NULL;
 
-#ifndef __APPLE__
-    #ifdef _WIN32
-        trayIcon->setIcon(QIcon(QString::fromUtf8("://images/tray_sync.ico")));
-    #else
-        setTrayIconFromTheme(QString::fromUtf8("://images/synching.svg"));
-    #endif
-#else
-    QIcon ic = QIcon(QString::fromUtf8("://images/icon_syncing_mac.png"));
-    ic.setIsMask(true);
-    trayIcon->setIcon(ic);
-
-    if (!scanningTimer->isActive())
-    {
-        scanningAnimationIndex = 1;
-        scanningTimer->start();
-    }
-#endif
-    trayIcon->setToolTip(QCoreApplication::applicationName() + QString::fromUtf8(" ") + Preferences::VERSION_STRING + QString::fromUtf8("\n") + tr("Logging in"));
+    mTrayState->setSession(TrayStateMachine::Session::LOGGING_IN);
     trayIcon->show();
 
     if (!preferences->lastExecutionTime())
@@ -1130,7 +1017,11 @@ void MegaApplication::start()
         QString language = preferences->language();
         changeLanguage(language);
 
-        initLocalServer();
+        // The first time it is done by the localServer startup phase, once the event loop runs
+        if (mStartup->isDone(QString::fromUtf8("localServer")))
+        {
+            initLocalServer();
+        }
         if (updated)
         {
             megaApi->sendEvent(AppStatsEvents::EVENT_UPDATE, "MEGAsync update");
@@ -1280,6 +1171,9 @@ void MegaApplication::loggedIn(bool fromWizard)
         crashReportFilePath.clear();
     }
 
+    // Start watching the debris folders, so their sizes are known when the settings are opened
+    DebrisSizeAccountant::instance();
+
     mSyncController.reset(new SyncController());
     connect(mSyncController.get(), &SyncController::syncAddStatus, this, [](const int errorCode, const QString errorMsg, QString name)
     {
@@ -1956,6 +1850,21 @@ void MegaApplication::checkMemoryUsage()
         {
             return;
         }
+    #elif defined(Q_OS_LINUX)
+        ResourceSampler::Sample sample;
+        if (!mResourceSampler || !mResourceSampler->getLatestSample(sample))
+        {
+            return;
+        }
+        procesUsage = sample.rss;
+    #else
+        // Peak resident set size, in kilobytes
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage))
+        {
+            return;
+        }
+        procesUsage = static_cast<long long>(usage.ru_maxrss) * 1024;
     #endif
 #endif
 
@@ -2134,79 +2043,176 @@ void MegaApplication::checkOverQuotaStates()
     transferQuota->checkQuotaAndAlerts();
 }
 
-void MegaApplication::periodicTasks()
+void MegaApplication::initPeriodicTasks()
 {
-    if (appfinished)
-    {
-        return;
-    }
+    mTaskScheduler = new TaskScheduler(this);
 
-    if (!cleaningSchedulerExecution || ((QDateTime::currentMSecsSinceEpoch() - cleaningSchedulerExecution) > Preferences::MIN_UPDATE_CLEANING_INTERVAL_MS))
+    TaskScheduler::Task cleanCaches;
+    cleanCaches.name = QString::fromUtf8("cleanLocalCaches");
+    cleanCaches.periodMs = static_cast<int>(Preferences::MIN_UPDATE_CLEANING_INTERVAL_MS);
+    cleanCaches.jitterMs = 60000;
+    cleanCaches.budgetMs = 500;
+    cleanCaches.firstRunMs = Preferences::STATE_REFRESH_INTERVAL_MS;
+    cleanCaches.run = [this]()
     {
-        cleaningSchedulerExecution = QDateTime::currentMSecsSinceEpoch();
         MegaApi::log(MegaApi::LOG_LEVEL_INFO, "Cleaning local cache folders");
         cleanLocalCaches();
-    }
+    };
+    mTaskScheduler->addTask(cleanCaches);
 
-    if (queuedUserStats[0] || queuedUserStats[1] || queuedUserStats[2])
+    // Marked dirty when an update of the user stats is throttled
+    TaskScheduler::Task userStats;
+    userStats.name = QString::fromUtf8("userStats");
+    userStats.periodMs = Preferences::STATE_REFRESH_INTERVAL_MS;
+    userStats.jitterMs = 1000;
+    userStats.onlyWhenDirty = true;
+    userStats.run = [this]()
     {
-        bool storage = queuedUserStats[0], transfer = queuedUserStats[1], pro = queuedUserStats[2];
-        queuedUserStats[0] = queuedUserStats[1] = queuedUserStats[2] = false;
-        updateUserStats(storage, transfer, pro, false, -1);
-    }
-
-    initLocalServer();
+        if (queuedUserStats[0] || queuedUserStats[1] || queuedUserStats[2])
+        {
+            bool storage = queuedUserStats[0], transfer = queuedUserStats[1], pro = queuedUserStats[2];
+            queuedUserStats[0] = queuedUserStats[1] = queuedUserStats[2] = false;
+            updateUserStats(storage, transfer, pro, false, -1);
+        }
+    };
+    mTaskScheduler->addTask(userStats);
 
-    static int counter = 0;
-    counter++;
-    if (megaApi)
+    // Short period, so that a server that could not be started is retried soon
+    TaskScheduler::Task localServer;
+    localServer.name = QString::fromUtf8("localServer");
+    localServer.periodMs = Preferences::STATE_REFRESH_INTERVAL_MS;
+    localServer.jitterMs = 1000;
+    localServer.firstRunMs = Preferences::STATE_REFRESH_INTERVAL_MS;
+    localServer.run = [this]()
     {
-        if (!(counter % 6))
-        {
-            HTTPServer::checkAndPurgeRequests();
+        initLocalServer();
+    };
+    mTaskScheduler->addTask(localServer);
 
-            if (checkupdate)
-            {
-                checkupdate = false;
-                megaApi->sendEvent(AppStatsEvents::EVENT_UPDATE_OK, "MEGAsync updated OK");
-            }
+    TaskScheduler::Task purgeRequests;
+    purgeRequests.name = QString::fromUtf8("purgeHttpRequests");
+    purgeRequests.periodMs = 6 * Preferences::STATE_REFRESH_INTERVAL_MS;
+    purgeRequests.jitterMs = 5000;
+    purgeRequests.run = []()
+    {
+        HTTPServer::checkAndPurgeRequests();
+    };
+    mTaskScheduler->addTask(purgeRequests);
 
-            checkMemoryUsage();
-            mThreadPool->push([=]()
-            {//thread pool function
-                megaApi->update();
+    TaskScheduler::Task memoryUsage;
+    memoryUsage.name = QString::fromUtf8("memoryUsage");
+    memoryUsage.periodMs = 6 * Preferences::STATE_REFRESH_INTERVAL_MS;
+    memoryUsage.jitterMs = 5000;
+    memoryUsage.run = [this]()
+    {
+        checkMemoryUsage();
+    };
+    mTaskScheduler->addTask(memoryUsage);
 
-                Utilities::queueFunctionInAppThread([=]()
-                {//queued function
-                    checkOverStorageStates();
-                    checkOverQuotaStates();
-                });//end of queued function
+    TaskScheduler::Task sdkUpdate;
+    sdkUpdate.name = QString::fromUtf8("sdkUpdate");
+    sdkUpdate.periodMs = 6 * Preferences::STATE_REFRESH_INTERVAL_MS;
+    sdkUpdate.jitterMs = 5000;
+    sdkUpdate.run = [this]()
+    {
+        if (!megaApi)
+        {
+            return;
+        }
 
-            });// end of thread pool function
+        if (checkupdate)
+        {
+            checkupdate = false;
+            megaApi->sendEvent(AppStatsEvents::EVENT_UPDATE_OK, "MEGAsync updated OK");
         }
 
-        onGlobalSyncStateChanged(megaApi);
+        mThreadPool->push([=]()
+        {//thread pool function
+            megaApi->update();
 
-        if (isLinux)
+            Utilities::queueFunctionInAppThread([=]()
+            {//queued function
+                checkOverStorageStates();
+                checkOverQuotaStates();
+            });//end of queued function
+
+        });// end of thread pool function
+    };
+    mTaskScheduler->addTask(sdkUpdate);
+
+    // The SDK notifies the changes of the sync states, this only catches the ones missed.
+    // Marked dirty by the transfer and sync events, so it does not run while idle
+    TaskScheduler::Task globalSyncState;
+    globalSyncState.name = QString::fromUtf8("globalSyncState");
+    globalSyncState.periodMs = Preferences::STATE_REFRESH_INTERVAL_MS;
+    globalSyncState.jitterMs = 1000;
+    globalSyncState.onlyWhenDirty = true;
+    globalSyncState.run = [this]()
+    {
+        if (megaApi)
         {
-            updateTrayIcon();
+            onGlobalSyncStateChanged(megaApi);
         }
+    };
+    mTaskScheduler->addTask(globalSyncState);
 
-        if (isLinux && blockState && !(counter%10))
+#ifdef Q_OS_LINUX
+    TaskScheduler::Task blockedState;
+    blockedState.name = QString::fromUtf8("whyAmIBlocked");
+    blockedState.periodMs = 10 * Preferences::STATE_REFRESH_INTERVAL_MS;
+    blockedState.jitterMs = 5000;
+    blockedState.run = [this]()
+    {
+        if (megaApi && blockState)
         {
             whyAmIBlocked(true);
         }
-    }
+    };
+    mTaskScheduler->addTask(blockedState);
+#endif
 
-    if (trayIcon)
+    // Marked dirty when the tray icon or the displays change
+    TaskScheduler::Task tray;
+    tray.name = QString::fromUtf8("trayIcon");
+    tray.periodMs = Preferences::STATE_REFRESH_INTERVAL_MS;
+    tray.jitterMs = 1000;
+    tray.onlyWhenDirty = true;
+    tray.run = [this]()
     {
-#ifdef Q_OS_LINUX
-        if (counter==4 && getenv("XDG_CURRENT_DESKTOP") && !strcmp(getenv("XDG_CURRENT_DESKTOP"),"XFCE"))
+        if (trayIcon)
         {
-            trayIcon->hide();
+            trayIcon->show();
         }
+    };
+    mTaskScheduler->addTask(tray);
+
+#ifdef Q_OS_LINUX
+    if (getenv("XDG_CURRENT_DESKTOP") && !strcmp(getenv("XDG_CURRENT_DESKTOP"), "XFCE"))
+    {
+        TaskScheduler::Task xfceTray;
+        xfceTray.name = QString::fromUtf8("xfceTrayIcon");
+        xfceTray.periodMs = -1;
+        xfceTray.firstRunMs = 4 * Preferences::STATE_REFRESH_INTERVAL_MS;
+        xfceTray.run = [this]()
+        {
+            if (trayIcon)
+            {
+                trayIcon->hide();
+                trayIcon->show();
+            }
+        };
+        mTaskScheduler->addTask(xfceTray);
+    }
 #endif
-        trayIcon->show();
+
+    mTaskScheduler->start();
+}
+
+void MegaApplication::markPeriodicTaskDirty(const char* name)
+{
+    if (mTaskScheduler)
+    {
+        mTaskScheduler->markDirty(QString::fromUtf8(name));
     }
 }
 
@@ -2227,7 +2233,15 @@ void MegaApplication::cleanAll()
     qInstallMessageHandler(0);
 #endif
 
-    periodicTasksTimer->stop();
+    mTaskScheduler->stop();
+    mStartup->waitForBackgroundPhases();
+    stopTracing();
+#ifdef Q_OS_LINUX
+    if (mResourceSampler)
+    {
+        mResourceSampler->stop();
+    }
+#endif
     networkCheckTimer->stop();
     stopUpdateTask();
     Platform::stopShellDispatcher();
@@ -2712,6 +2726,13 @@ void MegaApplication::initLocalServer()
     }
 }
 
+bool MegaApplication::notify(QObject *receiver, QEvent *event)
+{
+    // Only the events long enough to be noticed, the rest would fill the trace buffer
+    TraceSpan span("QApplication::notify", "eventloop", 1000, event->type());
+    return QApplication::notify(receiver, event);
+}
+
 bool MegaApplication::eventFilter(QObject *obj, QEvent *e)
 {
     if (!appfinished && obj == infoDialogMenu)
@@ -2839,23 +2860,6 @@ void MegaApplication::triggerInstallUpdate()
     emit installUpdate();
 }
 
-void MegaApplication::scanningAnimationStep()
-{
-    if (appfinished)
-    {
-        return;
-    }
-
-    scanningAnimationIndex = scanningAnimationIndex%4;
-    scanningAnimationIndex++;
-    QIcon ic = QIcon(QString::fromUtf8("://images/icon_syncing_mac") +
-                     QString::number(scanningAnimationIndex) + QString::fromUtf8(".png"));
-#ifdef __APPLE__
-    ic.setIsMask(true);
-#endif
-    trayIcon->setIcon(ic);
-}
-
 void MegaApplication::runConnectivityCheck()
 {
     if (appfinished)
@@ -3521,7 +3525,8 @@ void MegaApplication::logInfoDialogCoordinates(const char *message, const QRect
 
 bool MegaApplication::dontAskForExitConfirmation(bool force)
 {
-    return force || !megaApi->isLoggedIn() || mTransfersModel->hasActiveTransfers() == 0;
+    return force || !megaApi->isLoggedIn() || !mTransfersModel
+           || mTransfersModel->hasActiveTransfers() == 0;
 }
 
 void MegaApplication::exitApplication()
@@ -3749,31 +3754,38 @@ void MegaApplication::cleanLocalCaches(bool all)
     if (all || preferences->cleanerDaysLimit())
     {
         int timeLimitDays = preferences->cleanerDaysLimitValue();
-        for (auto syncPath : model->getLocalFolders(SyncInfo::AllHandledSyncTypes))
+        QStringList syncPaths = model->getLocalFolders(SyncInfo::AllHandledSyncTypes);
+
+        // Listing and removing the debris folders can take long, keep it out of the GUI thread
+        ThreadPoolSingleton::getInstance()->push([syncPaths, timeLimitDays, all]()
         {
-            if (!syncPath.isEmpty())
+            auto walker (DirectoryWalker::instance());
+            qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+            for (const auto& syncPath : syncPaths)
             {
-                QDir cacheDir(syncPath + QDir::separator() + QString::fromUtf8(MEGA_DEBRIS_FOLDER));
-                if (cacheDir.exists())
+                if (syncPath.isEmpty())
                 {
-                    QFileInfoList dailyCaches = cacheDir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot);
-                    for (int i = 0; i < dailyCaches.size(); i++)
+                    continue;
+                }
+
+                QString cachePath (syncPath + QDir::separator() + QString::fromUtf8(MEGA_DEBRIS_FOLDER));
+                for (const auto& cacheFolder : walker->listEntries(cachePath))
+                {
+                    if (!cacheFolder.name.compare(QString::fromUtf8("tmp"))) //DO NOT REMOVE tmp subfolder
                     {
-                        QFileInfo cacheFolder = dailyCaches[i];
-                        if (!cacheFolder.fileName().compare(QString::fromUtf8("tmp"))) //DO NOT REMOVE tmp subfolder
-                        {
-                            continue;
-                        }
+                        continue;
+                    }
 
-                        QDateTime creationTime(cacheFolder.created());
-                        if (all || (creationTime.isValid() && creationTime.daysTo(QDateTime::currentDateTime()) > timeLimitDays) )
-                        {
-                            Utilities::removeRecursively(cacheFolder.canonicalFilePath());
-                        }
+                    if (all || (cacheFolder.creationTime > 0 && (now - cacheFolder.creationTime) / 86400 > timeLimitDays))
+                    {
+                        QString cacheFolderPath (cachePath + QDir::separator() + cacheFolder.name);
+                        Utilities::removeRecursively(QFileInfo(cacheFolderPath).canonicalFilePath());
+                        walker->invalidate(cacheFolderPath);
                     }
                 }
             }
-        }
+            walker->saveListingCache();
+        });
     }
 }
 
@@ -4609,6 +4621,7 @@ void MegaApplication::updateUserStats(bool storage, bool transfer, bool pro, boo
         if (storage)  queuedUserStats[0] = true;
         if (transfer) queuedUserStats[1] = true;
         if (pro)      queuedUserStats[2] = true;
+        markPeriodicTaskDirty("userStats");
     }
 }
 
@@ -4731,12 +4744,14 @@ void MegaApplication::toggleLogging()
     {
         Preferences::HTTPS_ORIGIN_CHECK_ENABLED = true;
         logger->setDebug(false);
+        stopTracing();
         showInfoMessage(tr("DEBUG mode disabled"));
     }
     else
     {
         Preferences::HTTPS_ORIGIN_CHECK_ENABLED = false;
         logger->setDebug(true);
+        startTracing();
         showInfoMessage(tr("DEBUG mode enabled. A log is being created in your desktop (MEGAsync.log)"));
         if (megaApi)
         {
@@ -4746,6 +4761,32 @@ void MegaApplication::toggleLogging()
     }
 }
 
+void MegaApplication::startTracing()
+{
+    QString fileName = QString::fromUtf8("MEGAsync-trace-%1.json")
+            .arg(QDateTime::currentDateTime().toString(QString::fromUtf8("yyyyMMdd-hhmmss")));
+    Tracer::start(QDir(dataPath).filePath(LOGS_FOLDER_LEAFNAME_QSTRING + QString::fromUtf8("/") + fileName));
+}
+
+void MegaApplication::stopTracing()
+{
+    if (!Tracer::isEnabled())
+    {
+        return;
+    }
+
+    if (Tracer::stop())
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Trace written to %1")
+                     .arg(Tracer::getFilePath()).toUtf8().constData());
+    }
+    else
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Unable to write the trace to %1")
+                     .arg(Tracer::getFilePath()).toUtf8().constData());
+    }
+}
+
 void MegaApplication::removeFinishedTransfer(int transferTag)
 {
     QMap<int, MegaTransfer*>::iterator it = finishedTransfers.find(transferTag);
@@ -5244,6 +5285,8 @@ void MegaApplication::changeDisplay(QScreen*)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("DISPLAY CHANGED").toUtf8().constData());
 
+    markPeriodicTaskDirty("trayIcon");
+
     if (infoDialog)
     {
         infoDialog->setWindowFlags(Qt::FramelessWindowHint);
@@ -5310,46 +5353,16 @@ void MegaApplication::createTrayIcon()
         connect(trayIcon, SIGNAL(activated(QSystemTrayIcon::ActivationReason)),
                 this, SLOT(trayIconActivated(QSystemTrayIcon::ActivationReason)));
 
-    #ifdef __APPLE__
-        scanningTimer = new QTimer();
-        scanningTimer->setSingleShot(false);
-        scanningTimer->setInterval(500);
-        scanningAnimationIndex = 1;
-        connect(scanningTimer, SIGNAL(timeout()), this, SLOT(scanningAnimationStep()));
-    #endif
+        // Owned by the tray icon, so that it is gone with it
+        mTrayState = new TrayStateMachine(trayIcon, trayIcon);
     }
-
-    updateTrayIconMenu();
-
-    if (isLinux)
+    else
     {
-        return;
+        // Texts may have been translated again
+        mTrayState->refresh();
     }
 
-
-    trayIcon->setToolTip(QCoreApplication::applicationName()
-                     + QString::fromUtf8(" ")
-                     + Preferences::VERSION_STRING
-                     + QString::fromUtf8("\n")
-                     + tr("Starting"));
-
-#ifndef __APPLE__
-    #ifdef _WIN32
-        trayIcon->setIcon(QIcon(QString::fromUtf8("://images/tray_sync.ico")));
-    #else
-        setTrayIconFromTheme(QString::fromUtf8("://images/synching.svg"));
-    #endif
-#else
-    QIcon ic = QIcon(QString::fromUtf8("://images/icon_syncing_mac.png"));
-    ic.setIsMask(true);
-    trayIcon->setIcon(ic);
-
-    if (!scanningTimer->isActive())
-    {
-        scanningAnimationIndex = 1;
-        scanningTimer->start();
-    }
-#endif
+    updateTrayIconMenu();
 }
 
 void MegaApplication::processUploads()
@@ -7208,7 +7221,10 @@ void MegaApplication::onRequestFinish(MegaApi*, MegaRequest *request, MegaError*
 
                      closeDialogs();
                      start();
-                     periodicTasks();
+                     mTaskScheduler->runNow(QString::fromUtf8("userStats"));
+                     mTaskScheduler->runNow(QString::fromUtf8("localServer"));
+                     mTaskScheduler->runNow(QString::fromUtf8("globalSyncState"));
+                     mTaskScheduler->runNow(QString::fromUtf8("trayIcon"));
                  }
              });
         });
@@ -7729,6 +7745,7 @@ void MegaApplication::onTransferStart(MegaApi *api, MegaTransfer *transfer)
     }
 
     DeferPreferencesSyncForScope deferrer(this);
+    markPeriodicTaskDirty("globalSyncState");
 
     if (transfer->getType() == MegaTransfer::TYPE_DOWNLOAD)
     {
@@ -7753,6 +7770,7 @@ void MegaApplication::onTransferFinish(MegaApi* , MegaTransfer *transfer, MegaEr
     }
 
     DeferPreferencesSyncForScope deferrer(this);
+    markPeriodicTaskDirty("globalSyncState");
 
     // check if it's a top level transfer
     int folderTransferTag = transfer->getFolderTransferTag();
@@ -8189,7 +8207,28 @@ void MegaApplication::onUsersUpdate(MegaApi *, MegaUserList *userList)
 //Called when nodes have been updated in MEGA
 void MegaApplication::onNodesUpdate(MegaApi* , MegaNodeList *nodes)
 {
-    if (appfinished || !infoDialog || !nodes || !preferences->logged())
+    if (appfinished || !nodes)
+    {
+        return;
+    }
+
+    SyncInfo::instance()->onNodesUpdate(nodes);
+
+    // The transfers model keeps what it resolved about these nodes even while there is no dialog
+    for (int i = 0; i < nodes->size(); i++)
+    {
+        MegaNode *node = nodes->get(i);
+        if (node->getChanges() & MegaNode::CHANGE_TYPE_PUBLIC_LINK)
+        {
+            emit nodePublicLinkChanged(node->getHandle());
+        }
+        if (node->getChanges() & MegaNode::CHANGE_TYPE_REMOVED)
+        {
+            emit nodeRemoved(node->getHandle());
+        }
+    }
+
+    if (!infoDialog || !preferences->logged())
     {
         return;
     }
@@ -8212,6 +8251,10 @@ void MegaApplication::onNodesUpdate(MegaApi* , MegaNodeList *nodes)
         {
             emit nodeAttributesChanged(node->getHandle());
         }
+        if (node->getChanges() & (MegaNode::CHANGE_TYPE_INSHARE | MegaNode::CHANGE_TYPE_OUTSHARE))
+        {
+            emit nodeSharesChanged(node->getHandle());
+        }
     }
 }
 
@@ -8331,6 +8374,8 @@ void MegaApplication::onSyncFileStateChanged(MegaApi *, MegaSync *, string *loca
         return;
     }
 
+    markPeriodicTaskDirty("globalSyncState");
+
 #ifdef _WIN32
     if (!mShellNotifier)
     {
@@ -34,6 +34,9 @@
 #include "control/UpdateTask.h"
 #include "control/MegaSyncLogger.h"
 #include "control/ThreadPool.h"
+#include "control/TaskScheduler.h"
+#include "control/StartupOrchestrator.h"
+#include "control/Tracer.h"
 #include "control/Utilities.h"
 #include "syncs/control/SyncInfo.h"
 #include "syncs/control/SyncController.h"
@@ -47,9 +50,14 @@
 #include "TransferQuota.h"
 #include "DialogGeometryRetainer.h"
 #include "BlockingStageProgressController.h"
+#include "gui/TrayStateMachine.h"
 
 class TransfersModel;
 
+#ifdef Q_OS_LINUX
+    #include "platform/linux/ResourceSampler.h"
+#endif
+
 #ifdef __APPLE__
     #include "gui/MegaSystemTrayIcon.h"
     #include <mach/mach.h>
@@ -85,10 +93,6 @@ class MegaApplication : public QApplication, public mega::MegaListener, public S
 {
     Q_OBJECT
 
-#ifdef Q_OS_LINUX
-    void setTrayIconFromTheme(QString icon);
-#endif
-
     static void loadDataPath();
 
 public:
@@ -189,6 +193,7 @@ public:
     SetupWizard *getSetupWizard() const;
 
     TransfersModel* getTransfersModel(){return mTransfersModel;}
+    StartupOrchestrator* getStartupOrchestrator() const {return mStartup;}
 
     /**
      * @brief migrates sync configuration and fetches nodes
@@ -228,6 +233,9 @@ signals:
     void unblocked();
     void nodeMoved(mega::MegaHandle handle);
     void nodeAttributesChanged(mega::MegaHandle handle);
+    void nodeSharesChanged(mega::MegaHandle handle);
+    void nodePublicLinkChanged(mega::MegaHandle handle);
+    void nodeRemoved(mega::MegaHandle handle);
     void blocked();
     void storageStateChanged(int);
     void pauseStateChanged();
@@ -285,7 +293,6 @@ public slots:
     void checkMemoryUsage();
     void checkOverStorageStates();
     void checkOverQuotaStates();
-    void periodicTasks();
     void cleanAll();
     void onDupplicateLink(QString link, QString name, mega::MegaHandle handle);
     void onInstallUpdateClicked();
@@ -293,7 +300,6 @@ public slots:
     void showInfoDialog();
     void showInfoDialogNotifications();
     void triggerInstallUpdate();
-    void scanningAnimationStep();
     void setupWizardFinished(int result);
     void storageOverquotaDialogFinished(int result);
     void infoWizardDialogFinished(int result);
@@ -362,6 +368,18 @@ protected:
     void startHttpServer();
     void startHttpsServer();
     void initLocalServer();
+    void initPeriodicTasks();
+    void markPeriodicTaskDirty(const char* name);
+    void initPreferences();
+    void initSdk();
+#ifdef _WIN32
+    void fixInstallationPermissions();
+#endif
+    void checkCrashRecovery();
+    void initServices();
+    // The trace is recorded while the debug mode is enabled
+    void startTracing();
+    void stopTracing();
     void refreshStorageUIs();
     void manageBusinessStatus(int64_t event);
     void requestUserData(); //groups user attributes retrieving, getting PSA, ... to be retrieved after login in
@@ -369,9 +387,11 @@ protected:
     std::vector<std::unique_ptr<mega::MegaEvent>> eventsPendingLoggedIn;
 
     bool eventFilter(QObject *obj, QEvent *e) override;
+    bool notify(QObject *receiver, QEvent *event) override;
     void createInfoDialog();
 
     QSystemTrayIcon *trayIcon;
+    QPointer<TrayStateMachine> mTrayState;
 
     QAction *guestSettingsAction;
     QAction *initialExitAction;
@@ -413,15 +433,10 @@ protected:
     MenuItemAction *updateActionGuest;
     MenuItemAction* lastHovered;
 
-#ifdef __APPLE__
-    QTimer *scanningTimer;
-#endif
-
     QTimer *connectivityTimer;
     std::unique_ptr<QTimer> onGlobalSyncStateChangedTimer;
     std::unique_ptr<QTimer> onDeferredPreferencesSyncTimer;
     QTimer proExpirityTimer;
-    int scanningAnimationIndex;
     SetupWizard *setupWizard;
     SettingsDialog *settingsDialog;
     QPointer<InfoDialog> infoDialog;
@@ -462,7 +477,6 @@ protected:
     int queuedStorageUserStatsReason;
     long long userStatsLastRequest[3];
     bool inflightUserStats[3];
-    long long cleaningSchedulerExecution;
     long long lastUserActivityExecution;
     long long lastTsBusinessWarning;
     long long lastTsErrorMessageShown;
@@ -480,7 +494,11 @@ protected:
     mega::QTMegaListener *delegateListener;
     MegaUploader *uploader;
     MegaDownloader *downloader;
-    QTimer *periodicTasksTimer;
+    TaskScheduler* mTaskScheduler;
+    StartupOrchestrator* mStartup;
+#ifdef Q_OS_LINUX
+    ResourceSampler* mResourceSampler;
+#endif
     QTimer *networkCheckTimer;
     QTimer *infoDialogTimer;
     QTimer *firstTransferTimer;
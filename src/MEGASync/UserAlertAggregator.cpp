@@ -0,0 +1,171 @@
+#include "UserAlertAggregator.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <cmath>
+
+const qint64 UserAlertAggregator::WINDOW_MS;
+const qint64 UserAlertAggregator::MAX_DELAY_MS;
+const int UserAlertAggregator::BURST;
+const qint64 UserAlertAggregator::REFILL_MS;
+
+uint qHash(const UserAlertAggregator::Key& key, uint seed)
+{
+    return qHash(key.email, seed) ^ qHash(key.node, seed) ^ static_cast<uint>(key.type);
+}
+
+UserAlertAggregator::UserAlertAggregator(QObject* parent)
+    : QObject(parent)
+{
+    mTimer.setSingleShot(true);
+    connect(&mTimer, &QTimer::timeout, this, &UserAlertAggregator::onTimeout);
+}
+
+void UserAlertAggregator::addUserAlert(mega::MegaUserAlert* alert, int type, const QString& email,
+                                       mega::MegaHandle node, long long items)
+{
+    Summary summary;
+    summary.type = type;
+    summary.email = email;
+    summary.node = node;
+    summary.alerts = 1;
+    summary.items = items;
+    summary.alert.reset(alert->copy());
+
+    add(QDateTime::currentMSecsSinceEpoch(), summary);
+    schedule();
+}
+
+void UserAlertAggregator::add(qint64 now, const Summary& alert)
+{
+    Group& group = mGroups[Key{alert.type, alert.email, alert.node}];
+    if (!group.summary.alerts)
+    {
+        group.summary.type = alert.type;
+        group.summary.email = alert.email;
+        group.summary.node = alert.node;
+        group.firstAlert = now;
+    }
+
+    group.summary.alerts += alert.alerts;
+    group.summary.items += alert.items;
+    if (alert.alert)
+    {
+        group.summary.alert = alert.alert;
+    }
+    group.lastAlert = now;
+}
+
+QVector<UserAlertAggregator::Summary> UserAlertAggregator::takeReady(qint64 now)
+{
+    // Oldest groups get the tokens first
+    QVector<Key> ready;
+    for (auto it = mGroups.constBegin(); it != mGroups.constEnd(); ++it)
+    {
+        if (windowEnd(it.value()) <= now)
+        {
+            ready.append(it.key());
+        }
+    }
+    std::sort(ready.begin(), ready.end(), [this](const Key& a, const Key& b)
+    {
+        return mGroups.value(a).firstAlert < mGroups.value(b).firstAlert;
+    });
+
+    QVector<Summary> summaries;
+    for (const Key& key : ready)
+    {
+        TokenBucket& bucket = refill(key.email, now);
+        if (bucket.tokens >= 1.0)
+        {
+            bucket.tokens -= 1.0;
+            summaries.append(mGroups.take(key).summary);
+        }
+    }
+
+    // Buckets that are full again are the same as the ones of unknown users
+    for (auto it = mBuckets.begin(); it != mBuckets.end();)
+    {
+        if (it->tokens + static_cast<double>(now - it->lastRefill) / REFILL_MS >= BURST)
+        {
+            it = mBuckets.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return summaries;
+}
+
+qint64 UserAlertAggregator::nextRelease(qint64 now) const
+{
+    qint64 next = -1;
+    for (auto it = mGroups.constBegin(); it != mGroups.constEnd(); ++it)
+    {
+        qint64 release = std::max(windowEnd(it.value()), tokenAvailableAt(it.key().email, now));
+        if (next < 0 || release < next)
+        {
+            next = release;
+        }
+    }
+    return next;
+}
+
+void UserAlertAggregator::onTimeout()
+{
+    const auto summaries = takeReady(QDateTime::currentMSecsSinceEpoch());
+    for (const Summary& summary : summaries)
+    {
+        emit summaryReady(summary);
+    }
+    schedule();
+}
+
+UserAlertAggregator::TokenBucket& UserAlertAggregator::refill(const QString& email, qint64 now)
+{
+    auto it = mBuckets.find(email);
+    if (it == mBuckets.end())
+    {
+        TokenBucket bucket;
+        bucket.lastRefill = now;
+        return mBuckets.insert(email, bucket).value();
+    }
+
+    it->tokens = std::min(static_cast<double>(BURST),
+                          it->tokens + static_cast<double>(now - it->lastRefill) / REFILL_MS);
+    it->lastRefill = now;
+    return it.value();
+}
+
+qint64 UserAlertAggregator::tokenAvailableAt(const QString& email, qint64 now) const
+{
+    auto it = mBuckets.constFind(email);
+    if (it == mBuckets.constEnd())
+    {
+        return now;
+    }
+
+    // Counted from the last refill, so that it doesn't drift with the time it is asked at
+    const double missing = 1.0 - it->tokens;
+    const qint64 available = it->lastRefill + static_cast<qint64>(std::ceil(missing * REFILL_MS));
+    return std::max(now, available);
+}
+
+qint64 UserAlertAggregator::windowEnd(const Group& group)
+{
+    return std::min(group.lastAlert + WINDOW_MS, group.firstAlert + MAX_DELAY_MS);
+}
+
+void UserAlertAggregator::schedule()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 next = nextRelease(now);
+    if (next < 0)
+    {
+        mTimer.stop();
+        return;
+    }
+    mTimer.start(static_cast<int>(std::max<qint64>(0, next - now)));
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "megaapi.h"
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include <memory>
+
+// Groups user alerts of the same type, user and node that arrive close in time, so that a single
+// summary notification is shown for all of them. A group is released once no alert has been added
+// to it for WINDOW_MS (and at most MAX_DELAY_MS after its first alert). Besides, every user can
+// only produce BURST notifications in a row, and then one every REFILL_MS: the alerts that arrive
+// meanwhile keep being added to their pending group.
+class UserAlertAggregator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const qint64 WINDOW_MS = 3000;
+    static const qint64 MAX_DELAY_MS = 15000;
+    static const int BURST = 3;
+    static const qint64 REFILL_MS = 20000;
+
+    struct Summary
+    {
+        int type = 0;
+        QString email;
+        mega::MegaHandle node = mega::INVALID_HANDLE;
+        int alerts = 0;
+        long long items = 0;
+        // Last alert added to the group
+        std::shared_ptr<mega::MegaUserAlert> alert;
+    };
+
+    explicit UserAlertAggregator(QObject* parent = nullptr);
+
+    // Adds an alert (copied) to the group of (type, email, node)
+    void addUserAlert(mega::MegaUserAlert* alert, int type, const QString& email, mega::MegaHandle node, long long items);
+
+    // Timing is handled here, the functions below take the current time to be testable
+    void add(qint64 now, const Summary& alert);
+    QVector<Summary> takeReady(qint64 now);
+    qint64 nextRelease(qint64 now) const;   // -1 if there are no pending groups
+
+signals:
+    void summaryReady(const UserAlertAggregator::Summary& summary);
+
+private slots:
+    void onTimeout();
+
+private:
+    struct Key
+    {
+        int type;
+        QString email;
+        mega::MegaHandle node;
+
+        bool operator==(const Key& other) const
+        {
+            return type == other.type && node == other.node && email == other.email;
+        }
+    };
+    friend uint qHash(const Key& key, uint seed);
+
+    struct Group
+    {
+        Summary summary;
+        qint64 firstAlert = 0;
+        qint64 lastAlert = 0;
+    };
+
+    struct TokenBucket
+    {
+        double tokens = BURST;
+        qint64 lastRefill = 0;
+    };
+
+    TokenBucket& refill(const QString& email, qint64 now);
+    qint64 tokenAvailableAt(const QString& email, qint64 now) const;
+    static qint64 windowEnd(const Group& group);
+    void schedule();
+
+    QHash<Key, Group> mGroups;
+    QHash<QString, TokenBucket> mBuckets;
+    QTimer mTimer;
+};
@@ -1,15 +1,33 @@
 #include "CrashHandler.h"
 #include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QProcess>
 #include <QtCore/QCoreApplication>
 #include <QString>
 #include <QDateTime>
 #include <sstream>
 #include "MegaApplication.h"
+#include "CrashStack.h"
 
 using namespace mega;
 using namespace std;
 
+// Larger files in the dump folder are minidumps, not reports written by the signal handler
+const qint64 MAX_CRASH_REPORT_SIZE = 16384;
+// Left in the dump folder by the signal handler, with the time of the last relaunch, if any
+const char* CRASH_MARKER_NAME = "crash.marker";
+
+// Returns the relaunch time stored in the crash marker, 0 if there is none
+long long readCrashMarker(const QString& path)
+{
+    QFile marker(path);
+    if (!marker.open(QIODevice::ReadOnly))
+    {
+        return 0;
+    }
+    return QString::fromUtf8(marker.readAll()).trimmed().toLongLong();
+}
+
 #if defined(Q_OS_MAC)
 #include "client/mac/handler/exception_handler.h"
 #elif defined(Q_OS_LINUX)
@@ -23,7 +41,13 @@ using namespace std;
 
     #include <signal.h>
     #include <execinfo.h>
+    #include <dlfcn.h>
+    #include <fcntl.h>
+    #include <limits.h>
+    #include <errno.h>
+    #include <time.h>
     #include <sys/utsname.h>
+    #include <unistd.h>
 
 
 #ifdef __linux__
@@ -136,30 +160,116 @@ string getDistroVersion()
 #endif
 
 
-    string dump_path;
+    // Everything the signal handler writes is prepared when the handler is installed. In the
+    // signal context it only formats numbers into preallocated buffers and calls write(), so it
+    // works even when the heap is exhausted or corrupted. Frames are written as module offsets
+    // and resolved later (see CrashStack).
+    const size_t CRASH_TEXT_SIZE = 2048;
+    const int MAX_CRASH_FRAMES = 32;
+
+    char crash_dump_path[PATH_MAX];
+    char crash_header[CRASH_TEXT_SIZE];
+    size_t crash_header_size = 0;
+    char crash_system_info[CRASH_TEXT_SIZE];
+    size_t crash_system_info_size = 0;
+    char crash_line[PATH_MAX + 64];
+
+    char crash_marker_path[PATH_MAX];
+    // Set while the handler runs, so a crash inside it does not start it again
+    volatile sig_atomic_t crash_handling = 0;
+    // Seconds given to the logger to flush before the process is ended
+    const unsigned int CRASH_FLUSH_TIMEOUT_S = 3;
+
+    // Relaunch command, run with fork and execv after the dump is written. It is skipped when
+    // the app was relaunched less than MIN_REBOOT_INTERVAL_MS ago, to avoid restart loops.
+    const int MAX_RESTART_ARGS = 4;
+    char crash_restart_args[MAX_RESTART_ARGS][PATH_MAX];
+    char *crash_restart_argv[MAX_RESTART_ARGS + 1];
+    long long crash_restart_after_ms = 0;
+    long long crash_last_reboot_ms = 0;
+
+    long long crash_realtime_ms()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return static_cast<long long>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+    }
 
-    // signal handler
-    void signal_handler(int sig, siginfo_t *info, void *secret)
+    void crash_write(int fd, const char *data, size_t size)
     {
-        if (g_megaSyncLogger)
+        while (size)
         {
-            g_megaSyncLogger->flushAndClose();
+            ssize_t written = write(fd, data, size);
+            if (written <= 0)
+            {
+                if (written < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
         }
+    }
 
-        int dump_file = open(dump_path.c_str(),  O_WRONLY | O_CREAT, 0400);
-        if (dump_file<0)
+    size_t crash_append(char *buffer, size_t pos, size_t size, const char *text)
+    {
+        while (*text && pos + 1 < size)
         {
-            CrashHandler::tryReboot();
-            exit(128+sig);
+            buffer[pos++] = *text++;
         }
+        buffer[pos] = '\0';
+        return pos;
+    }
+
+    size_t crash_append_number(char *buffer, size_t pos, size_t size, unsigned long long value, bool hex)
+    {
+        char digits[24];
+        int count = 0;
+        unsigned int base = hex ? 16 : 10;
+        do
+        {
+            digits[count++] = "0123456789abcdef"[value % base];
+            value /= base;
+        } while (value);
 
+        if (hex)
+        {
+            pos = crash_append(buffer, pos, size, "0x");
+        }
+        while (count && pos + 1 < size)
+        {
+            buffer[pos++] = digits[--count];
+        }
+        buffer[pos] = '\0';
+        return pos;
+    }
+
+    // strsignal is not async-signal-safe
+    const char *crash_signal_name(int sig)
+    {
+        switch (sig)
+        {
+            case SIGSEGV: return "Segmentation fault";
+            case SIGBUS: return "Bus error";
+            case SIGILL: return "Illegal instruction";
+            case SIGFPE: return "Floating point exception";
+            case SIGABRT: return "Aborted";
+            case SIGTRAP: return "Trace/breakpoint trap";
+            default: return "Signal";
+        }
+    }
+
+    void prepare_crash_info()
+    {
         std::ostringstream oss;
         oss << "MEGAprivate ERROR DUMP\n";
         oss << "Application: " << QApplication::applicationName().toUtf8().constData() << (sizeof(char*) == 4 ? " [32 bit]" : "") << (sizeof(char*) == 8 ? " [64 bit]" : "") << "\n";
         oss << "Version code: " << QString::number(Preferences::VERSION_CODE).toUtf8().constData() <<
                "." << QString::number(Preferences::BUILD_ID).toUtf8().constData() << "\n";
         oss << "Module name: " << "megasync" << "\n";
-        oss << "Timestamp: " << QDateTime::currentMSecsSinceEpoch() << "\n";
+        crash_header_size = crash_append(crash_header, 0, sizeof(crash_header), oss.str().c_str());
 
         string distroinfo;
         #ifdef __linux__
@@ -181,6 +291,7 @@ string getDistroVersion()
             }
         #endif
 
+        oss.str(string());
         struct utsname osData;
         if (!uname(&osData))
         {
@@ -203,18 +314,113 @@ string getDistroVersion()
             oss << "System release: Unknown\n";
             oss << "System arch: Unknown\n";
         }
+        crash_system_info_size = crash_append(crash_system_info, 0, sizeof(crash_system_info), oss.str().c_str());
+
+        // The first call to backtrace may load libgcc and allocate, do it now
+        void *stack[2];
+        backtrace(stack, 2);
 
-        time_t rawtime;
-        time(&rawtime);
-        oss << "Error info:\n";
+        QStringList restartCommand;
+    #ifndef __APPLE__
+        restartCommand << MegaApplication::applicationFilePath();
+    #else
+        QDir appPath(MegaApplication::applicationDirPath());
+        appPath.cdUp();
+        appPath.cdUp();
+        restartCommand << QString::fromUtf8("/usr/bin/open") << QString::fromUtf8("-n") << appPath.absolutePath();
+    #endif
+        int argc = 0;
+        for (const auto& arg : qAsConst(restartCommand))
+        {
+            crash_append(crash_restart_args[argc], 0, sizeof(crash_restart_args[argc]), arg.toUtf8().constData());
+            crash_restart_argv[argc] = crash_restart_args[argc];
+            argc++;
+        }
+        crash_restart_argv[argc] = NULL;
+        crash_restart_after_ms = Preferences::MIN_REBOOT_INTERVAL_MS;
+        // The marker of a previous crash is only removed once the preferences are loaded
+        crash_last_reboot_ms = readCrashMarker(QString::fromUtf8(crash_marker_path));
+    }
+
+    // Leaves the crash marker for the next start, relaunches the app and ends the process
+    void crash_finish(int sig)
+    {
+        const long long now = crash_realtime_ms();
+        const bool restart = crash_restart_argv[0] && now - crash_last_reboot_ms > crash_restart_after_ms;
+        const long long last_reboot_ms = restart ? now : crash_last_reboot_ms;
+
+        int marker_file = open(crash_marker_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        if (marker_file >= 0)
+        {
+            if (last_reboot_ms > 0)
+            {
+                size_t pos = crash_append_number(crash_line, 0, sizeof(crash_line), static_cast<unsigned long long>(last_reboot_ms), false);
+                crash_write(marker_file, crash_line, pos);
+            }
+            close(marker_file);
+        }
+
+        if (restart && !fork())
+        {
+            execv(crash_restart_argv[0], crash_restart_argv);
+            _exit(127);
+        }
+
+        // Last and best effort: the logger is not async-signal-safe and may hang if the crash
+        // happened while it held its lock, so the alarm ends the process in that case
+        alarm(CRASH_FLUSH_TIMEOUT_S);
+        if (g_megaSyncLogger)
+        {
+            g_megaSyncLogger->flushAndClose();
+        }
+        _exit(128+sig);
+    }
+
+    // signal handler
+    // Everything but the final log flush is async-signal-safe, and the preferences are not
+    // touched here. The next start finds the crash marker and handles the crash
+    // (see CrashHandler::consumeCrashMarker).
+    void signal_handler(int sig, siginfo_t *info, void *secret)
+    {
+        if (crash_handling)
+        {
+            _exit(128+sig);
+        }
+        crash_handling = 1;
+
+        int dump_file = open(crash_dump_path,  O_WRONLY | O_CREAT, 0400);
+        if (dump_file<0)
+        {
+            crash_finish(sig);
+        }
+
+        crash_write(dump_file, crash_header, crash_header_size);
+
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        size_t pos = crash_append(crash_line, 0, sizeof(crash_line), "Timestamp: ");
+        pos = crash_append_number(crash_line, pos, sizeof(crash_line),
+                                  static_cast<unsigned long long>(now.tv_sec) * 1000 + static_cast<unsigned long long>(now.tv_nsec / 1000000), false);
+        pos = crash_append(crash_line, pos, sizeof(crash_line), "\n");
+        crash_write(dump_file, crash_line, pos);
+
+        crash_write(dump_file, crash_system_info, crash_system_info_size);
+
+        pos = crash_append(crash_line, 0, sizeof(crash_line), "Error info:\n");
         if (info)
         {
-            oss << strsignal(sig) << " (" << sig << ") at address " << std::showbase << std::hex << info->si_addr << std::dec << "\n";
+            pos = crash_append(crash_line, pos, sizeof(crash_line), crash_signal_name(sig));
+            pos = crash_append(crash_line, pos, sizeof(crash_line), " (");
+            pos = crash_append_number(crash_line, pos, sizeof(crash_line), static_cast<unsigned long long>(sig), false);
+            pos = crash_append(crash_line, pos, sizeof(crash_line), ") at address ");
+            pos = crash_append_number(crash_line, pos, sizeof(crash_line), reinterpret_cast<uintptr_t>(info->si_addr), true);
+            pos = crash_append(crash_line, pos, sizeof(crash_line), "\n");
         }
         else
         {
-            oss << "Out of memory" << endl;
+            pos = crash_append(crash_line, pos, sizeof(crash_line), "Out of memory\n");
         }
+        crash_write(dump_file, crash_line, pos);
 
         void *pnt = NULL;
         if (secret)
@@ -250,29 +456,45 @@ string getDistroVersion()
             #endif
         }
 
-        oss << "Stacktrace:\n";
-        void *stack[32];
-        size_t size;
-        size = backtrace(stack, 32);
+        pos = crash_append(crash_line, 0, sizeof(crash_line), "Stacktrace:\n");
+        crash_write(dump_file, crash_line, pos);
+
+        void *stack[MAX_CRASH_FRAMES];
+        int size = backtrace(stack, MAX_CRASH_FRAMES);
         if (size > 1)
         {
             stack[1] = pnt;
-            char **messages = backtrace_symbols(stack, size);
-            for (unsigned int i = 1; i < size; i++)
+            for (int i = 1; i < size; i++)
             {
-                oss << messages[i] << "\n";
+                // dladdr does not allocate (it is what backtrace_symbols_fd uses)
+                Dl_info module;
+                pos = 0;
+                if (stack[i] && dladdr(stack[i], &module) && module.dli_fname)
+                {
+                    pos = crash_append(crash_line, pos, sizeof(crash_line), module.dli_fname);
+                    pos = crash_append(crash_line, pos, sizeof(crash_line), "+");
+                    pos = crash_append_number(crash_line, pos, sizeof(crash_line),
+                                              reinterpret_cast<uintptr_t>(stack[i]) - reinterpret_cast<uintptr_t>(module.dli_fbase), true);
+                }
+                else
+                {
+                    pos = crash_append(crash_line, pos, sizeof(crash_line), "??+0x0");
+                }
+                pos = crash_append(crash_line, pos, sizeof(crash_line), " [");
+                pos = crash_append_number(crash_line, pos, sizeof(crash_line), reinterpret_cast<uintptr_t>(stack[i]), true);
+                pos = crash_append(crash_line, pos, sizeof(crash_line), "]\n");
+                crash_write(dump_file, crash_line, pos);
             }
         }
         else
         {
-            oss << "Error getting stacktrace\n";
+            pos = crash_append(crash_line, 0, sizeof(crash_line), "Error getting stacktrace\n");
+            crash_write(dump_file, crash_line, pos);
         }
 
-        write(dump_file, oss.str().c_str(), oss.str().size());
         close(dump_file);
 
-        CrashHandler::tryReboot();
-        exit(128+sig);
+        crash_finish(sig);
     }
 
     void mega_new_handler()
@@ -384,7 +606,11 @@ void CrashHandlerPrivate::InitCrashHandler(const QString& dumpPath)
 
         char name[37];
         sprintf(name, "%08x-%04x-%04x-%08x-%08x", data1, data2, data3, data4, data5);
-        dump_path = std::string(dumpPath.toUtf8().constData()) + "/" + name + ".dmp";
+        string dump_path = std::string(dumpPath.toUtf8().constData()) + "/" + name + ".dmp";
+        crash_append(crash_dump_path, 0, sizeof(crash_dump_path), dump_path.c_str());
+        string marker_path = std::string(dumpPath.toUtf8().constData()) + "/" + CRASH_MARKER_NAME;
+        crash_append(crash_marker_path, 0, sizeof(crash_marker_path), marker_path.c_str());
+        prepare_crash_info();
 
         /* Install our signal handler */
         struct sigaction sa;
@@ -489,6 +715,23 @@ bool CrashHandler::writeMinidump()
     return res;
 }
 
+bool CrashHandler::consumeCrashMarker()
+{
+    QString markerPath = QDir(dumpPath).filePath(QString::fromUtf8(CRASH_MARKER_NAME));
+    if (!QFile::exists(markerPath))
+    {
+        return false;
+    }
+
+    long long lastReboot = readCrashMarker(markerPath);
+    if (lastReboot > 0)
+    {
+        Preferences::instance()->setLastReboot(lastReboot);
+    }
+    QFile::remove(markerPath);
+    return true;
+}
+
 QStringList CrashHandler::getPendingCrashReports()
 {
     auto preferences = Preferences::instance();
@@ -496,6 +739,7 @@ QStringList CrashHandler::getPendingCrashReports()
     QStringList result;
 
     lastCrashHash.clear();
+    pendingCrashHashes.clear();
 
     MegaApi::log(MegaApi::LOG_LEVEL_INFO, "Checking pending crash repors");
     QDir dir(dumpPath);
@@ -508,7 +752,7 @@ QStringList CrashHandler::getPendingCrashReports()
             continue;
         }
 
-        if (file.size() > 16384)
+        if (file.size() > MAX_CRASH_REPORT_SIZE)
         {
             continue;
         }
@@ -532,7 +776,9 @@ QStringList CrashHandler::getPendingCrashReports()
             continue;
         }
 
-        QString crashHash = QString::fromAscii(QCryptographicHash::hash(crashReport.toUtf8(),QCryptographicHash::Md5).toHex());
+        // Identify the crash by its stack, not by the full text: timestamps and load addresses
+        // differ between occurrences of the same crash
+        QString crashHash = CrashStack::signature(crashReport);
         if (lastCrashHash.isNull())
         {
             lastCrashHash = crashHash;
@@ -542,10 +788,12 @@ QStringList CrashHandler::getPendingCrashReports()
         {
             MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("New crash file: %1  Hash: %2")
                          .arg(file.fileName()).arg(crashHash).toUtf8().constData());
+            crashReport = CrashStack::symbolize(crashReport);
             int idx = crashReport.indexOf(QString::fromAscii("Version code: "));
             crashReport.insert(idx, QString::fromUtf8("Hash: %1\n").arg(crashHash));
             result.append(crashReport);
             previousCrashes.append(crashHash);
+            pendingCrashHashes.append(crashHash);
         }
         else
         {
@@ -587,11 +835,10 @@ void CrashHandler::sendPendingCrashReports(QString userMessage)
 void CrashHandler::discardPendingCrashReports()
 {
     auto preferences = Preferences::instance();
-    QStringList crashes = getPendingCrashReports();
+    getPendingCrashReports();
     QStringList previousCrashes = preferences->getPreviousCrashes();
-    for (int i = 0; i < crashes.size(); i++)
+    for (const QString& crashHash : pendingCrashHashes)
     {
-        QString crashHash = QString::fromAscii(QCryptographicHash::hash(crashes[i].toUtf8(),QCryptographicHash::Md5).toHex());
         if (!previousCrashes.contains(crashHash))
         {
             previousCrashes.append(crashHash);
@@ -615,6 +862,8 @@ void CrashHandler::onPostFinished(QNetworkReply *reply)
     if (!statusCode.isValid() || (statusCode.toInt() != 200) || (reply->error() != QNetworkReply::NoError))
     {
         MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Error sending crash reports");
+        // Not offered again on the next start
+        discardPendingCrashReports();
         return;
     }
 
@@ -632,7 +881,7 @@ void CrashHandler::onCrashPostTimeout()
     }
 
     MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Timeout sending crash reports");
-    return;
+    discardPendingCrashReports();
 }
 
 void CrashHandler::deletePendingCrashReports()
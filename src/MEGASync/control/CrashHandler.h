@@ -23,6 +23,8 @@ public:
     void setReportCrashesToSystem(bool report);
     bool writeMinidump();
 
+    // Returns true if the signal handler left a crash marker, and removes it
+    bool consumeCrashMarker();
     QStringList getPendingCrashReports();
     void sendPendingCrashReports(QString userMessage);
     void discardPendingCrashReports();
@@ -45,6 +47,7 @@ private:
     QEventLoop loop;
     QTimer crashPostTimer;
     QString lastCrashHash;
+    QStringList pendingCrashHashes;
 };
 
 #endif // CRASHHANDLER_H
@@ -0,0 +1,122 @@
+#include "CrashSignature.h"
+
+#include <QList>
+
+const char CrashSignature::ERROR_INFO_HEADER[] = "Error info:";
+const char CrashSignature::STACKTRACE_HEADER[] = "Stacktrace:";
+const char CrashSignature::SEPARATOR[] = "------------------------------";
+
+namespace
+{
+const char ADDRESS_SEPARATOR[] = " at address";
+
+bool isAddress(const QByteArray& token)
+{
+    return token.startsWith("0x") || token.startsWith("[0x");
+}
+}
+
+CrashSignature::CrashSignature()
+    : mHash(QCryptographicHash::Md5)
+{
+}
+
+void CrashSignature::addErrorLine(const QByteArray& line)
+{
+    mHash.addData(normalizeError(line));
+    mHash.addData("\n", 1);
+}
+
+void CrashSignature::addFrameLine(const QByteArray& line)
+{
+    QByteArray frame = normalizeFrame(line);
+    if (!frame.isEmpty())
+    {
+        mHash.addData(frame);
+        mHash.addData("\n", 1);
+    }
+}
+
+QByteArray CrashSignature::result() const
+{
+    return mHash.result();
+}
+
+QString CrashSignature::ofReport(const QString& crashReport)
+{
+    enum { HEADER, ERROR_LINE, FRAMES } state = HEADER;
+
+    CrashSignature signature;
+    const QList<QByteArray> lines = crashReport.toUtf8().split('\n');
+    for (QByteArray line : lines)
+    {
+        if (line.endsWith('\r'))
+        {
+            line.chop(1);
+        }
+
+        if (line.startsWith(SEPARATOR))
+        {
+            break;
+        }
+        else if (state == ERROR_LINE)
+        {
+            signature.addErrorLine(line);
+            state = HEADER;
+        }
+        else if (state == FRAMES)
+        {
+            signature.addFrameLine(line);
+        }
+        else if (line.startsWith(ERROR_INFO_HEADER))
+        {
+            state = ERROR_LINE;
+        }
+        else if (line.startsWith(STACKTRACE_HEADER))
+        {
+            state = FRAMES;
+        }
+    }
+    return QString::fromLatin1(signature.result().toHex());
+}
+
+QByteArray CrashSignature::normalizeError(const QByteArray& line)
+{
+    // The faulting address changes with every run
+    int addressIndex = line.indexOf(ADDRESS_SEPARATOR);
+    return addressIndex >= 0 ? line.left(addressIndex) : line;
+}
+
+QByteArray CrashSignature::normalizeFrame(const QByteArray& line)
+{
+    // Keep module names and offsets, drop absolute addresses (they change with every run)
+    // and the folders the modules were loaded from
+    QByteArray normalized;
+    const QList<QByteArray> tokens = line.simplified().split(' ');
+    for (QByteArray token : tokens)
+    {
+        if (token.startsWith("[0x"))
+        {
+            // Anything after the address was added when symbolizing
+            break;
+        }
+        if (token.isEmpty() || isAddress(token))
+        {
+            continue;
+        }
+
+        int moduleEnd = token.indexOf('(');
+        int slash = token.lastIndexOf('/', moduleEnd < 0 ? -1 : moduleEnd);
+        if (slash >= 0)
+        {
+            token.remove(0, slash + 1);
+        }
+
+        if (!normalized.isEmpty())
+        {
+            normalized.append(' ');
+        }
+        normalized.append(token);
+    }
+    return normalized;
+}
@@ -0,0 +1,39 @@
+#ifndef CRASHSIGNATURE_H
+#define CRASHSIGNATURE_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+
+// Hash identifying a crash independently of the run that produced it: the kind of error and the
+// module and offset of every frame, without absolute addresses, module folders or the symbols
+// added afterwards. The app stores it as the "Hash:" of a report and MEGACrashAnalyzer groups
+// reports by it, so both must go through this class.
+class CrashSignature
+{
+public:
+    CrashSignature();
+
+    // Line following "Error info:"
+    void addErrorLine(const QByteArray& line);
+    // Any line following "Stacktrace:"
+    void addFrameLine(const QByteArray& line);
+
+    // MD5 of the lines added so far
+    QByteArray result() const;
+
+    // Signature of a whole report, as MD5 hex
+    static QString ofReport(const QString& crashReport);
+
+    static QByteArray normalizeError(const QByteArray& line);
+    static QByteArray normalizeFrame(const QByteArray& line);
+
+    static const char ERROR_INFO_HEADER[];
+    static const char STACKTRACE_HEADER[];
+    static const char SEPARATOR[];
+
+private:
+    QCryptographicHash mHash;
+};
+
+#endif // CRASHSIGNATURE_H
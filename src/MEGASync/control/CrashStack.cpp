@@ -0,0 +1,173 @@
+#include "CrashStack.h"
+#include "CrashSignature.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QHash>
+#include <QStringList>
+
+#ifndef WIN32
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#elif defined(__linux__)
+#include <link.h>
+#endif
+
+const QString CrashStack::STACKTRACE_HEADER = QString::fromUtf8("Stacktrace:");
+
+namespace
+{
+#if defined(__linux__)
+int addModuleBase(struct dl_phdr_info* info, size_t, void* data)
+{
+    auto bases = static_cast<QHash<QString, quint64>*>(data);
+
+    // dladdr reports the start of the lowest mapping as the module base
+    quint64 lowest = ~0ULL;
+    for (int i = 0; i < info->dlpi_phnum; i++)
+    {
+        if (info->dlpi_phdr[i].p_type == PT_LOAD && info->dlpi_phdr[i].p_vaddr < lowest)
+        {
+            lowest = info->dlpi_phdr[i].p_vaddr;
+        }
+    }
+    if (lowest == ~0ULL)
+    {
+        return 0;
+    }
+
+    // The main executable has no name here
+    QString path = (info->dlpi_name && info->dlpi_name[0]) ? QString::fromUtf8(info->dlpi_name)
+                                                         : QCoreApplication::applicationFilePath();
+    quint64 base = info->dlpi_addr + lowest;
+    bases->insert(path, base);
+    bases->insert(QFileInfo(path).fileName(), base);
+    return 0;
+}
+#endif
+
+QHash<QString, quint64> getLoadedModules()
+{
+    QHash<QString, quint64> bases;
+#if defined(__linux__)
+    dl_iterate_phdr(addModuleBase, &bases);
+#elif defined(__APPLE__)
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+    {
+        QString path = QString::fromUtf8(_dyld_get_image_name(i));
+        quint64 base = reinterpret_cast<quint64>(_dyld_get_image_header(i));
+        bases.insert(path, base);
+        bases.insert(QFileInfo(path).fileName(), base);
+    }
+#endif
+    return bases;
+}
+}
+
+QVector<CrashStack::Frame> CrashStack::parseFrames(const QString& crashReport)
+{
+    QVector<Frame> frames;
+    int start = crashReport.indexOf(STACKTRACE_HEADER);
+    if (start < 0)
+    {
+        return frames;
+    }
+
+    QStringList lines = crashReport.mid(start + STACKTRACE_HEADER.size()).split(QLatin1Char('\n'), QString::SkipEmptyParts);
+    for (const QString& line : lines)
+    {
+        Frame frame;
+        if (parseFrame(line, frame))
+        {
+            frames.append(frame);
+        }
+    }
+    return frames;
+}
+
+QString CrashStack::signature(const QString& crashReport)
+{
+    return CrashSignature::ofReport(crashReport);
+}
+
+QString CrashStack::symbolize(const QString& crashReport)
+{
+    int start = crashReport.indexOf(STACKTRACE_HEADER);
+    if (start < 0)
+    {
+        return crashReport;
+    }
+
+    QStringList lines = crashReport.mid(start).split(QLatin1Char('\n'));
+    for (QString& line : lines)
+    {
+        Frame frame;
+        if (parseFrame(line, frame) && frame.symbol.isEmpty())
+        {
+            QString symbol = resolveSymbol(frame);
+            if (!symbol.isEmpty())
+            {
+                line.append(QLatin1Char(' ')).append(symbol);
+            }
+        }
+    }
+    return crashReport.left(start) + lines.join(QLatin1Char('\n'));
+}
+
+bool CrashStack::parseFrame(const QString& line, Frame& frame)
+{
+    int addressStart = line.indexOf(QString::fromUtf8(" [0x"));
+    int addressEnd = line.indexOf(QLatin1Char(']'), addressStart);
+    int offsetStart = line.lastIndexOf(QString::fromUtf8("+0x"), addressStart);
+    if (addressStart < 0 || addressEnd < 0 || offsetStart < 0)
+    {
+        return false;
+    }
+
+    bool offsetOk = false;
+    bool addressOk = false;
+    frame.module = line.left(offsetStart);
+    frame.offset = line.mid(offsetStart + 3, addressStart - offsetStart - 3).toULongLong(&offsetOk, 16);
+    frame.address = line.mid(addressStart + 4, addressEnd - addressStart - 4).toULongLong(&addressOk, 16);
+    frame.symbol = line.mid(addressEnd + 1).trimmed();
+    return offsetOk && addressOk && !frame.module.isEmpty();
+}
+
+QString CrashStack::resolveSymbol(const Frame& frame)
+{
+#ifndef WIN32
+    static const QHash<QString, quint64> bases = getLoadedModules();
+    auto it = bases.constFind(frame.module);
+    if (it == bases.constEnd())
+    {
+        it = bases.constFind(QFileInfo(frame.module).fileName());
+    }
+    if (it == bases.constEnd())
+    {
+        return QString();
+    }
+
+    Dl_info info;
+    void* address = reinterpret_cast<void*>(it.value() + frame.offset);
+    if (!dladdr(address, &info) || !info.dli_sname)
+    {
+        return QString();
+    }
+
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    QString name = QString::fromUtf8(status == 0 && demangled ? demangled : info.dli_sname);
+    free(demangled);
+
+    quint64 symbolOffset = reinterpret_cast<quint64>(address) - reinterpret_cast<quint64>(info.dli_saddr);
+    return QString::fromUtf8("%1+0x%2").arg(name).arg(symbolOffset, 0, 16);
+#else
+    Q_UNUSED(frame)
+    return QString();
+#endif
+}
@@ -0,0 +1,39 @@
+#ifndef CRASHSTACK_H
+#define CRASHSTACK_H
+
+#include <QString>
+#include <QVector>
+
+// Stack traces in crash reports are written by the signal handler as raw frames:
+//   <module>+0x<offset> [0x<address>]
+// so that nothing has to be resolved in the signal context. This class parses them back,
+// resolves symbol names afterwards and computes a signature that does not depend on where
+// the modules were loaded, so that the same crash is recognized across runs.
+class CrashStack
+{
+public:
+    struct Frame
+    {
+        QString module;
+        quint64 offset = 0;
+        quint64 address = 0;
+        QString symbol;
+    };
+
+    static const QString STACKTRACE_HEADER;
+
+    static QVector<Frame> parseFrames(const QString& crashReport);
+
+    // MD5 hex of the error and the normalized frames, see CrashSignature
+    static QString signature(const QString& crashReport);
+
+    // Appends symbol names to the frames of modules that are loaded in the current process.
+    // Only valid for reports written by the same build
+    static QString symbolize(const QString& crashReport);
+
+private:
+    static bool parseFrame(const QString& line, Frame& frame);
+    static QString resolveSymbol(const Frame& frame);
+};
+
+#endif // CRASHSTACK_H
@@ -0,0 +1,370 @@
+#include "DebrisSizeAccountant.h"
+
+#include "DirectoryWalker.h"
+#include "MegaApplication.h"
+#include "Preferences.h"
+#include "syncs/control/SyncInfo.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrent>
+
+using namespace mega;
+
+namespace
+{
+// Changes usually come in bursts (a file is moved to the debris folder for every synced change)
+constexpr int RESCAN_DELAY_MS = 2000;
+// Only the debris folder and its day subfolders are watched, changes deeper are found here
+constexpr int RECONCILE_INTERVAL_MS = 10 * 60 * 1000;
+constexpr qint64 REMOTE_MAX_AGE_MS = 60 * 1000;
+constexpr quint32 SIZES_FILE_MAGIC = 0x4D444253; // "MDBS"
+constexpr quint32 SIZES_FILE_VERSION = 1;
+const QString SIZES_FILE_NAME = QString::fromLatin1("debrissizes.cache");
+}
+
+QPointer<DebrisSizeAccountant> DebrisSizeAccountant::mInstance;
+
+DebrisSizeAccountant* DebrisSizeAccountant::instance()
+{
+    if (!mInstance)
+    {
+        mInstance = new DebrisSizeAccountant();
+    }
+    return mInstance.data();
+}
+
+// A child of the application, so it is destroyed with it and not during the static teardown
+DebrisSizeAccountant::DebrisSizeAccountant()
+    : QObject(qApp),
+      mRemoteSize(-1),
+      mRemoteUpdateTime(0)
+{
+    connect(&mWatcher, &QFileSystemWatcher::directoryChanged, this, &DebrisSizeAccountant::onDirectoryChanged);
+    connect(&mLocalScan, &QFutureWatcher<QHash<QString, ScanResult>>::finished,
+            this, &DebrisSizeAccountant::onLocalScanFinished);
+    connect(&mRemoteScan, &QFutureWatcher<long long>::finished,
+            this, &DebrisSizeAccountant::onRemoteScanFinished);
+
+    mRescanTimer.setSingleShot(true);
+    mRescanTimer.setInterval(RESCAN_DELAY_MS);
+    connect(&mRescanTimer, &QTimer::timeout, this, &DebrisSizeAccountant::scanLocal);
+
+    mReconcileTimer.setInterval(RECONCILE_INTERVAL_MS);
+    connect(&mReconcileTimer, &QTimer::timeout, this, &DebrisSizeAccountant::onReconcile);
+
+    auto model (SyncInfo::instance());
+    connect(model, &SyncInfo::syncStateChanged, this, &DebrisSizeAccountant::updateRoots);
+    connect(model, &SyncInfo::syncRemoved, this, &DebrisSizeAccountant::updateRoots);
+
+    // Sizes of the previous execution are shown until they are verified. Syncs may still be
+    // loading, so sizes of unknown folders are kept and only dropped when saving
+    loadSizes();
+    updateRoots();
+}
+
+DebrisSizeAccountant::~DebrisSizeAccountant()
+{
+    mLocalScan.waitForFinished();
+    mRemoteScan.waitForFinished();
+}
+
+long long DebrisSizeAccountant::localSize() const
+{
+    long long total = 0;
+    for (const auto& root : mRoots)
+    {
+        auto it = mLocalSizes.constFind(root);
+        if (it == mLocalSizes.constEnd())
+        {
+            return -1;
+        }
+        total += it.value();
+    }
+    return total;
+}
+
+long long DebrisSizeAccountant::remoteSize() const
+{
+    return mRemoteEmail == Preferences::instance()->email() ? mRemoteSize : -1;
+}
+
+void DebrisSizeAccountant::refresh()
+{
+    // Nobody looks at the sizes until they are requested, the watched folders are enough till then
+    if (!mReconcileTimer.isActive())
+    {
+        mReconcileTimer.start();
+    }
+
+    if (!mDirtyRoots.isEmpty())
+    {
+        scanLocal();
+    }
+
+    if (remoteSize() < 0
+            || QDateTime::currentMSecsSinceEpoch() - mRemoteUpdateTime > REMOTE_MAX_AGE_MS)
+    {
+        scanRemote();
+    }
+}
+
+void DebrisSizeAccountant::remoteDebrisCleared()
+{
+    mRemoteSize = 0;
+    mRemoteEmail = Preferences::instance()->email();
+    mRemoteUpdateTime = QDateTime::currentMSecsSinceEpoch();
+    emit remoteSizeChanged(mRemoteSize);
+}
+
+void DebrisSizeAccountant::onDirectoryChanged(const QString& path)
+{
+    const QString changedPath = QDir::cleanPath(path);
+    for (const auto& root : qAsConst(mRoots))
+    {
+        if (changedPath == root || changedPath.startsWith(root + QLatin1Char('/')))
+        {
+            mDirtyRoots.insert(root);
+            if (!mRescanTimer.isActive())
+            {
+                mRescanTimer.start();
+            }
+            return;
+        }
+    }
+}
+
+void DebrisSizeAccountant::onLocalScanFinished()
+{
+    const long long previousSize = localSize();
+
+    const auto results = mLocalScan.result();
+    for (auto it = results.constBegin(); it != results.constEnd(); ++it)
+    {
+        // The sync could have been removed during the scan
+        if (mRoots.contains(it.key()))
+        {
+            mLocalSizes.insert(it.key(), it->size);
+            updateWatchedPaths(it.key(), it->subfolders);
+        }
+    }
+    saveSizes();
+
+    const long long size = localSize();
+    if (size != previousSize)
+    {
+        emit localSizeChanged(size);
+    }
+
+    // Changes received during the scan
+    if (!mDirtyRoots.isEmpty() && !mRescanTimer.isActive())
+    {
+        mRescanTimer.start();
+    }
+}
+
+void DebrisSizeAccountant::onRemoteScanFinished()
+{
+    mRemoteSize = mRemoteScan.result();
+    mRemoteUpdateTime = QDateTime::currentMSecsSinceEpoch();
+    emit remoteSizeChanged(remoteSize());
+}
+
+void DebrisSizeAccountant::onReconcile()
+{
+    mDirtyRoots = mRoots.toSet();
+    scanLocal();
+}
+
+void DebrisSizeAccountant::updateRoots()
+{
+    QStringList roots;
+    for (const auto& syncPath : SyncInfo::instance()->getLocalFolders(SyncInfo::AllHandledSyncTypes))
+    {
+        if (!syncPath.isEmpty())
+        {
+            roots.append(QDir::cleanPath(syncPath + QLatin1Char('/') + QString::fromUtf8(MEGA_DEBRIS_FOLDER)));
+        }
+    }
+
+    for (const auto& root : qAsConst(mRoots))
+    {
+        if (!roots.contains(root))
+        {
+            updateWatchedPaths(root, QStringList());
+            mLocalSizes.remove(root);
+            mDirtyRoots.remove(root);
+        }
+    }
+
+    bool added = false;
+    for (const auto& root : qAsConst(roots))
+    {
+        if (!mRoots.contains(root))
+        {
+            mDirtyRoots.insert(root);
+            added = true;
+        }
+    }
+
+    mRoots = roots;
+    if (added && !mRescanTimer.isActive())
+    {
+        mRescanTimer.start();
+    }
+}
+
+void DebrisSizeAccountant::scanLocal()
+{
+    if (mLocalScan.isRunning() || mDirtyRoots.isEmpty())
+    {
+        // Finishing the running scan checks for pending roots
+        return;
+    }
+
+    mRescanTimer.stop();
+    const QStringList roots = mDirtyRoots.toList();
+    mDirtyRoots.clear();
+    mLocalScan.setFuture(QtConcurrent::run(&DebrisSizeAccountant::scanFolders, roots));
+}
+
+void DebrisSizeAccountant::scanRemote()
+{
+    if (mRemoteScan.isRunning())
+    {
+        return;
+    }
+
+    mRemoteEmail = Preferences::instance()->email();
+    MegaApi* megaApi = MegaSyncApp->getMegaApi();
+    mRemoteScan.setFuture(QtConcurrent::run([megaApi]()
+    {
+        std::unique_ptr<MegaNode> syncDebris (megaApi->getNodeByPath("//bin/SyncDebris"));
+        return megaApi->getSize(syncDebris.get());
+    }));
+}
+
+void DebrisSizeAccountant::updateWatchedPaths(const QString& root, const QStringList& subfolders)
+{
+    const QString prefix = root + QLatin1Char('/');
+    QStringList unwatched;
+    for (const auto& path : mWatcher.directories())
+    {
+        if ((path == root || path.startsWith(prefix)) && !subfolders.contains(path))
+        {
+            unwatched.append(path);
+        }
+    }
+    if (!unwatched.isEmpty())
+    {
+        mWatcher.removePaths(unwatched);
+    }
+
+    if (subfolders.isEmpty())
+    {
+        return;
+    }
+
+    QStringList watched;
+    const QStringList directories = mWatcher.directories();
+    for (const auto& path : subfolders)
+    {
+        if (!directories.contains(path))
+        {
+            watched.append(path);
+        }
+    }
+    if (!watched.isEmpty())
+    {
+        mWatcher.addPaths(watched);
+    }
+}
+
+// Runs in a worker thread
+QHash<QString, DebrisSizeAccountant::ScanResult> DebrisSizeAccountant::scanFolders(const QStringList& roots)
+{
+    auto walker (DirectoryWalker::instance());
+    QHash<QString, ScanResult> results;
+    for (const auto& root : roots)
+    {
+        ScanResult& result = results[root];
+        result.size = walker->getFolderSize(root);
+
+        // A missing debris folder has nothing to watch, its creation is found when reconciling
+        if (!QFileInfo(root).isDir())
+        {
+            continue;
+        }
+        result.subfolders.append(root);
+        for (const auto& entry : walker->listEntries(root))
+        {
+            if (entry.isDir)
+            {
+                result.subfolders.append(root + QLatin1Char('/') + entry.name);
+            }
+        }
+    }
+    return results;
+}
+
+void DebrisSizeAccountant::loadSizes()
+{
+    QString dataPath = Preferences::instance()->getDataPath();
+    if (dataPath.isEmpty())
+    {
+        return;
+    }
+
+    QFile file(dataPath + QLatin1Char('/') + SIZES_FILE_NAME);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QHash<QString, long long> sizes;
+    stream >> magic >> version;
+    if (magic != SIZES_FILE_MAGIC || version != SIZES_FILE_VERSION)
+    {
+        return;
+    }
+
+    stream >> sizes;
+    if (stream.status() == QDataStream::Ok)
+    {
+        mLocalSizes = sizes;
+    }
+}
+
+void DebrisSizeAccountant::saveSizes() const
+{
+    QString dataPath = Preferences::instance()->getDataPath();
+    if (dataPath.isEmpty())
+    {
+        return;
+    }
+
+    QHash<QString, long long> sizes;
+    for (const auto& root : mRoots)
+    {
+        auto it = mLocalSizes.constFind(root);
+        if (it != mLocalSizes.constEnd())
+        {
+            sizes.insert(root, it.value());
+        }
+    }
+
+    QSaveFile file(dataPath + QLatin1Char('/') + SIZES_FILE_NAME);
+    if (file.open(QIODevice::WriteOnly))
+    {
+        QDataStream stream(&file);
+        stream << SIZES_FILE_MAGIC << SIZES_FILE_VERSION << sizes;
+        file.commit();
+    }
+}
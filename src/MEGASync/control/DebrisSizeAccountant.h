@@ -0,0 +1,83 @@
+#ifndef DEBRISSIZEACCOUNTANT_H
+#define DEBRISSIZEACCOUNTANT_H
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+// Keeps the size of the local debris folder of every sync and of the remote SyncDebris folder,
+// so that the settings dialog can show them as soon as it is opened.
+// Local debris folders and their day subfolders are watched (inotify on Linux) and only the
+// folders that changed are scanned again. Once the sizes have been requested, everything is
+// also reconciled periodically to catch the changes deeper in the tree. Scans go through
+// DirectoryWalker, so they only read the directories modified since the previous one.
+// Local sizes are persisted between executions. The instance is owned by the application.
+class DebrisSizeAccountant : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DebrisSizeAccountant* instance();
+    ~DebrisSizeAccountant();
+
+    // -1 while unknown
+    long long localSize() const;
+    long long remoteSize() const;
+
+    // Scans the local debris folders that changed and the remote one if it is outdated,
+    // and starts the periodic reconciliation
+    void refresh();
+    // The remote debris was just removed, there is no need to ask the SDK for a while
+    void remoteDebrisCleared();
+
+signals:
+    void localSizeChanged(long long size);
+    void remoteSizeChanged(long long size);
+
+private slots:
+    void onDirectoryChanged(const QString& path);
+    void onLocalScanFinished();
+    void onRemoteScanFinished();
+    void onReconcile();
+    void updateRoots();
+
+private:
+    struct ScanResult
+    {
+        long long size = 0;
+        // Day subfolders, to be watched
+        QStringList subfolders;
+    };
+
+    DebrisSizeAccountant();
+
+    void scanLocal();
+    void scanRemote();
+    void updateWatchedPaths(const QString& root, const QStringList& subfolders);
+    void loadSizes();
+    void saveSizes() const;
+
+    static QHash<QString, ScanResult> scanFolders(const QStringList& roots);
+
+    static QPointer<DebrisSizeAccountant> mInstance;
+
+    QStringList mRoots;
+    QHash<QString, long long> mLocalSizes;
+    QSet<QString> mDirtyRoots;
+    QFileSystemWatcher mWatcher;
+    QTimer mRescanTimer;
+    QTimer mReconcileTimer;
+    QFutureWatcher<QHash<QString, ScanResult>> mLocalScan;
+
+    long long mRemoteSize;
+    QString mRemoteEmail;
+    qint64 mRemoteUpdateTime;
+    QFutureWatcher<long long> mRemoteScan;
+};
+
+#endif // DEBRISSIZEACCOUNTANT_H
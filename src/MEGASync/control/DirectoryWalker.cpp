@@ -0,0 +1,563 @@
+#include "DirectoryWalker.h"
+
+#include "Preferences.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 28))
+#define MEGA_HAVE_STATX
+#endif
+#endif
+
+namespace
+{
+constexpr unsigned int MAX_WALK_WORKERS = 4;
+constexpr int MAX_CACHED_DIRECTORIES = 1000000;
+// A directory modified this recently could still change within the same mtime tick,
+// so it is scanned but not cached
+constexpr qint64 RACY_MTIME_WINDOW_NS = 2000000000LL;
+constexpr quint32 CACHE_FILE_MAGIC = 0x4D444952; // "MDIR"
+constexpr quint32 CACHE_FILE_VERSION = 2;
+const QString CACHE_FILE_NAME = QString::fromLatin1("dirlistings.cache");
+// Written by the first version of the cache, which also kept sizes
+const QString OLD_CACHE_FILE_NAME = QString::fromLatin1("dirsizes.cache");
+
+qint64 currentTimeNs()
+{
+    return QDateTime::currentMSecsSinceEpoch() * 1000000LL;
+}
+
+#ifdef Q_OS_LINUX
+constexpr size_t DENTS_BUFFER_SIZE = 32 * 1024;
+
+struct linux_dirent64
+{
+    ino64_t d_ino;
+    off64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+struct NativeStat
+{
+    bool isDir = false;
+    bool isFile = false;
+    long long size = 0;
+    qint64 mtimeNs = 0;
+    qint64 creationTime = 0;
+};
+
+bool nativeStatAt(int dirFd, const char* name, NativeStat& result, bool followLinks = false)
+{
+    const int linkFlag = followLinks ? 0 : AT_SYMLINK_NOFOLLOW;
+#ifdef MEGA_HAVE_STATX
+    struct statx stx;
+    if (statx(dirFd, name, linkFlag | AT_NO_AUTOMOUNT,
+              STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_CTIME | STATX_BTIME, &stx))
+    {
+        return false;
+    }
+    result.isDir = S_ISDIR(stx.stx_mode);
+    result.isFile = S_ISREG(stx.stx_mode);
+    result.size = static_cast<long long>(stx.stx_size);
+    result.mtimeNs = stx.stx_mtime.tv_sec * 1000000000LL + stx.stx_mtime.tv_nsec;
+    result.creationTime = (stx.stx_mask & STATX_BTIME) ? stx.stx_btime.tv_sec
+                                                       : stx.stx_ctime.tv_sec;
+#else
+    struct stat st;
+    if (fstatat(dirFd, name, &st, linkFlag))
+    {
+        return false;
+    }
+    result.isDir = S_ISDIR(st.st_mode);
+    result.isFile = S_ISREG(st.st_mode);
+    result.size = static_cast<long long>(st.st_size);
+    result.mtimeNs = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    result.creationTime = st.st_ctim.tv_sec;
+#endif
+    return true;
+}
+
+bool isDotOrDotDot(const char* name)
+{
+    return name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2]));
+}
+
+// Calls onEntry(name, d_type) for every entry of the directory open at dirFd
+template <typename Callback>
+bool readDents(int dirFd, Callback onEntry)
+{
+    alignas(linux_dirent64) char buffer[DENTS_BUFFER_SIZE];
+    for (;;)
+    {
+        long bytes = syscall(SYS_getdents64, dirFd, buffer, sizeof(buffer));
+        if (bytes < 0)
+        {
+            return false;
+        }
+        if (bytes == 0)
+        {
+            return true;
+        }
+
+        for (long offset = 0; offset < bytes;)
+        {
+            auto dirent = reinterpret_cast<linux_dirent64*>(buffer + offset);
+            offset += dirent->d_reclen;
+            if (!isDotOrDotDot(dirent->d_name))
+            {
+                onEntry(dirent->d_name, dirent->d_type);
+            }
+        }
+    }
+}
+#endif
+}
+
+struct DirectoryWalker::WalkState
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<QString> pending;
+    int unfinished = 0;
+    std::atomic<long long> totalSize {0};
+};
+
+std::unique_ptr<DirectoryWalker> DirectoryWalker::mInstance;
+
+DirectoryWalker* DirectoryWalker::instance()
+{
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, []()
+    {
+        mInstance.reset(new DirectoryWalker());
+    });
+    return mInstance.get();
+}
+
+long long DirectoryWalker::getFolderSize(const QString& folderPath)
+{
+    return getFoldersSize(QStringList() << folderPath);
+}
+
+long long DirectoryWalker::getFoldersSize(const QStringList& folderPaths)
+{
+    {
+        std::lock_guard<std::mutex> lock(mListingCacheMutex);
+        loadListingCache();
+    }
+
+    WalkState state;
+    for (const auto& folderPath : folderPaths)
+    {
+        if (!folderPath.isEmpty())
+        {
+            state.pending.push_back(QDir::cleanPath(folderPath));
+        }
+    }
+    state.unfinished = static_cast<int>(state.pending.size());
+    if (!state.unfinished)
+    {
+        return 0;
+    }
+
+    unsigned int workerCount = std::max(1u, std::min(MAX_WALK_WORKERS,
+                                                     std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back(&DirectoryWalker::walkWorker, this, &state);
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    saveListingCache();
+    return state.totalSize;
+}
+
+void DirectoryWalker::walkWorker(WalkState* state)
+{
+    for (;;)
+    {
+        QString path;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->cv.wait(lock, [state]
+            {
+                return !state->pending.empty() || !state->unfinished;
+            });
+            if (state->pending.empty())
+            {
+                return;
+            }
+            path = std::move(state->pending.front());
+            state->pending.pop_front();
+        }
+
+        long long filesSize = 0;
+        QStringList subdirs;
+        bool scanned = scanDirectory(path, filesSize, subdirs);
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (scanned)
+        {
+            state->totalSize += filesSize;
+            for (const auto& subdir : qAsConst(subdirs))
+            {
+                state->pending.push_back(path + QLatin1Char('/') + subdir);
+            }
+            state->unfinished += subdirs.size();
+        }
+
+        // Wake idle workers either to take the new subfolders or to finish
+        if (!--state->unfinished || !state->pending.empty())
+        {
+            state->cv.notify_all();
+        }
+    }
+}
+
+bool DirectoryWalker::scanDirectory(const QString& path, long long& filesSize, QStringList& subdirs)
+{
+    qint64 mtimeNs = 0;
+    if (!getDirectoryMtime(path, mtimeNs))
+    {
+        std::lock_guard<std::mutex> lock(mListingCacheMutex);
+        mListingCacheDirty |= mListingCache.remove(path) > 0;
+        return false;
+    }
+
+    DirListing info;
+    bool cacheHit = false;
+    {
+        std::lock_guard<std::mutex> lock(mListingCacheMutex);
+        auto cached = mListingCache.constFind(path);
+        if (cached != mListingCache.constEnd() && cached->mtimeNs == mtimeNs)
+        {
+            info = cached.value();
+            cacheHit = true;
+        }
+    }
+
+    if (!cacheHit)
+    {
+        if (!readDirectory(path, info))
+        {
+            return false;
+        }
+        info.mtimeNs = mtimeNs;
+
+        std::lock_guard<std::mutex> lock(mListingCacheMutex);
+        if (currentTimeNs() - mtimeNs > RACY_MTIME_WINDOW_NS)
+        {
+            mListingCache.insert(path, info);
+            mListingCacheDirty = true;
+        }
+        else
+        {
+            mListingCacheDirty |= mListingCache.remove(path) > 0;
+        }
+    }
+
+    // The listing can be reused, but not the sizes: files are stat'ed every time
+    subdirs = info.subdirs;
+    statFiles(path, info.files, filesSize, subdirs);
+    return true;
+}
+
+QVector<DirectoryWalker::Entry> DirectoryWalker::listEntries(const QString& folderPath)
+{
+    QVector<Entry> entries;
+
+#ifdef Q_OS_LINUX
+    int dirFd = open(QFile::encodeName(folderPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0)
+    {
+        return entries;
+    }
+
+    readDents(dirFd, [dirFd, &entries](const char* name, unsigned char)
+    {
+        NativeStat st;
+        if (nativeStatAt(dirFd, name, st))
+        {
+            Entry entry;
+            entry.name = QFile::decodeName(name);
+            entry.isDir = st.isDir;
+            entry.size = st.size;
+            entry.creationTime = st.creationTime;
+            entries.append(entry);
+        }
+    });
+    close(dirFd);
+#else
+    QDir dir(folderPath);
+    const auto infos = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    for (const auto& fileInfo : infos)
+    {
+        Entry entry;
+        entry.name = fileInfo.fileName();
+        entry.isDir = fileInfo.isDir();
+        entry.size = fileInfo.size();
+        entry.creationTime = fileInfo.created().toMSecsSinceEpoch() / 1000;
+        entries.append(entry);
+    }
+#endif
+
+    return entries;
+}
+
+void DirectoryWalker::invalidate(const QString& folderPath)
+{
+    const QString path = QDir::cleanPath(folderPath);
+    const QString prefix = path + QLatin1Char('/');
+
+    std::lock_guard<std::mutex> lock(mListingCacheMutex);
+    for (auto it = mListingCache.begin(); it != mListingCache.end();)
+    {
+        if (it.key() == path || it.key().startsWith(prefix))
+        {
+            it = mListingCache.erase(it);
+            mListingCacheDirty = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool DirectoryWalker::getDirectoryMtime(const QString& path, qint64& mtimeNs)
+{
+#ifdef Q_OS_LINUX
+    NativeStat st;
+    if (!nativeStatAt(AT_FDCWD, QFile::encodeName(path).constData(), st, true) || !st.isDir)
+    {
+        return false;
+    }
+    mtimeNs = st.mtimeNs;
+    return true;
+#else
+    QFileInfo info(path);
+    if (!info.isDir())
+    {
+        return false;
+    }
+    mtimeNs = info.lastModified().toMSecsSinceEpoch() * 1000000LL;
+    return true;
+#endif
+}
+
+bool DirectoryWalker::readDirectory(const QString& path, DirListing& info)
+{
+#ifdef Q_OS_LINUX
+    int dirFd = open(QFile::encodeName(path).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0)
+    {
+        return false;
+    }
+
+    bool success = readDents(dirFd, [dirFd, &info](const char* name, unsigned char type)
+    {
+        if (type == DT_DIR)
+        {
+            info.subdirs.append(QFile::decodeName(name));
+        }
+        else if (type == DT_REG || type == DT_LNK)
+        {
+            info.files.append(QFile::decodeName(name));
+        }
+        else if (type == DT_UNKNOWN)
+        {
+            NativeStat st;
+            if (nativeStatAt(dirFd, name, st))
+            {
+                if (st.isDir)
+                {
+                    info.subdirs.append(QFile::decodeName(name));
+                }
+                else
+                {
+                    info.files.append(QFile::decodeName(name));
+                }
+            }
+        }
+    });
+    close(dirFd);
+    return success;
+#else
+    QDir dir(path);
+    if (!dir.exists())
+    {
+        return false;
+    }
+
+    const auto infos = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    for (const auto& fileInfo : infos)
+    {
+        if (fileInfo.isDir() && !fileInfo.isSymLink())
+        {
+            info.subdirs.append(fileInfo.fileName());
+        }
+        else
+        {
+            info.files.append(fileInfo.fileName());
+        }
+    }
+    return true;
+#endif
+}
+
+// Adds the size of the regular files among files (following symbolic links) to filesSize,
+// and appends the ones which turn out to be links to directories to subdirs
+void DirectoryWalker::statFiles(const QString& path, const QStringList& files,
+                                long long& filesSize, QStringList& subdirs)
+{
+    if (files.isEmpty())
+    {
+        return;
+    }
+
+#ifdef Q_OS_LINUX
+    int dirFd = open(QFile::encodeName(path).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0)
+    {
+        return;
+    }
+
+    for (const auto& name : files)
+    {
+        NativeStat st;
+        if (nativeStatAt(dirFd, QFile::encodeName(name).constData(), st, true))
+        {
+            if (st.isFile)
+            {
+                filesSize += st.size;
+            }
+            else if (st.isDir)
+            {
+                subdirs.append(name);
+            }
+        }
+    }
+    close(dirFd);
+#else
+    for (const auto& name : files)
+    {
+        QFileInfo fileInfo(path + QLatin1Char('/') + name);
+        if (fileInfo.isFile())
+        {
+            filesSize += fileInfo.size();
+        }
+        else if (fileInfo.isDir())
+        {
+            subdirs.append(name);
+        }
+    }
+#endif
+}
+
+// Must be called with mListingCacheMutex locked
+void DirectoryWalker::loadListingCache()
+{
+    if (mListingCacheLoaded)
+    {
+        return;
+    }
+
+    QString dataPath = Preferences::instance()->getDataPath();
+    if (dataPath.isEmpty())
+    {
+        return;
+    }
+    mListingCacheLoaded = true;
+    mListingCacheFile = dataPath + QLatin1Char('/') + CACHE_FILE_NAME;
+    QFile::remove(dataPath + QLatin1Char('/') + OLD_CACHE_FILE_NAME);
+
+    QFile file(mListingCacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION)
+    {
+        return;
+    }
+
+    qint32 count = 0;
+    stream >> count;
+    mListingCache.reserve(count);
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        QString path;
+        DirListing info;
+        stream >> path >> info.mtimeNs >> info.files >> info.subdirs;
+        mListingCache.insert(path, info);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        mListingCache.clear();
+    }
+}
+
+void DirectoryWalker::saveListingCache()
+{
+    QByteArray data;
+    QString cacheFile;
+    {
+        std::lock_guard<std::mutex> lock(mListingCacheMutex);
+        if (!mListingCacheDirty || mListingCacheFile.isEmpty())
+        {
+            return;
+        }
+        mListingCacheDirty = false;
+        cacheFile = mListingCacheFile;
+
+        if (mListingCache.size() > MAX_CACHED_DIRECTORIES)
+        {
+            mListingCache.clear();
+        }
+
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << CACHE_FILE_MAGIC << CACHE_FILE_VERSION << static_cast<qint32>(mListingCache.size());
+        for (auto it = mListingCache.constBegin(); it != mListingCache.constEnd(); ++it)
+        {
+            stream << it.key() << it->mtimeNs << it->files << it->subdirs;
+        }
+    }
+
+    QSaveFile file(cacheFile);
+    if (file.open(QIODevice::WriteOnly))
+    {
+        file.write(data);
+        file.commit();
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef DIRECTORYWALKER_H
+#define DIRECTORYWALKER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+#include <memory>
+#include <mutex>
+
+// Walks local folders (mainly the sync debris folders) to compute their size or list them.
+// On Linux directories are read with getdents64 and entries are stat'ed with statx relative to
+// the directory descriptor, so no QFileInfo is built per file. Sizes are computed by a bounded
+// set of worker threads. The listing of every directory is kept in a persistent cache which is
+// only trusted while the directory mtime is unchanged; file sizes are not cached, because
+// rewriting a file does not touch the mtime of its directory, so files are stat'ed on every walk.
+// Symbolic links are followed, like QFileInfo does.
+class DirectoryWalker
+{
+public:
+    struct Entry
+    {
+        QString name;
+        bool isDir = false;
+        long long size = 0;
+        // Seconds since epoch: birth time when the filesystem reports it, status change otherwise
+        qint64 creationTime = 0;
+    };
+
+    static DirectoryWalker* instance();
+    ~DirectoryWalker() = default;
+
+    long long getFolderSize(const QString& folderPath);
+    long long getFoldersSize(const QStringList& folderPaths);
+
+    // Direct children of folderPath, without "." and ".."
+    QVector<Entry> listEntries(const QString& folderPath);
+
+    // Drops the cached information of folderPath and everything below it
+    void invalidate(const QString& folderPath);
+
+    void saveListingCache();
+
+private:
+    struct DirListing
+    {
+        qint64 mtimeNs = 0;
+        // Entries that are not directories themselves: files and symbolic links
+        QStringList files;
+        QStringList subdirs;
+    };
+    struct WalkState;
+
+    DirectoryWalker() = default;
+
+    void walkWorker(WalkState* state);
+    bool scanDirectory(const QString& path, long long& filesSize, QStringList& subdirs);
+    void loadListingCache();
+
+    static bool getDirectoryMtime(const QString& path, qint64& mtimeNs);
+    static bool readDirectory(const QString& path, DirListing& info);
+    static void statFiles(const QString& path, const QStringList& files,
+                          long long& filesSize, QStringList& subdirs);
+
+    static std::unique_ptr<DirectoryWalker> mInstance;
+
+    std::mutex mListingCacheMutex;
+    QHash<QString, DirListing> mListingCache;
+    QString mListingCacheFile;
+    bool mListingCacheLoaded = false;
+    bool mListingCacheDirty = false;
+};
+
+#endif // DIRECTORYWALKER_H
@@ -1,8 +1,35 @@
 #include "ExportProcessor.h"
+#include "Utilities.h"
+
+#include <QPointer>
+#include <QSet>
+#include <QTimer>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
 
 using namespace mega;
 using namespace std;
 
+namespace
+{
+// Fingerprint jobs waiting for a slot, shared by all the processors
+std::mutex fingerprintJobsMutex;
+std::deque<std::function<void()>> pendingFingerprintJobs;
+int fingerprintJobsInFlight = 0;
+}
+
+struct ExportProcessor::ResolveBatch
+{
+    QStringList paths;
+    QVector<MegaHandle> handles;
+    // Local fingerprint of the paths that are not synced
+    QVector<QByteArray> fingerprints;
+    std::atomic<int> pendingJobs;
+    QPointer<ExportProcessor> processor;
+};
+
 ExportProcessor::ExportProcessor(MegaApi *megaApi, QStringList fileList) : QObject()
 {
     this->megaApi = megaApi;
@@ -13,6 +40,8 @@ ExportProcessor::ExportProcessor(MegaApi *megaApi, QStringList fileList) : QObje
     remainingNodes = fileList.size();
     importSuccess = 0;
     importFailed = 0;
+    mNextExport = 0;
+    mRequestsInFlight = 0;
 
     delegateListener = new QTMegaRequestListener(megaApi, this);
 }
@@ -27,6 +56,8 @@ ExportProcessor::ExportProcessor(MegaApi *megaApi, QList<MegaHandle> handleList)
     remainingNodes = handleList.size();
     importSuccess = 0;
     importFailed = 0;
+    mNextExport = 0;
+    mRequestsInFlight = 0;
 
     delegateListener = new QTMegaRequestListener(megaApi, this);
 }
@@ -41,66 +72,224 @@ void ExportProcessor::requestLinks()
     int size = (mode == MODE_PATHS) ? fileList.size() : handleList.size();
     if (!size)
     {
-        emit onRequestLinksFinished();
+        emitFinished();
+        return;
+    }
+
+    if (mode == MODE_HANDLES)
+    {
+        onHandlesResolved(handleList.toVector());
         return;
     }
 
-    for (int i = 0; i < size; i++)
+    auto batch = std::make_shared<ResolveBatch>();
+    batch->paths = fileList;
+    batch->handles.fill(INVALID_HANDLE, size);
+    batch->fingerprints.resize(size);
+    batch->processor = this;
+
+    int jobs = (size + FINGERPRINT_CHUNK_SIZE - 1) / FINGERPRINT_CHUNK_SIZE;
+    batch->pendingJobs = jobs;
+    for (int begin = 0; begin < size; begin += FINGERPRINT_CHUNK_SIZE)
     {
-        MegaNode *node = NULL;
-        if (mode == MODE_PATHS)
+        int end = qMin(begin + FINGERPRINT_CHUNK_SIZE, size);
+        MegaApi *api = megaApi;
+        scheduleFingerprintJob([api, batch, begin, end]()
         {
-    #ifdef WIN32
-            if (!fileList[i].startsWith(QString::fromAscii("\\\\")))
-            {
-                fileList[i].insert(0, QString::fromAscii("\\\\?\\"));
-            }
+            resolveRange(api, batch, begin, end);
+        });
+    }
+}
 
-            string tmpPath((const char*)fileList[i].utf16(), fileList[i].size()*sizeof(wchar_t));
-    #else
-            string tmpPath((const char*)fileList[i].toUtf8().constData());
-    #endif
+QStringList ExportProcessor::getValidLinks()
+{
+    return validPublicLinks;
+}
 
-            node = megaApi->getSyncedNode(&tmpPath);
-            if (!node)
+void ExportProcessor::onRequestFinish(MegaApi *, MegaRequest *request, MegaError *e)
+{
+    mRequestsInFlight--;
+    if (e->getErrorCode() == MegaError::API_OK && request->getLink())
+    {
+        mLinksByHandle.insert(request->getNodeHandle(), QString::fromAscii(request->getLink()));
+    }
+
+    exportPendingNodes();
+}
+
+string ExportProcessor::toLocalPath(QString path)
+{
+#ifdef WIN32
+    if (!path.startsWith(QString::fromAscii("\\\\")))
+    {
+        path.insert(0, QString::fromAscii("\\\\?\\"));
+    }
+
+    return string((const char*)path.utf16(), path.size()*sizeof(wchar_t));
+#else
+    return string((const char*)path.toUtf8().constData());
+#endif
+}
+
+void ExportProcessor::scheduleFingerprintJob(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(fingerprintJobsMutex);
+        if (fingerprintJobsInFlight >= MAX_FINGERPRINT_JOBS)
+        {
+            pendingFingerprintJobs.push_back(std::move(job));
+            return;
+        }
+        fingerprintJobsInFlight++;
+    }
+
+    ThreadPoolSingleton::getInstance()->push([job]()
+    {
+        runFingerprintJobs(job);
+    });
+}
+
+// Runs job and then the queued ones, keeping its slot until the queue is empty
+void ExportProcessor::runFingerprintJobs(std::function<void()> job)
+{
+    for (;;)
+    {
+        job();
+
+        std::lock_guard<std::mutex> lock(fingerprintJobsMutex);
+        if (pendingFingerprintJobs.empty())
+        {
+            fingerprintJobsInFlight--;
+            return;
+        }
+        job = std::move(pendingFingerprintJobs.front());
+        pendingFingerprintJobs.pop_front();
+    }
+}
+
+void ExportProcessor::resolveRange(MegaApi *megaApi, std::shared_ptr<ResolveBatch> batch, int begin, int end)
+{
+    // Only read through const access: the list is shared with fileList and several jobs run
+    // at once, so a detach here would race
+    const QStringList& paths = batch->paths;
+    for (int i = begin; i < end && !ThreadPool::isThreadInterrupted(); i++)
+    {
+        string tmpPath = toLocalPath(paths.at(i));
+        std::unique_ptr<MegaNode> node(megaApi->getSyncedNode(&tmpPath));
+        if (node)
+        {
+            batch->handles[i] = node->getHandle();
+            continue;
+        }
+
+        std::unique_ptr<char[]> fpLocal(megaApi->getFingerprint(tmpPath.c_str()));
+        if (fpLocal)
+        {
+            batch->fingerprints[i] = QByteArray(fpLocal.get());
+        }
+    }
+
+    // The last job to finish looks up the fingerprints and hands the result to the app thread
+    if (batch->pendingJobs.fetch_sub(1) == 1)
+    {
+        resolveFingerprints(megaApi, *batch);
+        Utilities::queueFunctionInAppThread([batch]()
+        {
+            if (batch->processor)
             {
-                const char *fpLocal = megaApi->getFingerprint(tmpPath.c_str());
-                node = megaApi->getNodeByFingerprint(fpLocal);
-                delete [] fpLocal;
+                batch->processor->onHandlesResolved(batch->handles);
             }
+        });
+    }
+}
+
+void ExportProcessor::resolveFingerprints(MegaApi *megaApi, ResolveBatch& batch)
+{
+    // Identical files share a fingerprint, look each one up only once
+    QHash<QByteArray, MegaHandle> nodesByFingerprint;
+    for (int i = 0; i < batch.fingerprints.size(); i++)
+    {
+        const QByteArray& fingerprint = batch.fingerprints.at(i);
+        if (fingerprint.isEmpty())
+        {
+            continue;
         }
-        else
+
+        auto it = nodesByFingerprint.constFind(fingerprint);
+        if (it == nodesByFingerprint.constEnd())
         {
-            node = megaApi->getNodeByHandle(handleList[i]);
+            std::unique_ptr<MegaNode> node(megaApi->getNodeByFingerprint(fingerprint.constData()));
+            it = nodesByFingerprint.insert(fingerprint, node ? node->getHandle() : INVALID_HANDLE);
         }
-        megaApi->exportNode(node, delegateListener);
-        delete node;
+        batch.handles[i] = it.value();
     }
 }
 
-QStringList ExportProcessor::getValidLinks()
+void ExportProcessor::onHandlesResolved(const QVector<MegaHandle>& handles)
 {
-    return validPublicLinks;
+    mHandles = handles;
+
+    QSet<MegaHandle> queued;
+    for (MegaHandle handle : mHandles)
+    {
+        if (handle != INVALID_HANDLE && !queued.contains(handle))
+        {
+            queued.insert(handle);
+            mPendingExports.append(handle);
+        }
+    }
+
+    exportPendingNodes();
 }
 
-void ExportProcessor::onRequestFinish(MegaApi *, MegaRequest *request, MegaError *e)
+void ExportProcessor::exportPendingNodes()
 {
-    currentIndex++;
-    remainingNodes--;
-    if (e->getErrorCode() != MegaError::API_OK)
+    while (mRequestsInFlight < MAX_REQUESTS_IN_FLIGHT && mNextExport < mPendingExports.size())
+    {
+        std::unique_ptr<MegaNode> node(megaApi->getNodeByHandle(mPendingExports.at(mNextExport++)));
+        if (!node)
+        {
+            continue;
+        }
+
+        mRequestsInFlight++;
+        megaApi->exportNode(node.get(), delegateListener);
+    }
+
+    if (!mRequestsInFlight && mNextExport >= mPendingExports.size())
     {
-        publicLinks.append(QString());
-        importFailed++;
+        finish();
     }
-    else
+}
+
+void ExportProcessor::finish()
+{
+    for (MegaHandle handle : mHandles)
     {
-        publicLinks.append(QString::fromAscii(request->getLink()));
-        validPublicLinks.append(QString::fromAscii(request->getLink()));
-        importSuccess++;
+        QString link = mLinksByHandle.value(handle);
+        currentIndex++;
+        remainingNodes--;
+        publicLinks.append(link);
+        if (link.isEmpty())
+        {
+            importFailed++;
+        }
+        else
+        {
+            validPublicLinks.append(link);
+            importSuccess++;
+        }
     }
 
-    if (!remainingNodes)
+    emitFinished();
+}
+
+// Callers start counting the operation after requestLinks returns,
+// so the result is never delivered from within that call
+void ExportProcessor::emitFinished()
+{
+    QTimer::singleShot(0, this, [this]()
     {
         emit onRequestLinksFinished();
-    }
+    });
 }
@@ -2,9 +2,19 @@
 #define EXPORTPROCESSOR_H
 
 #include <QStringList>
+#include <QHash>
+#include <QVector>
 #include <megaapi.h>
 #include <QTMegaRequestListener.h>
 
+#include <functional>
+#include <memory>
+
+// Exports public links for a batch of local paths or node handles.
+// Local paths are fingerprinted in chunks on the thread pool, with a bounded number of chunks
+// running at once across all processors. Each distinct fingerprint of a batch is looked up
+// only once, by the last chunk to finish. Each distinct node is exported once, with a
+// bounded number of requests in flight, and links are returned in input order.
 class ExportProcessor :  public QObject, public mega::MegaRequestListener
 {
     Q_OBJECT
@@ -28,6 +38,24 @@ protected:
         MODE_HANDLES
     };
 
+    static const int MAX_REQUESTS_IN_FLIGHT = 16;
+    // Shared by all the processors, so the rest of the thread pool stays available
+    static const int MAX_FINGERPRINT_JOBS = 2;
+    static const int FINGERPRINT_CHUNK_SIZE = 64;
+
+    struct ResolveBatch;
+
+    static std::string toLocalPath(QString path);
+    static void scheduleFingerprintJob(std::function<void()> job);
+    static void runFingerprintJobs(std::function<void()> job);
+    static void resolveRange(mega::MegaApi *megaApi, std::shared_ptr<ResolveBatch> batch, int begin, int end);
+    static void resolveFingerprints(mega::MegaApi *megaApi, ResolveBatch& batch);
+
+    void onHandlesResolved(const QVector<mega::MegaHandle>& handles);
+    void exportPendingNodes();
+    void finish();
+    void emitFinished();
+
     mega::MegaApi *megaApi;
     QStringList fileList;
     QList<mega::MegaHandle> handleList;
@@ -39,6 +67,14 @@ protected:
     int importFailed;
     int mode;
     mega::QTMegaRequestListener *delegateListener;
+
+    // Node handle for each input, INVALID_HANDLE if it could not be resolved
+    QVector<mega::MegaHandle> mHandles;
+    // Distinct nodes still to be exported, in first appearance order
+    QVector<mega::MegaHandle> mPendingExports;
+    int mNextExport;
+    int mRequestsInFlight;
+    QHash<mega::MegaHandle, QString> mLinksByHandle;
 };
 
 #endif // EXPORTPROCESSOR_H
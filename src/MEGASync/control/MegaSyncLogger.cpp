@@ -1,5 +1,6 @@
 ﻿#include "MegaSyncLogger.h"
 #include "Utilities.h"
+#include "LogRecord.h"
 
 #include <fstream>
 #include <iostream>
@@ -14,7 +15,9 @@
 #include <QFile>
 
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <thread>
 #include <condition_variable>
 
@@ -27,9 +30,11 @@
 #include <windows.h>
 #endif
 
-//#define MEGA_LOGGER QString::fromUtf8("MEGA_LOGGER")
-//#define ENABLE_MEGASYNC_LOGS QString::fromUtf8("MEGA_ENABLE_LOGS")
+#define MEGA_LOGGER QString::fromUtf8("MEGA_LOGGER")
+#define ENABLE_MEGASYNC_LOGS QString::fromUtf8("MEGA_ENABLE_LOGS")
 #define MAX_MESSAGE_SIZE 4096
+#define MAX_VIEWER_QUEUED_BYTES (8 * 1024 * 1024)   // if MEGAlogger can't keep up, lines are dropped
+#define VIEWER_SEND_PERIOD_MS 100
 
 #define LOG_TIME_CHARS 22
 #define LOG_LEVEL_CHARS 5
@@ -158,6 +163,7 @@ struct LoggingThread
     std::mutex logRotationMutex;
     LogLinkedList logListFirst;
     LogLinkedList* logListLast = &logListFirst;
+    std::atomic<long long> queuedBytes {0}; // allocated by entries waiting to be written
     bool logExit = false;
     bool flushLog = false;
     bool closeLog = false;
@@ -169,6 +175,12 @@ struct LoggingThread
     std::chrono::seconds logFlushPeriod = std::chrono::seconds(10);
     std::chrono::steady_clock::time_point nextFlushTime = std::chrono::steady_clock::now() + logFlushPeriod;
 
+    // Records for MEGAlogger, in the format read by src/MEGALogger/LogRecord.h
+    std::atomic<bool> viewerConnected {false};
+    std::mutex viewerMutex;
+    QByteArray viewerRecords;
+    unsigned viewerDroppedRecords = 0;
+
     void startLoggingThread(QString filename, QString desktopFilename)
     {
         if (!logThread)
@@ -182,6 +194,9 @@ struct LoggingThread
     void log(int loglevel, const char *message, const char **directMessages = nullptr, size_t *directMessagesSizes = nullptr, int numberMessages = 0);
 
 private:
+    void appendViewerRecord(std::chrono::system_clock::time_point time, int loglevel, const char *message,
+                            const char **directMessages, size_t *directMessagesSizes, int numberMessages);
+
     QString numberedLogFilename(QString baseName, int logNumber)
     {
         QString newName = baseName;
@@ -393,6 +408,7 @@ private:
                     std::cout << std::flush; //always flush into stdout (DEBUG mode)
                 }
                 p->notifyWaiter();
+                queuedBytes -= p->allocated;
                 free(p);
             }
             if (flushLog || forceRotationForReporting || nextFlushTime <= std::chrono::steady_clock::now())
@@ -581,6 +597,11 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
     auto microsec = std::chrono::duration_cast<std::chrono::microseconds>(now - std::chrono::system_clock::from_time_t(t));
     filltime(timebuf, &gmt, (int)microsec.count() % 1000000);
 
+    if (viewerConnected)
+    {
+        appendViewerRecord(now, loglevel, message, directMessages, directMessagesSizes, numberMessages);
+    }
+
     const char* loglevelstring = "     ";
     switch (loglevel) // keeping these at 4 chars makes nice columns, easy to read
     {
@@ -622,6 +643,7 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
                 if (LogLinkedList* newentry = LogLinkedList::create(logListLast, 1 + sizeof(LogLinkedList))) //create a new "empty" element
                 {
                     logListLast = newentry;
+                    queuedBytes += newentry->allocated;
                     std::promise<void> promise;
                     logListLast->mCompletionPromise = &promise;
                     auto future = logListLast->mCompletionPromise->get_future();
@@ -659,6 +681,7 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
                     if (LogLinkedList* newentry = LogLinkedList::create(logListLast, std::max<size_t>(lineLen, 8192) + sizeof(LogLinkedList) + 10))
                     {
                         logListLast = newentry;
+                        queuedBytes += newentry->allocated;
                     }
                     else
                     {
@@ -701,10 +724,143 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
     }
 }
 
+void LoggingThread::appendViewerRecord(std::chrono::system_clock::time_point time, int loglevel, const char *message,
+                                       const char **directMessages, size_t *directMessagesSizes, int numberMessages)
+{
+    LogRecord record;
+    record.time = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    record.level = loglevel;
+    record.threadId = static_cast<quint64>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    if (directMessages)
+    {
+        size_t remaining = MAX_MESSAGE_SIZE;
+        for (int i = 0; i < numberMessages && remaining; i++)
+        {
+            size_t n = std::min(remaining, directMessagesSizes[i]);
+            record.message.append(directMessages[i], static_cast<int>(n));
+            remaining -= n;
+        }
+    }
+    else
+    {
+        record.message = QByteArray(message, static_cast<int>(std::min<size_t>(strlen(message), MAX_MESSAGE_SIZE)));
+    }
+
+    std::lock_guard<std::mutex> g(viewerMutex);
+    if (viewerRecords.size() + LogRecordStream::SIZE_BYTES + LogRecordStream::HEADER_BYTES + record.message.size()
+            > MAX_VIEWER_QUEUED_BYTES)
+    {
+        viewerDroppedRecords++;
+        return;
+    }
+    LogRecordStream::appendRecord(viewerRecords, record);
+}
+
 void MegaSyncLogger::setDebug(const bool enable)
 {
     g_loggingThread->logToDesktop = enable;
     g_loggingThread->logToDesktopChanged = true;
+
+    // MEGAlogger can only get the log in debug mode
+    if (enable && !mViewerRequests)
+    {
+        QLocalServer::removeServer(ENABLE_MEGASYNC_LOGS);
+        mViewerRequests = new QLocalServer(this);
+        mViewerRequests->setSocketOptions(QLocalServer::UserAccessOption);
+        if (!mViewerRequests->listen(ENABLE_MEGASYNC_LOGS))
+        {
+            delete mViewerRequests;
+            mViewerRequests = nullptr;
+            return;
+        }
+        connect(mViewerRequests, &QLocalServer::newConnection, this, &MegaSyncLogger::onViewerRequest);
+    }
+    else if (!enable && mViewerRequests)
+    {
+        delete mViewerRequests;
+        mViewerRequests = nullptr;
+        if (mViewerSocket)
+        {
+            mViewerSocket->abort();
+        }
+    }
+}
+
+void MegaSyncLogger::onViewerRequest()
+{
+    while (QLocalSocket* request = mViewerRequests->nextPendingConnection())
+    {
+        request->disconnectFromServer();
+        request->deleteLater();
+    }
+
+    if (mViewerSocket)
+    {
+        return;
+    }
+
+    mViewerSocket = new QLocalSocket(this);
+    connect(mViewerSocket, &QLocalSocket::connected, this, &MegaSyncLogger::onViewerConnected);
+    connect(mViewerSocket, &QLocalSocket::disconnected, this, &MegaSyncLogger::onViewerDisconnected);
+    connect(mViewerSocket, static_cast<void (QLocalSocket::*)(QLocalSocket::LocalSocketError)>(&QLocalSocket::error),
+            this, &MegaSyncLogger::onViewerDisconnected);
+    mViewerSocket->connectToServer(MEGA_LOGGER);
+}
+
+void MegaSyncLogger::onViewerConnected()
+{
+    g_loggingThread->viewerConnected = true;
+    connect(&mViewerTimer, &QTimer::timeout, this, &MegaSyncLogger::sendViewerRecords, Qt::UniqueConnection);
+    mViewerTimer.start(VIEWER_SEND_PERIOD_MS);
+}
+
+void MegaSyncLogger::onViewerDisconnected()
+{
+    if (!mViewerSocket)
+    {
+        return;
+    }
+
+    g_loggingThread->viewerConnected = false;
+    mViewerTimer.stop();
+    {
+        std::lock_guard<std::mutex> g(g_loggingThread->viewerMutex);
+        g_loggingThread->viewerRecords.clear();
+        g_loggingThread->viewerDroppedRecords = 0;
+    }
+
+    mViewerSocket->deleteLater();
+    mViewerSocket = nullptr;
+}
+
+void MegaSyncLogger::sendViewerRecords()
+{
+    QByteArray records;
+    unsigned dropped = 0;
+    {
+        std::lock_guard<std::mutex> g(g_loggingThread->viewerMutex);
+        records.swap(g_loggingThread->viewerRecords);
+        std::swap(dropped, g_loggingThread->viewerDroppedRecords);
+    }
+
+    if (mViewerSocket && !records.isEmpty())
+    {
+        // MEGAlogger is not reading fast enough, don't let the socket buffer grow
+        if (mViewerSocket->bytesToWrite() > MAX_VIEWER_QUEUED_BYTES)
+        {
+            dropped += static_cast<unsigned>(LogRecordStream::countRecords(records));
+        }
+        else
+        {
+            mViewerSocket->write(records);
+        }
+    }
+
+    if (dropped)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING,
+                           QString::fromUtf8("%1 log lines were not sent to MEGAlogger").arg(dropped).toUtf8().constData());
+    }
 }
 
 bool MegaSyncLogger::isDebug() const
@@ -712,6 +868,11 @@ bool MegaSyncLogger::isDebug() const
     return g_loggingThread->logToDesktop;
 }
 
+long long MegaSyncLogger::getQueuedBytes() const
+{
+    return g_loggingThread->queuedBytes;
+}
+
 bool MegaSyncLogger::prepareForReporting()
 {
     std::lock_guard<std::mutex> g(g_loggingThread->logMutex);
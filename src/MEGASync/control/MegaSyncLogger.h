@@ -6,7 +6,7 @@
 
 #include <QLocalSocket>
 #include <QLocalServer>
-#include <QXmlStreamWriter>
+#include <QTimer>
 
 #include "megaapi.h"
 
@@ -27,6 +27,8 @@ public:
              ) override;
     void setDebug(bool enable);
     bool isDebug() const;
+    // Memory held by log lines not yet written by the logging thread
+    long long getQueuedBytes() const;
     bool mLogToStdout = false;
 
     // this one is called on signal (flush log before crash report)
@@ -47,9 +49,20 @@ signals:
     void logReadyForReporting();
     void logCleaned();
 
+private slots:
+    // MEGAlogger knocks on MEGA_ENABLE_LOGS to have the log sent to its MEGA_LOGGER server
+    void onViewerRequest();
+    void onViewerConnected();
+    void onViewerDisconnected();
+    void sendViewerRecords();
+
 private:
     QString mDesktopPath;
     std::unique_ptr<LoggingThread> g_loggingThread;
+
+    QLocalServer* mViewerRequests = nullptr;
+    QLocalSocket* mViewerSocket = nullptr;
+    QTimer mViewerTimer;
 };
 
 extern MegaSyncLogger *g_megaSyncLogger;   // for crash report flush
@@ -0,0 +1,251 @@
+#include "StartupOrchestrator.h"
+
+#include "megaapi.h"
+
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+
+using namespace mega;
+
+StartupOrchestrator::StartupOrchestrator(QObject* parent)
+    : QObject(parent),
+      mDeferredPosted(false),
+      mFinished(false)
+{
+    mClock.start();
+}
+
+StartupOrchestrator::~StartupOrchestrator()
+{
+    waitForBackgroundPhases();
+}
+
+void StartupOrchestrator::addPhase(const QString& name, Mode mode, const QStringList& dependencies, std::function<void()> run)
+{
+    std::unique_ptr<Phase> phase(new Phase());
+    phase->name = name;
+    phase->mode = mode;
+    phase->run = std::move(run);
+
+    for (const auto& dependency : dependencies)
+    {
+        if (findPhase(dependency))
+        {
+            phase->dependencies.append(dependency);
+        }
+        else
+        {
+            MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Startup phase %1 depends on unknown phase %2")
+                         .arg(name, dependency).toUtf8().constData());
+        }
+    }
+
+    mPhases.push_back(std::move(phase));
+    mFinished = false;
+}
+
+void StartupOrchestrator::recordPhase(const QString& name, qint64 startMs, qint64 durationMs)
+{
+    std::unique_ptr<Phase> phase(new Phase());
+    phase->name = name;
+    phase->mode = IMMEDIATE;
+    phase->state = DONE;
+    phase->startMs = startMs;
+    phase->durationMs = durationMs;
+    mPhases.push_back(std::move(phase));
+}
+
+void StartupOrchestrator::run()
+{
+    schedule();
+}
+
+bool StartupOrchestrator::isDone(const QString& name) const
+{
+    auto phase = findPhase(name);
+    return phase && phase->state == DONE;
+}
+
+void StartupOrchestrator::waitForBackgroundPhases()
+{
+    for (const auto& phase : mPhases)
+    {
+        if (phase->watcher)
+        {
+            phase->watcher->waitForFinished();
+        }
+    }
+}
+
+qint64 StartupOrchestrator::elapsed() const
+{
+    return mClock.elapsed();
+}
+
+void StartupOrchestrator::runNextDeferred()
+{
+    mDeferredPosted = false;
+
+    auto next = std::find_if(mPhases.begin(), mPhases.end(), [this](const std::unique_ptr<Phase>& phase)
+    {
+        return phase->mode == DEFERRED && isReady(*phase);
+    });
+    if (next != mPhases.end())
+    {
+        runOnThisThread(**next);
+    }
+    schedule();
+}
+
+StartupOrchestrator::Phase* StartupOrchestrator::findPhase(const QString& name) const
+{
+    auto it = std::find_if(mPhases.begin(), mPhases.end(), [&name](const std::unique_ptr<Phase>& phase)
+    {
+        return phase->name == name;
+    });
+    return it != mPhases.end() ? it->get() : nullptr;
+}
+
+bool StartupOrchestrator::isReady(const Phase& phase) const
+{
+    if (phase.state != PENDING)
+    {
+        return false;
+    }
+    return std::all_of(phase.dependencies.begin(), phase.dependencies.end(), [this](const QString& dependency)
+    {
+        return isDone(dependency);
+    });
+}
+
+void StartupOrchestrator::runOnThisThread(Phase& phase)
+{
+    phase.state = RUNNING;
+    phase.startMs = mClock.elapsed();
+    phase.run();
+    phase.durationMs = mClock.elapsed() - phase.startMs;
+    phase.state = DONE;
+}
+
+void StartupOrchestrator::startInBackground(Phase& phase)
+{
+    phase.state = RUNNING;
+    phase.ranOnWorker = true;
+    phase.startMs = mClock.elapsed();
+
+    phase.watcher.reset(new QFutureWatcher<void>());
+    Phase* phasePtr = &phase;
+    connect(phase.watcher.get(), &QFutureWatcher<void>::finished, this, [this, phasePtr]()
+    {
+        onBackgroundFinished(*phasePtr);
+        schedule();
+    });
+
+    auto run = phase.run;
+    phase.watcher->setFuture(QtConcurrent::run([run]()
+    {
+        run();
+    }));
+}
+
+void StartupOrchestrator::onBackgroundFinished(Phase& phase)
+{
+    phase.durationMs = mClock.elapsed() - phase.startMs;
+    phase.state = DONE;
+}
+
+void StartupOrchestrator::schedule()
+{
+    bool progress = true;
+    while (progress)
+    {
+        progress = false;
+        for (const auto& phase : mPhases)
+        {
+            if (!isReady(*phase))
+            {
+                continue;
+            }
+
+            if (phase->mode == IMMEDIATE)
+            {
+                runOnThisThread(*phase);
+                progress = true;
+            }
+            else if (phase->mode == BACKGROUND)
+            {
+                startInBackground(*phase);
+            }
+            else if (phase->mode == DEFERRED && !mDeferredPosted)
+            {
+                mDeferredPosted = true;
+                QTimer::singleShot(0, this, &StartupOrchestrator::runNextDeferred);
+            }
+        }
+    }
+
+    checkFinished();
+}
+
+void StartupOrchestrator::checkFinished()
+{
+    if (mFinished)
+    {
+        return;
+    }
+
+    const bool pending = std::any_of(mPhases.begin(), mPhases.end(), [](const std::unique_ptr<Phase>& phase)
+    {
+        return phase->state != DONE;
+    });
+    if (!pending)
+    {
+        mFinished = true;
+        logTimeline();
+        emit finished();
+    }
+}
+
+void StartupOrchestrator::logTimeline() const
+{
+    std::vector<const Phase*> phases;
+    for (const auto& phase : mPhases)
+    {
+        if (phase->state == DONE)
+        {
+            phases.push_back(phase.get());
+        }
+    }
+    std::stable_sort(phases.begin(), phases.end(), [](const Phase* a, const Phase* b)
+    {
+        return a->startMs < b->startMs;
+    });
+
+    QString timeline = QString::fromUtf8("Startup timeline (%1 ms):\n").arg(mClock.elapsed());
+    for (auto phase : phases)
+    {
+        timeline += QString::fromUtf8("%1 %2 %3 start: %4 ms duration: %5 ms\n")
+                .arg(phase->name, -24)
+                .arg(modeName(phase->mode), -10)
+                .arg(phase->ranOnWorker ? QString::fromUtf8("worker") : QString::fromUtf8("gui"), -6)
+                .arg(phase->startMs, 6)
+                .arg(phase->durationMs, 6);
+    }
+    MegaApi::log(MegaApi::LOG_LEVEL_INFO, timeline.toUtf8().constData());
+}
+
+QString StartupOrchestrator::modeName(Mode mode)
+{
+    switch (mode)
+    {
+        case IMMEDIATE:
+            return QString::fromUtf8("immediate");
+        case BACKGROUND:
+            return QString::fromUtf8("background");
+        case DEFERRED:
+            return QString::fromUtf8("deferred");
+    }
+    return QString();
+}
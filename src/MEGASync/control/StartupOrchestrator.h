@@ -0,0 +1,95 @@
+#ifndef STARTUPORCHESTRATOR_H
+#define STARTUPORCHESTRATOR_H
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Runs the initialization of the application as named phases which depend on each other.
+// A phase starts once all its dependencies finished, either right away on the GUI thread,
+// on a worker thread or once the event loop is running.
+// The start and the duration of every phase are recorded, and the whole timeline is logged
+// once all the phases finished.
+class StartupOrchestrator : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode
+    {
+        // On the GUI thread, as soon as the dependencies finish
+        IMMEDIATE = 0,
+        // On a worker thread. It must not touch the GUI nor the application state without locking
+        BACKGROUND,
+        // On the GUI thread once the event loop runs, one phase per event loop iteration
+        DEFERRED
+    };
+
+    explicit StartupOrchestrator(QObject* parent = nullptr);
+    ~StartupOrchestrator();
+
+    // Dependencies must be added before the phases depending on them
+    void addPhase(const QString& name, Mode mode, const QStringList& dependencies, std::function<void()> run);
+    // Adds to the timeline a phase which ran outside the orchestrator
+    void recordPhase(const QString& name, qint64 startMs, qint64 durationMs);
+
+    // Runs the phases which are ready. Called again after adding new phases
+    void run();
+    bool isDone(const QString& name) const;
+    // Waits for the background phases which are running
+    void waitForBackgroundPhases();
+
+    // Ms since the orchestrator was created
+    qint64 elapsed() const;
+
+signals:
+    // All the phases added so far finished
+    void finished();
+
+private slots:
+    void runNextDeferred();
+
+private:
+    enum State
+    {
+        PENDING = 0,
+        RUNNING,
+        DONE
+    };
+
+    struct Phase
+    {
+        QString name;
+        Mode mode;
+        QStringList dependencies;
+        std::function<void()> run;
+        State state = PENDING;
+        qint64 startMs = -1;
+        qint64 durationMs = 0;
+        bool ranOnWorker = false;
+        std::unique_ptr<QFutureWatcher<void>> watcher;
+    };
+
+    Phase* findPhase(const QString& name) const;
+    bool isReady(const Phase& phase) const;
+    void runOnThisThread(Phase& phase);
+    void startInBackground(Phase& phase);
+    void onBackgroundFinished(Phase& phase);
+    void schedule();
+    void checkFinished();
+    void logTimeline() const;
+    static QString modeName(Mode mode);
+
+    std::vector<std::unique_ptr<Phase>> mPhases;
+    QElapsedTimer mClock;
+    bool mDeferredPosted;
+    bool mFinished;
+};
+
+#endif // STARTUPORCHESTRATOR_H
@@ -0,0 +1,213 @@
+#include "TaskScheduler.h"
+
+#include "megaapi.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace mega;
+
+namespace
+{
+constexpr int TIMING_TABLE_INTERVAL_MS = 3600000;
+}
+
+TaskScheduler::TaskScheduler(QObject* parent)
+    : QObject(parent),
+      mRunning(false),
+      mRandom(std::random_device()())
+{
+    mClock.start();
+    mTimer.setSingleShot(true);
+    mTimer.setTimerType(Qt::CoarseTimer);
+    connect(&mTimer, &QTimer::timeout, this, &TaskScheduler::onTimeout);
+
+    // Its own timer, so the table is logged while no task is due too
+    mTableTimer.setInterval(TIMING_TABLE_INTERVAL_MS);
+    mTableTimer.setTimerType(Qt::CoarseTimer);
+    connect(&mTableTimer, &QTimer::timeout, this, &TaskScheduler::logTimingTable);
+}
+
+void TaskScheduler::addTask(const Task& task)
+{
+    TaskState state;
+    state.task = task;
+    state.nextRun = mClock.elapsed() + (task.firstRunMs >= 0 ? task.firstRunMs : nextPeriod(task));
+    mTasks.append(state);
+
+    if (mRunning)
+    {
+        scheduleNext();
+    }
+}
+
+void TaskScheduler::start()
+{
+    mRunning = true;
+    mTableTimer.start();
+    scheduleNext();
+}
+
+void TaskScheduler::stop()
+{
+    mRunning = false;
+    mTimer.stop();
+    mTableTimer.stop();
+}
+
+void TaskScheduler::markDirty(const QString& name)
+{
+    const int index = findTask(name);
+    if (index >= 0 && !mTasks[index].dirty)
+    {
+        mTasks[index].dirty = true;
+        if (mRunning)
+        {
+            scheduleNext();
+        }
+    }
+}
+
+void TaskScheduler::runNow(const QString& name)
+{
+    const int index = findTask(name);
+    if (index >= 0 && !mTasks[index].done)
+    {
+        run(index);
+        if (mRunning)
+        {
+            scheduleNext();
+        }
+    }
+}
+
+QString TaskScheduler::getTimingTable() const
+{
+    QString table = QString::fromUtf8("%1 %2 %3 %4 %5 %6\n")
+            .arg(QString::fromUtf8("task"), -24)
+            .arg(QString::fromUtf8("runs"), 8)
+            .arg(QString::fromUtf8("total ms"), 10)
+            .arg(QString::fromUtf8("mean ms"), 8)
+            .arg(QString::fromUtf8("max ms"), 8)
+            .arg(QString::fromUtf8("over budget"), 12);
+
+    for (const auto& state : mTasks)
+    {
+        table += QString::fromUtf8("%1 %2 %3 %4 %5 %6\n")
+                .arg(state.task.name, -24)
+                .arg(state.runs, 8)
+                .arg(state.totalMs, 10)
+                .arg(state.runs ? state.totalMs / state.runs : 0, 8)
+                .arg(state.maxMs, 8)
+                .arg(state.overBudget, 12);
+    }
+    return table;
+}
+
+void TaskScheduler::onTimeout()
+{
+    const qint64 now = mClock.elapsed();
+    // Only one task per timeout, the others due get their own event loop iteration
+    auto next = std::min_element(mTasks.begin(), mTasks.end(), [this](const TaskState& a, const TaskState& b)
+    {
+        if (isWaiting(a) != isWaiting(b))
+        {
+            return !isWaiting(a);
+        }
+        return a.nextRun < b.nextRun;
+    });
+
+    if (next != mTasks.end() && !isWaiting(*next) && next->nextRun <= now)
+    {
+        run(static_cast<int>(next - mTasks.begin()));
+    }
+
+    if (mRunning)
+    {
+        scheduleNext();
+    }
+}
+
+int TaskScheduler::findTask(const QString& name) const
+{
+    auto it = std::find_if(mTasks.cbegin(), mTasks.cend(), [&name](const TaskState& state)
+    {
+        return state.task.name == name;
+    });
+    return it != mTasks.cend() ? static_cast<int>(it - mTasks.cbegin()) : -1;
+}
+
+bool TaskScheduler::isWaiting(const TaskState& state) const
+{
+    return state.done || (state.task.onlyWhenDirty && !state.dirty);
+}
+
+void TaskScheduler::run(int index)
+{
+    mTasks[index].dirty = false;
+
+    // Copied, as the task may add others and move it while running
+    const std::function<void()> task = mTasks[index].task.run;
+    QElapsedTimer runtime;
+    runtime.start();
+    task();
+    const qint64 elapsed = runtime.elapsed();
+
+    TaskState& state = mTasks[index];
+    state.runs++;
+    state.totalMs += elapsed;
+    state.maxMs = std::max(state.maxMs, elapsed);
+    if (elapsed > state.task.budgetMs)
+    {
+        state.overBudget++;
+        MegaApi::log(MegaApi::LOG_LEVEL_WARNING,
+                     QString::fromUtf8("Periodic task %1 took %2 ms (budget: %3 ms)")
+                     .arg(state.task.name).arg(elapsed).arg(state.task.budgetMs).toUtf8().constData());
+    }
+
+    if (state.task.periodMs < 0)
+    {
+        state.done = true;
+    }
+    else
+    {
+        state.nextRun = mClock.elapsed() + nextPeriod(state.task);
+    }
+}
+
+qint64 TaskScheduler::nextPeriod(const Task& task)
+{
+    qint64 period = std::max(0, task.periodMs);
+    if (task.jitterMs > 0)
+    {
+        period += std::uniform_int_distribution<int>(0, task.jitterMs)(mRandom);
+    }
+    return period;
+}
+
+void TaskScheduler::scheduleNext()
+{
+    qint64 nextRun = std::numeric_limits<qint64>::max();
+    for (const auto& state : mTasks)
+    {
+        if (!isWaiting(state))
+        {
+            nextRun = std::min(nextRun, state.nextRun);
+        }
+    }
+
+    if (nextRun == std::numeric_limits<qint64>::max())
+    {
+        mTimer.stop();
+        return;
+    }
+
+    const qint64 delay = std::max<qint64>(0, nextRun - mClock.elapsed());
+    mTimer.start(static_cast<int>(std::min<qint64>(delay, std::numeric_limits<int>::max())));
+}
+
+void TaskScheduler::logTimingTable()
+{
+    MegaApi::log(MegaApi::LOG_LEVEL_INFO,
+                 (QString::fromUtf8("Periodic tasks timing:\n") + getTimingTable()).toUtf8().constData());
+}
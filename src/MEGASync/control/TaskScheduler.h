@@ -0,0 +1,84 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+#include <random>
+
+// Runs the periodic work of the application as named tasks, each one with its own period.
+// A random jitter is added to every period so that tasks do not land on the same event loop
+// iteration, and tasks that only make sense after something changed wait until markDirty is
+// called. A single timer is armed for the next task due, so nothing wakes up the process while
+// there is nothing to do.
+// The runtime of every task is measured: runs over the budget are logged as warnings, and a
+// table with the timings of all the tasks is logged periodically.
+class TaskScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Task
+    {
+        QString name;
+        std::function<void()> run;
+        int periodMs = 10000;
+        // Up to this many ms are added to each period
+        int jitterMs = 0;
+        int budgetMs = 50;
+        // Skipped until markDirty is called, and then run at most once per period
+        bool onlyWhenDirty = false;
+        // Delay of the first run, -1 for a full period. Negative periods run the task only once
+        int firstRunMs = -1;
+    };
+
+    explicit TaskScheduler(QObject* parent = nullptr);
+
+    void addTask(const Task& task);
+    void start();
+    void stop();
+
+    // Something the task depends on changed
+    void markDirty(const QString& name);
+    // Runs the task right away; its next run is a full period later
+    void runNow(const QString& name);
+
+    QString getTimingTable() const;
+
+private slots:
+    void onTimeout();
+
+private:
+    struct TaskState
+    {
+        Task task;
+        qint64 nextRun = 0;  // ms on mClock
+        bool dirty = false;
+        bool done = false;
+        int runs = 0;
+        int overBudget = 0;
+        qint64 totalMs = 0;
+        qint64 maxMs = 0;
+    };
+
+    // Tasks are referred to by index: a task may add others while it runs, moving the states
+    int findTask(const QString& name) const;
+    bool isWaiting(const TaskState& state) const;
+    void run(int index);
+    qint64 nextPeriod(const Task& task);
+    void scheduleNext();
+    void logTimingTable();
+
+    QVector<TaskState> mTasks;
+    QElapsedTimer mClock;
+    QTimer mTimer;
+    QTimer mTableTimer;
+    bool mRunning;
+    std::mt19937 mRandom;
+};
+
+#endif // TASKSCHEDULER_H
@@ -0,0 +1,288 @@
+#include "Tracer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Tracer::sEnabled(false);
+
+namespace
+{
+// Spans kept per thread, the oldest ones are overwritten
+constexpr uint64_t BUFFER_CAPACITY = 1 << 15;
+// Bytes of JSON accumulated before writing them to the file
+constexpr int WRITE_CHUNK_SIZE = 1 << 20;
+
+struct SpanRecord
+{
+    const char* name;
+    const char* category;
+    int64_t startUs;
+    int64_t durationUs;
+    int arg;
+};
+
+// Only written by the thread holding it. The spans are published by the release store of written
+struct ThreadBuffer
+{
+    std::vector<SpanRecord> spans;
+    std::atomic<uint64_t> written;
+    std::atomic<uint32_t> session;
+    // Increased every time the buffer is handed to another thread
+    std::atomic<uint32_t> generation;
+    // Guarded by gBuffersMutex
+    uint32_t threadId;
+    QString threadName;
+
+    ThreadBuffer() : spans(BUFFER_CAPACITY), written(0), session(0), generation(0), threadId(0) {}
+};
+
+// Pool threads expire and are recreated, so the buffers of finished threads are handed to the new
+// ones and no more than MAX_THREAD_BUFFERS are allocated
+constexpr size_t MAX_THREAD_BUFFERS = 32;
+
+std::mutex gBuffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> gBuffers;
+std::vector<ThreadBuffer*> gFreeBuffers;
+uint32_t gLastThreadId = 0;
+
+// Gives the buffer back when its thread finishes
+struct ThreadBufferOwner
+{
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadBufferOwner()
+    {
+        if (buffer)
+        {
+            std::lock_guard<std::mutex> lock(gBuffersMutex);
+            gFreeBuffers.push_back(buffer);
+        }
+    }
+};
+thread_local ThreadBufferOwner tBufferOwner;
+
+std::mutex gControlMutex;
+std::atomic<uint32_t> gSession(0);
+QString gFilePath;
+
+const std::chrono::steady_clock::time_point gEpoch = std::chrono::steady_clock::now();
+
+// Must be called with gBuffersMutex locked. Returns nullptr when the cap is reached and no buffer
+// is free
+ThreadBuffer* acquireBuffer(uint32_t session)
+{
+    // Prefer the free buffers holding no spans of the current trace, so they are not lost
+    auto freeIt = std::find_if(gFreeBuffers.begin(), gFreeBuffers.end(), [session](ThreadBuffer* buffer) {
+        return buffer->session.load(std::memory_order_relaxed) != session
+               || !buffer->written.load(std::memory_order_relaxed);
+    });
+    if (freeIt == gFreeBuffers.end() && gBuffers.size() < MAX_THREAD_BUFFERS)
+    {
+        gBuffers.emplace_back(new ThreadBuffer());
+        return gBuffers.back().get();
+    }
+    if (freeIt == gFreeBuffers.end() && !gFreeBuffers.empty())
+    {
+        freeIt = gFreeBuffers.begin();
+    }
+    if (freeIt == gFreeBuffers.end())
+    {
+        return nullptr;
+    }
+
+    ThreadBuffer* buffer = *freeIt;
+    gFreeBuffers.erase(freeIt);
+    return buffer;
+}
+
+ThreadBuffer* getThreadBuffer()
+{
+    if (!tBufferOwner.buffer)
+    {
+        QString threadName;
+        QThread* thread = QThread::currentThread();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+        {
+            threadName = QString::fromUtf8("GUI");
+        }
+        else if (thread)
+        {
+            threadName = thread->objectName();
+        }
+
+        std::lock_guard<std::mutex> lock(gBuffersMutex);
+        ThreadBuffer* buffer = acquireBuffer(gSession.load(std::memory_order_acquire));
+        if (!buffer)
+        {
+            return nullptr;
+        }
+
+        // The spans of the previous thread are dropped, a trace being written skips the buffer
+        // as its generation changed
+        buffer->generation.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        buffer->session.store(0, std::memory_order_relaxed);
+        buffer->written.store(0, std::memory_order_release);
+        buffer->threadId = ++gLastThreadId;
+        buffer->threadName = threadName.isEmpty() ? QString::fromUtf8("Thread %1").arg(buffer->threadId)
+                                                  : threadName;
+        tBufferOwner.buffer = buffer;
+    }
+
+    // The spans of a previous trace are dropped by the thread itself, so nobody else writes to
+    // the buffer
+    ThreadBuffer* buffer = tBufferOwner.buffer;
+    const uint32_t session = gSession.load(std::memory_order_acquire);
+    if (buffer->session.load(std::memory_order_relaxed) != session)
+    {
+        buffer->written.store(0, std::memory_order_relaxed);
+        buffer->session.store(session, std::memory_order_release);
+    }
+    return buffer;
+}
+
+QByteArray escapeJson(const QString& text)
+{
+    QByteArray escaped = text.toUtf8();
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    return escaped;
+}
+}
+
+void Tracer::start(const QString& filePath)
+{
+    std::lock_guard<std::mutex> lock(gControlMutex);
+    gFilePath = filePath;
+    gSession.fetch_add(1, std::memory_order_release);
+    sEnabled.store(true, std::memory_order_relaxed);
+}
+
+bool Tracer::stop()
+{
+    std::lock_guard<std::mutex> lock(gControlMutex);
+    if (!sEnabled.exchange(false, std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    struct BufferSnapshot
+    {
+        ThreadBuffer* buffer;
+        uint32_t generation;
+        uint32_t threadId;
+        QString threadName;
+    };
+    std::vector<BufferSnapshot> buffers;
+    {
+        std::lock_guard<std::mutex> buffersLock(gBuffersMutex);
+        for (const auto& buffer : gBuffers)
+        {
+            buffers.push_back({buffer.get(), buffer->generation.load(std::memory_order_relaxed), buffer->threadId,
+                               buffer->threadName});
+        }
+    }
+
+    QFile file(gFilePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    const uint32_t session = gSession.load(std::memory_order_relaxed);
+    QByteArray json("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const auto& snapshot : buffers)
+    {
+        ThreadBuffer* buffer = snapshot.buffer;
+        if (buffer->session.load(std::memory_order_acquire) != session)
+        {
+            continue;
+        }
+
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        if (!written)
+        {
+            continue;
+        }
+
+        // Spans which were started before tracing was disabled are still being added by their
+        // threads, so the slots are copied first and the ones overwritten meanwhile are dropped:
+        // the span being added after the last published one may be overwriting another slot. A
+        // buffer handed to another thread meanwhile is skipped
+        const uint64_t begin = written > BUFFER_CAPACITY ? written - BUFFER_CAPACITY : 0;
+        std::vector<SpanRecord> spans;
+        spans.reserve(static_cast<size_t>(written - begin));
+        for (uint64_t i = begin; i < written; ++i)
+        {
+            spans.push_back(buffer->spans[i % BUFFER_CAPACITY]);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t writtenAfterCopy = buffer->written.load(std::memory_order_relaxed);
+        const uint64_t firstValid = writtenAfterCopy + 1 > BUFFER_CAPACITY ? writtenAfterCopy + 1 - BUFFER_CAPACITY : 0;
+        if (buffer->generation.load(std::memory_order_relaxed) != snapshot.generation
+            || writtenAfterCopy < written || firstValid >= written)
+        {
+            continue;
+        }
+
+        json += first ? "" : ",\n";
+        first = false;
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + QByteArray::number(snapshot.threadId)
+                + ",\"args\":{\"name\":\"" + escapeJson(snapshot.threadName) + "\"}}";
+
+        for (uint64_t i = std::max(begin, firstValid); i < written; ++i)
+        {
+            const SpanRecord& span = spans[static_cast<size_t>(i - begin)];
+            json += ",\n{\"name\":\"" + QByteArray(span.name) + "\",\"cat\":\"" + QByteArray(span.category)
+                    + "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + QByteArray::number(snapshot.threadId)
+                    + ",\"ts\":" + QByteArray::number(static_cast<qint64>(span.startUs))
+                    + ",\"dur\":" + QByteArray::number(static_cast<qint64>(span.durationUs));
+            if (span.arg >= 0)
+            {
+                json += ",\"args\":{\"value\":" + QByteArray::number(span.arg) + "}";
+            }
+            json += "}";
+
+            if (json.size() > WRITE_CHUNK_SIZE)
+            {
+                file.write(json);
+                json.clear();
+            }
+        }
+    }
+    json += "\n]}\n";
+    file.write(json);
+    return file.error() == QFileDevice::NoError;
+}
+
+QString Tracer::getFilePath()
+{
+    std::lock_guard<std::mutex> lock(gControlMutex);
+    return gFilePath;
+}
+
+int64_t Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - gEpoch).count();
+}
+
+void Tracer::addSpan(const char* name, const char* category, int64_t startUs, int64_t durationUs, int arg)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+    if (!buffer)
+    {
+        return;
+    }
+
+    const uint64_t written = buffer->written.load(std::memory_order_relaxed);
+    buffer->spans[written % BUFFER_CAPACITY] = {name, category, startUs, durationUs, arg};
+    buffer->written.store(written + 1, std::memory_order_release);
+}
@@ -0,0 +1,75 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+
+#include <atomic>
+#include <cstdint>
+
+// Records the time spent in scoped spans and writes it as a Chrome trace-event JSON file,
+// which can be opened in chrome://tracing or https://ui.perfetto.dev.
+// Every thread writes to its own ring buffer without locks; when the buffer is full the oldest
+// spans are overwritten, so the file covers the last moments before tracing is stopped.
+// Tracing is always compiled in. While it is not running a span costs one relaxed atomic load.
+class Tracer
+{
+public:
+    // Starts a new trace, discarding the spans of the previous one
+    static void start(const QString& filePath);
+    // Stops tracing and writes the file. Returns false if it could not be written
+    static bool stop();
+    static QString getFilePath();
+
+    static bool isEnabled()
+    {
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+
+    // Microseconds on a monotonic clock
+    static int64_t now();
+    // name and category must be string literals: only the pointers are stored
+    static void addSpan(const char* name, const char* category, int64_t startUs, int64_t durationUs, int arg);
+
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+// Adds a span from its construction to its destruction, if tracing is enabled.
+// Spans shorter than minDurationUs are not recorded, and arg is written to the span when it
+// is not negative.
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char* name, const char* category = "app", int64_t minDurationUs = 0, int arg = -1)
+        : mName(name),
+          mCategory(category),
+          mStartUs(Tracer::isEnabled() ? Tracer::now() : -1),
+          mMinDurationUs(minDurationUs),
+          mArg(arg)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (mStartUs >= 0)
+        {
+            const int64_t durationUs = Tracer::now() - mStartUs;
+            if (durationUs >= mMinDurationUs)
+            {
+                Tracer::addSpan(mName, mCategory, mStartUs, durationUs, mArg);
+            }
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* mName;
+    const char* mCategory;
+    int64_t mStartUs;
+    int64_t mMinDurationUs;
+    int mArg;
+};
+
+#endif // TRACER_H
@@ -7,9 +7,11 @@
 #include <QTextStream>
 #include <QDateTime>
 #include <iostream>
+#include <cstring>
 #include <QDesktopWidget>
 #include "MegaApplication.h"
 #include "control/gzjoin.h"
+#include "control/DirectoryWalker.h"
 #include "platform/Platform.h"
 
 #ifndef WIN32
@@ -22,8 +24,6 @@
 using namespace std;
 using namespace mega;
 
-QHash<QString, QString> Utilities::extensionIcons;
-QHash<QString, Utilities::FileType> Utilities::fileTypes;
 QHash<QString, QString> Utilities::languageNames;
 
 std::unique_ptr<ThreadPool> ThreadPoolSingleton::instance = nullptr;
@@ -41,189 +41,282 @@ const QLatin1String Utilities::FORBIDDEN_CHARS("\\ / : \" * < > \? |");
 // Forbidden chars PCRE using a capture list: [\\/:"\*<>?|]
 const QRegularExpression Utilities::FORBIDDEN_CHARS_RX(QLatin1String("[\\\\/:\"*<>\?|]"));
 
-void Utilities::initializeExtensions()
+namespace
 {
-    extensionIcons[QString::fromAscii("3ds")] = extensionIcons[QString::fromAscii("3dm")]  = extensionIcons[QString::fromAscii("max")] =
-                            extensionIcons[QString::fromAscii("obj")]  = QString::fromAscii("3D.png");
-
-    extensionIcons[QString::fromAscii("aep")] = extensionIcons[QString::fromAscii("aet")]  = QString::fromAscii("aftereffects.png");
-
-    extensionIcons[QString::fromAscii("mp3")] = extensionIcons[QString::fromAscii("wav")]  = extensionIcons[QString::fromAscii("3ga")]  =
-                            extensionIcons[QString::fromAscii("aif")]  = extensionIcons[QString::fromAscii("aiff")] =
-                            extensionIcons[QString::fromAscii("flac")] = extensionIcons[QString::fromAscii("iff")]  = extensionIcons[QString::fromAscii("ogg")] =
-                            extensionIcons[QString::fromAscii("m4a")]  = extensionIcons[QString::fromAscii("wma")]  =  QString::fromAscii("audio.png");
-
-    extensionIcons[QString::fromAscii("dxf")] = extensionIcons[QString::fromAscii("dwg")] =  QString::fromAscii("cad.png");
-
-
-    extensionIcons[QString::fromAscii("zip")] = extensionIcons[QString::fromAscii("rar")] = extensionIcons[QString::fromAscii("tgz")]  =
-                            extensionIcons[QString::fromAscii("gz")]  = extensionIcons[QString::fromAscii("bz2")]  =
-                            extensionIcons[QString::fromAscii("tbz")] = extensionIcons[QString::fromAscii("tar")]  =
-                            extensionIcons[QString::fromAscii("7z")]  = extensionIcons[QString::fromAscii("sitx")] =  QString::fromAscii("compressed.png");
-
-    extensionIcons[QString::fromAscii("sql")] = extensionIcons[QString::fromAscii("accdb")] = extensionIcons[QString::fromAscii("db")]  =
-                            extensionIcons[QString::fromAscii("dbf")]  = extensionIcons[QString::fromAscii("mdb")]  =
-                            extensionIcons[QString::fromAscii("pdb")] = QString::fromAscii("web_lang.png");
-
-    extensionIcons[QString::fromAscii("folder")] = QString::fromAscii("folder.png");
-
-    extensionIcons[QString::fromAscii("xls")] = extensionIcons[QString::fromAscii("xlsx")] = extensionIcons[QString::fromAscii("xlt")]  =
-                            extensionIcons[QString::fromAscii("xltm")]  = QString::fromAscii("excel.png");
-
-    extensionIcons[QString::fromAscii("exe")] = extensionIcons[QString::fromAscii("com")] = extensionIcons[QString::fromAscii("bin")]  =
-                            extensionIcons[QString::fromAscii("apk")]  = extensionIcons[QString::fromAscii("app")]  =
-                             extensionIcons[QString::fromAscii("msi")]  = extensionIcons[QString::fromAscii("cmd")]  =
-                            extensionIcons[QString::fromAscii("gadget")] = QString::fromAscii("executable.png");
-
-    extensionIcons[QString::fromAscii("fnt")] = extensionIcons[QString::fromAscii("otf")] = extensionIcons[QString::fromAscii("ttf")]  =
-                            extensionIcons[QString::fromAscii("fon")]  = QString::fromAscii("font.png");
-
-    extensionIcons[QString::fromAscii("gif")] = extensionIcons[QString::fromAscii("tiff")]  = extensionIcons[QString::fromAscii("tif")]  =
-                            extensionIcons[QString::fromAscii("bmp")]  = extensionIcons[QString::fromAscii("png")] =
-                            extensionIcons[QString::fromAscii("tga")]  = QString::fromAscii("image.png");
-
-    extensionIcons[QString::fromAscii("ai")] = extensionIcons[QString::fromAscii("ait")] = QString::fromAscii("illustrator.png");
-    extensionIcons[QString::fromAscii("jpg")] = extensionIcons[QString::fromAscii("jpeg")] = extensionIcons[QString::fromAscii("heic")] = QString::fromAscii("image.png");
-    extensionIcons[QString::fromAscii("indd")] = QString::fromAscii("indesign.png");
-
-    extensionIcons[QString::fromAscii("jar")] = extensionIcons[QString::fromAscii("java")]  = extensionIcons[QString::fromAscii("class")]  = QString::fromAscii("web_data.png");
-
-    extensionIcons[QString::fromAscii("pdf")] = QString::fromAscii("pdf.png");
-    extensionIcons[QString::fromAscii("abr")] = extensionIcons[QString::fromAscii("psb")]  = extensionIcons[QString::fromAscii("psd")]  =
-                            QString::fromAscii("photoshop.png");
-
-    extensionIcons[QString::fromAscii("pps")] = extensionIcons[QString::fromAscii("ppt")]  = extensionIcons[QString::fromAscii("pptx")] = QString::fromAscii("powerpoint.png");
-
-    extensionIcons[QString::fromAscii("prproj")] = extensionIcons[QString::fromAscii("ppj")]  = QString::fromAscii("premiere.png");
-
-    extensionIcons[QString::fromAscii("3fr")] = extensionIcons[QString::fromAscii("arw")]  = extensionIcons[QString::fromAscii("bay")]  =
-                            extensionIcons[QString::fromAscii("cr2")]  = extensionIcons[QString::fromAscii("dcr")] =
-                            extensionIcons[QString::fromAscii("dng")] = extensionIcons[QString::fromAscii("fff")]  =
-                            extensionIcons[QString::fromAscii("mef")] = extensionIcons[QString::fromAscii("mrw")]  =
-                            extensionIcons[QString::fromAscii("nef")] = extensionIcons[QString::fromAscii("pef")]  =
-                            extensionIcons[QString::fromAscii("rw2")] = extensionIcons[QString::fromAscii("srf")]  =
-                            extensionIcons[QString::fromAscii("orf")] = extensionIcons[QString::fromAscii("rwl")]  =
-                            extensionIcons[QString::fromAscii("ari")] = extensionIcons[QString::fromAscii("braw")]  =
-                            extensionIcons[QString::fromAscii("crw")] = extensionIcons[QString::fromAscii("cr3")]  =
-                            extensionIcons[QString::fromAscii("cap")] =
-                            extensionIcons[QString::fromAscii("dcs")] = extensionIcons[QString::fromAscii("drf")]  =
-                            extensionIcons[QString::fromAscii("eip")] = extensionIcons[QString::fromAscii("erf")]  =
-                            extensionIcons[QString::fromAscii("gpr")] = extensionIcons[QString::fromAscii("iiq")]  =
-                            extensionIcons[QString::fromAscii("k25")] = extensionIcons[QString::fromAscii("kdc")]  =
-                            extensionIcons[QString::fromAscii("mdc")] = extensionIcons[QString::fromAscii("mos")]  =
-                            extensionIcons[QString::fromAscii("nrw")] = extensionIcons[QString::fromAscii("obm")]  =
-                            extensionIcons[QString::fromAscii("ptx")] = extensionIcons[QString::fromAscii("pxn")]  =
-                            extensionIcons[QString::fromAscii("r3d")] = extensionIcons[QString::fromAscii("raf")]  =
-                            extensionIcons[QString::fromAscii("raw")] = extensionIcons[QString::fromAscii("rwz")]  =
-                            extensionIcons[QString::fromAscii("sr2")] = extensionIcons[QString::fromAscii("srw")]  =
-                            extensionIcons[QString::fromAscii("tif")] = extensionIcons[QString::fromAscii("x3f")]  =
-                            QString::fromAscii("raw.png");
-
-    extensionIcons[QString::fromAscii("ods")]  = extensionIcons[QString::fromAscii("ots")]  =
-                            extensionIcons[QString::fromAscii("gsheet")]  = extensionIcons[QString::fromAscii("nb")] =
-                            extensionIcons[QString::fromAscii("xlr")] = QString::fromAscii("spreadsheet.png");
-
-    extensionIcons[QString::fromAscii("torrent")] = QString::fromAscii("torrent.png");
-    extensionIcons[QString::fromAscii("dmg")] = QString::fromAscii("dmg.png");
-
-    extensionIcons[QString::fromAscii("txt")] = extensionIcons[QString::fromAscii("rtf")]  = extensionIcons[QString::fromAscii("ans")]  =
-                            extensionIcons[QString::fromAscii("ascii")]  = extensionIcons[QString::fromAscii("log")] =
-                            extensionIcons[QString::fromAscii("odt")] = extensionIcons[QString::fromAscii("wpd")]  =
-                            QString::fromAscii("text.png");
-
-    extensionIcons[QString::fromAscii("svgz")]  = extensionIcons[QString::fromAscii("svg")]  =
-                            extensionIcons[QString::fromAscii("cdr")]  = extensionIcons[QString::fromAscii("eps")] =
-                            QString::fromAscii("vector.png");
-
-     extensionIcons[QString::fromAscii("mkv")]  = extensionIcons[QString::fromAscii("webm")]  =
-                            extensionIcons[QString::fromAscii("avi")]  = extensionIcons[QString::fromAscii("mp4")] =
-                            extensionIcons[QString::fromAscii("m4v")] = extensionIcons[QString::fromAscii("mpg")]  =
-                            extensionIcons[QString::fromAscii("mpeg")] = extensionIcons[QString::fromAscii("mov")]  =
-                            extensionIcons[QString::fromAscii("3g2")] = extensionIcons[QString::fromAscii("3gp")]  =
-                            extensionIcons[QString::fromAscii("asf")] = extensionIcons[QString::fromAscii("wmv")]  =
-                            extensionIcons[QString::fromAscii("flv")] = extensionIcons[QString::fromAscii("vob")] =
-                            QString::fromAscii("video.png");
-
-     extensionIcons[QString::fromAscii("html")]  = extensionIcons[QString::fromAscii("xml")] = extensionIcons[QString::fromAscii("shtml")]  =
-                            extensionIcons[QString::fromAscii("dhtml")] = extensionIcons[QString::fromAscii("js")] =
-                            extensionIcons[QString::fromAscii("css")]  = QString::fromAscii("web_data.png");
-
-     extensionIcons[QString::fromAscii("php")]  = extensionIcons[QString::fromAscii("php3")]  =
-                            extensionIcons[QString::fromAscii("php4")]  = extensionIcons[QString::fromAscii("php5")] =
-                            extensionIcons[QString::fromAscii("phtml")] = extensionIcons[QString::fromAscii("inc")]  =
-                            extensionIcons[QString::fromAscii("asp")] = extensionIcons[QString::fromAscii("pl")]  =
-                            extensionIcons[QString::fromAscii("cgi")] = extensionIcons[QString::fromAscii("py")]  =
-                            QString::fromAscii("web_lang.png");
-
-     extensionIcons[QString::fromAscii("doc")]  = extensionIcons[QString::fromAscii("docx")] = extensionIcons[QString::fromAscii("dotx")]  =
-                            extensionIcons[QString::fromAscii("wps")] = QString::fromAscii("word.png");
-
-     extensionIcons[QString::fromAscii("odt")]  = extensionIcons[QString::fromAscii("ods")] = extensionIcons[QString::fromAscii("odp")]  =
-                            extensionIcons[QString::fromAscii("odb")] = extensionIcons[QString::fromAscii("odg")] = QString::fromAscii("openoffice.png");
-
-     extensionIcons[QString::fromAscii("sketch")] = QString::fromAscii("sketch.png");
-     extensionIcons[QString::fromAscii("xd")] = QString::fromAscii("experiencedesign.png");
-     extensionIcons[QString::fromAscii("pages")] = QString::fromAscii("pages.png");
-     extensionIcons[QString::fromAscii("numbers")] = QString::fromAscii("numbers.png");
-     extensionIcons[QString::fromAscii("key")] = QString::fromAscii("keynote.png");
+// Extension to icon lookup. The table is built at compile time with a hash that is perfect for
+// the known extensions, so a lookup is one hash over the lowercase suffix and one comparison.
+constexpr int MAX_EXTENSION_LENGTH = 7;
+constexpr unsigned int EXTENSION_HASH_BITS = 11;
+// FNV-1a offset basis adjusted so that no two extensions share a slot
+constexpr uint32_t EXTENSION_HASH_SEED = 2166142971u;
+constexpr unsigned char EMPTY_SLOT = 0xFF;
+
+enum ExtensionIcon : unsigned char
+{
+    ICON_GENERIC = 0,
+    ICON_3D,
+    ICON_AFTER_EFFECTS,
+    ICON_AUDIO,
+    ICON_CAD,
+    ICON_COMPRESSED,
+    ICON_WEB_LANG,
+    ICON_FOLDER,
+    ICON_EXCEL,
+    ICON_EXECUTABLE,
+    ICON_FONT,
+    ICON_IMAGE,
+    ICON_RAW,
+    ICON_ILLUSTRATOR,
+    ICON_INDESIGN,
+    ICON_WEB_DATA,
+    ICON_PDF,
+    ICON_PHOTOSHOP,
+    ICON_POWERPOINT,
+    ICON_PREMIERE,
+    ICON_OPENOFFICE,
+    ICON_SPREADSHEET,
+    ICON_TORRENT,
+    ICON_DMG,
+    ICON_TEXT,
+    ICON_VECTOR,
+    ICON_VIDEO,
+    ICON_WORD,
+    ICON_SKETCH,
+    ICON_EXPERIENCE_DESIGN,
+    ICON_PAGES,
+    ICON_NUMBERS,
+    ICON_KEYNOTE,
+    ICON_COUNT
+};
+
+struct ExtensionIconInfo
+{
+    const char* fileName;
+    Utilities::FileType fileType;
+};
+
+const ExtensionIconInfo EXTENSION_ICONS[ICON_COUNT] = {
+    {"generic.png", Utilities::FileType::TYPE_OTHER},
+    {"3D.png", Utilities::FileType::TYPE_OTHER},
+    {"aftereffects.png", Utilities::FileType::TYPE_OTHER},
+    {"audio.png", Utilities::FileType::TYPE_AUDIO},
+    {"cad.png", Utilities::FileType::TYPE_OTHER},
+    {"compressed.png", Utilities::FileType::TYPE_ARCHIVE},
+    {"web_lang.png", Utilities::FileType::TYPE_OTHER},
+    {"folder.png", Utilities::FileType::TYPE_OTHER},
+    {"excel.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"executable.png", Utilities::FileType::TYPE_OTHER},
+    {"font.png", Utilities::FileType::TYPE_OTHER},
+    {"image.png", Utilities::FileType::TYPE_IMAGE},
+    {"raw.png", Utilities::FileType::TYPE_IMAGE},
+    {"illustrator.png", Utilities::FileType::TYPE_IMAGE},
+    {"indesign.png", Utilities::FileType::TYPE_OTHER},
+    {"web_data.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"pdf.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"photoshop.png", Utilities::FileType::TYPE_IMAGE},
+    {"powerpoint.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"premiere.png", Utilities::FileType::TYPE_OTHER},
+    {"openoffice.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"spreadsheet.png", Utilities::FileType::TYPE_OTHER},
+    {"torrent.png", Utilities::FileType::TYPE_ARCHIVE},
+    {"dmg.png", Utilities::FileType::TYPE_ARCHIVE},
+    {"text.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"vector.png", Utilities::FileType::TYPE_IMAGE},
+    {"video.png", Utilities::FileType::TYPE_VIDEO},
+    {"word.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"sketch.png", Utilities::FileType::TYPE_ARCHIVE},
+    {"experiencedesign.png", Utilities::FileType::TYPE_ARCHIVE},
+    {"pages.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"numbers.png", Utilities::FileType::TYPE_DOCUMENT},
+    {"keynote.png", Utilities::FileType::TYPE_DOCUMENT},
+};
+
+struct ExtensionEntry
+{
+    char extension[MAX_EXTENSION_LENGTH + 1];
+    ExtensionIcon icon;
+};
+
+constexpr ExtensionEntry EXTENSIONS[] = {
+    {"3ds", ICON_3D}, {"3dm", ICON_3D}, {"max", ICON_3D}, {"obj", ICON_3D},
+    {"aep", ICON_AFTER_EFFECTS}, {"aet", ICON_AFTER_EFFECTS},
+    {"mp3", ICON_AUDIO}, {"wav", ICON_AUDIO}, {"3ga", ICON_AUDIO}, {"aif", ICON_AUDIO}, {"aiff", ICON_AUDIO},
+    {"flac", ICON_AUDIO}, {"iff", ICON_AUDIO}, {"ogg", ICON_AUDIO}, {"m4a", ICON_AUDIO}, {"wma", ICON_AUDIO},
+    {"dxf", ICON_CAD}, {"dwg", ICON_CAD},
+    {"zip", ICON_COMPRESSED}, {"rar", ICON_COMPRESSED}, {"tgz", ICON_COMPRESSED}, {"gz", ICON_COMPRESSED},
+    {"bz2", ICON_COMPRESSED}, {"tbz", ICON_COMPRESSED}, {"tar", ICON_COMPRESSED}, {"7z", ICON_COMPRESSED},
+    {"sitx", ICON_COMPRESSED},
+    {"sql", ICON_WEB_LANG}, {"accdb", ICON_WEB_LANG}, {"db", ICON_WEB_LANG}, {"dbf", ICON_WEB_LANG},
+    {"mdb", ICON_WEB_LANG}, {"pdb", ICON_WEB_LANG}, {"php", ICON_WEB_LANG}, {"php3", ICON_WEB_LANG},
+    {"php4", ICON_WEB_LANG}, {"php5", ICON_WEB_LANG}, {"phtml", ICON_WEB_LANG}, {"inc", ICON_WEB_LANG},
+    {"asp", ICON_WEB_LANG}, {"pl", ICON_WEB_LANG}, {"cgi", ICON_WEB_LANG}, {"py", ICON_WEB_LANG},
+    {"folder", ICON_FOLDER},
+    {"xls", ICON_EXCEL}, {"xlsx", ICON_EXCEL}, {"xlt", ICON_EXCEL}, {"xltm", ICON_EXCEL},
+    {"exe", ICON_EXECUTABLE}, {"com", ICON_EXECUTABLE}, {"bin", ICON_EXECUTABLE}, {"apk", ICON_EXECUTABLE},
+    {"app", ICON_EXECUTABLE}, {"msi", ICON_EXECUTABLE}, {"cmd", ICON_EXECUTABLE}, {"gadget", ICON_EXECUTABLE},
+    {"fnt", ICON_FONT}, {"otf", ICON_FONT}, {"ttf", ICON_FONT}, {"fon", ICON_FONT},
+    {"gif", ICON_IMAGE}, {"tiff", ICON_IMAGE}, {"bmp", ICON_IMAGE}, {"png", ICON_IMAGE}, {"tga", ICON_IMAGE},
+    {"jpg", ICON_IMAGE}, {"jpeg", ICON_IMAGE}, {"heic", ICON_IMAGE},
+    {"tif", ICON_RAW}, {"3fr", ICON_RAW}, {"arw", ICON_RAW}, {"bay", ICON_RAW}, {"cr2", ICON_RAW},
+    {"dcr", ICON_RAW}, {"dng", ICON_RAW}, {"fff", ICON_RAW}, {"mef", ICON_RAW}, {"mrw", ICON_RAW},
+    {"nef", ICON_RAW}, {"pef", ICON_RAW}, {"rw2", ICON_RAW}, {"srf", ICON_RAW}, {"orf", ICON_RAW},
+    {"rwl", ICON_RAW}, {"ari", ICON_RAW}, {"braw", ICON_RAW}, {"crw", ICON_RAW}, {"cr3", ICON_RAW},
+    {"cap", ICON_RAW}, {"dcs", ICON_RAW}, {"drf", ICON_RAW}, {"eip", ICON_RAW}, {"erf", ICON_RAW},
+    {"gpr", ICON_RAW}, {"iiq", ICON_RAW}, {"k25", ICON_RAW}, {"kdc", ICON_RAW}, {"mdc", ICON_RAW},
+    {"mos", ICON_RAW}, {"nrw", ICON_RAW}, {"obm", ICON_RAW}, {"ptx", ICON_RAW}, {"pxn", ICON_RAW},
+    {"r3d", ICON_RAW}, {"raf", ICON_RAW}, {"raw", ICON_RAW}, {"rwz", ICON_RAW}, {"sr2", ICON_RAW},
+    {"srw", ICON_RAW}, {"x3f", ICON_RAW},
+    {"ai", ICON_ILLUSTRATOR}, {"ait", ICON_ILLUSTRATOR},
+    {"indd", ICON_INDESIGN},
+    {"jar", ICON_WEB_DATA}, {"java", ICON_WEB_DATA}, {"class", ICON_WEB_DATA}, {"html", ICON_WEB_DATA},
+    {"xml", ICON_WEB_DATA}, {"shtml", ICON_WEB_DATA}, {"dhtml", ICON_WEB_DATA}, {"js", ICON_WEB_DATA},
+    {"css", ICON_WEB_DATA},
+    {"pdf", ICON_PDF},
+    {"abr", ICON_PHOTOSHOP}, {"psb", ICON_PHOTOSHOP}, {"psd", ICON_PHOTOSHOP},
+    {"pps", ICON_POWERPOINT}, {"ppt", ICON_POWERPOINT}, {"pptx", ICON_POWERPOINT},
+    {"prproj", ICON_PREMIERE}, {"ppj", ICON_PREMIERE},
+    {"ods", ICON_OPENOFFICE}, {"odt", ICON_OPENOFFICE}, {"odp", ICON_OPENOFFICE}, {"odb", ICON_OPENOFFICE},
+    {"odg", ICON_OPENOFFICE},
+    {"ots", ICON_SPREADSHEET}, {"gsheet", ICON_SPREADSHEET}, {"nb", ICON_SPREADSHEET},
+    {"xlr", ICON_SPREADSHEET},
+    {"torrent", ICON_TORRENT},
+    {"dmg", ICON_DMG},
+    {"txt", ICON_TEXT}, {"rtf", ICON_TEXT}, {"ans", ICON_TEXT}, {"ascii", ICON_TEXT}, {"log", ICON_TEXT},
+    {"wpd", ICON_TEXT},
+    {"svgz", ICON_VECTOR}, {"svg", ICON_VECTOR}, {"cdr", ICON_VECTOR}, {"eps", ICON_VECTOR},
+    {"mkv", ICON_VIDEO}, {"webm", ICON_VIDEO}, {"avi", ICON_VIDEO}, {"mp4", ICON_VIDEO}, {"m4v", ICON_VIDEO},
+    {"mpg", ICON_VIDEO}, {"mpeg", ICON_VIDEO}, {"mov", ICON_VIDEO}, {"3g2", ICON_VIDEO}, {"3gp", ICON_VIDEO},
+    {"asf", ICON_VIDEO}, {"wmv", ICON_VIDEO}, {"flv", ICON_VIDEO}, {"vob", ICON_VIDEO},
+    {"doc", ICON_WORD}, {"docx", ICON_WORD}, {"dotx", ICON_WORD}, {"wps", ICON_WORD},
+    {"sketch", ICON_SKETCH},
+    {"xd", ICON_EXPERIENCE_DESIGN},
+    {"pages", ICON_PAGES},
+    {"numbers", ICON_NUMBERS},
+    {"key", ICON_KEYNOTE},
+};
+
+constexpr int EXTENSION_COUNT = sizeof(EXTENSIONS) / sizeof(EXTENSIONS[0]);
+
+constexpr int extensionLength(const char* extension)
+{
+    int length = 0;
+    while (extension[length])
+    {
+        ++length;
+    }
+    return length;
+}
+
+constexpr unsigned int extensionHash(const char* extension, int length)
+{
+    uint32_t hash = EXTENSION_HASH_SEED;
+    for (int i = 0; i < length; ++i)
+    {
+        hash = (hash ^ static_cast<unsigned char>(extension[i])) * 16777619u;
+    }
+    return (hash ^ (hash >> 15)) & ((1u << EXTENSION_HASH_BITS) - 1);
 }
 
-void Utilities::initializeFileTypes()
+struct ExtensionSlots
 {
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.wav"), QString())]
-            = FileType::TYPE_AUDIO;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.mkv"), QString())]
-            = FileType::TYPE_VIDEO;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.tar"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.torrent"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.dmg"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.xd"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.sketch"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.txt"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.odt"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.pdf"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.doc"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.ods"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.odt"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.ppt"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.pages"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.numbers"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.key"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.xml"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.xls"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.png"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.jpg"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.ai"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.abr"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.3fr"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.svg"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.bin"), QString())]
-            = FileType::TYPE_OTHER;
+    unsigned char slots[1 << EXTENSION_HASH_BITS];
+    bool perfect;
+};
+
+constexpr ExtensionSlots buildExtensionSlots()
+{
+    ExtensionSlots table {{}, true};
+    for (unsigned int slot = 0; slot < (1u << EXTENSION_HASH_BITS); ++slot)
+    {
+        table.slots[slot] = EMPTY_SLOT;
+    }
+    for (int i = 0; i < EXTENSION_COUNT; ++i)
+    {
+        auto slot = extensionHash(EXTENSIONS[i].extension, extensionLength(EXTENSIONS[i].extension));
+        if (table.slots[slot] != EMPTY_SLOT)
+        {
+            table.perfect = false;
+        }
+        table.slots[slot] = static_cast<unsigned char>(i);
+    }
+    return table;
+}
+
+constexpr ExtensionSlots EXTENSION_SLOTS = buildExtensionSlots();
+static_assert(EXTENSION_COUNT < EMPTY_SLOT, "Too many extensions for the slot table");
+static_assert(EXTENSION_SLOTS.perfect, "Extension hash collision, EXTENSION_HASH_SEED must be changed");
+
+// Finds the icon for the suffix of fileName (like QFileInfo::suffix) reading the UTF-16 data directly
+ExtensionIcon findExtensionIcon(const QString& fileName)
+{
+    char extension[MAX_EXTENSION_LENGTH];
+    int length = 0;
+    const QChar* name = fileName.constData();
+    for (int i = fileName.size() - 1; i >= 0; --i)
+    {
+        ushort c = name[i].unicode();
+        if (c == '.')
+        {
+            if (!length)
+            {
+                return ICON_GENERIC;
+            }
+
+            const char* suffix = extension + MAX_EXTENSION_LENGTH - length;
+            unsigned char index = EXTENSION_SLOTS.slots[extensionHash(suffix, length)];
+            if (index == EMPTY_SLOT)
+            {
+                return ICON_GENERIC;
+            }
+
+            const ExtensionEntry& candidate = EXTENSIONS[index];
+            return (!strncmp(candidate.extension, suffix, length) && !candidate.extension[length])
+                    ? candidate.icon : ICON_GENERIC;
+        }
+
+#ifdef WIN32
+        if (c == '/' || c == '\\' || c >= 0x80 || length == MAX_EXTENSION_LENGTH)
+#else
+        if (c == '/' || c >= 0x80 || length == MAX_EXTENSION_LENGTH)
+#endif
+        {
+            // No suffix, or one that cannot be in the table
+            return ICON_GENERIC;
+        }
+
+        extension[MAX_EXTENSION_LENGTH - 1 - length] = static_cast<char>((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+        ++length;
+    }
+    return ICON_GENERIC;
 }
 
+enum ExtensionIconSize
+{
+    ICON_SIZE_SMALL = 0,
+    ICON_SIZE_MEDIUM,
+    ICON_SIZES
+};
+
+const char* EXTENSION_ICON_PREFIXES[ICON_SIZES] = {
+    ":/images/small_",
+    ":/images/drag_"
+};
+
+// Icons for file types, loaded on first use
+QIcon gExtensionIcons[ICON_SIZES][ICON_COUNT];
+
+const QIcon& getExtensionIcon(const QString& fileName, ExtensionIconSize size)
+{
+    ExtensionIcon icon = findExtensionIcon(fileName);
+    QIcon& cached = gExtensionIcons[size][icon];
+    if (cached.isNull())
+    {
+        cached.addFile(QString::fromLatin1(EXTENSION_ICON_PREFIXES[size]) + QString::fromLatin1(EXTENSION_ICONS[icon].fileName),
+                       QSize(), QIcon::Normal, QIcon::Off);
+    }
+    return cached;
+}
+}
 
 void Utilities::queueFunctionInAppThread(std::function<void()> fun) {
    QObject temporary;
@@ -237,20 +330,7 @@ void Utilities::getFolderSize(QString folderPath, long long *size)
         return;
     }
 
-    QDir dir(folderPath);
-    QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden);
-    for (int i = 0; i < entries.size(); i++)
-    {
-        QFileInfo info = entries[i];
-        if (info.isFile())
-        {
-            (*size) += info.size();
-        }
-        else if (info.isDir())
-        {
-            getFolderSize(info.absoluteFilePath(), size);
-        }
-    }
+    (*size) += DirectoryWalker::instance()->getFolderSize(folderPath);
 }
 
 qreal Utilities::getDevicePixelRatio()
@@ -264,27 +344,12 @@ qreal Utilities::getDevicePixelRatio()
 
 QString Utilities::getExtensionPixmapName(QString fileName, QString prefix)
 {
-    if (extensionIcons.isEmpty())
-    {
-        initializeExtensions();
-        initializeFileTypes();
-    }
-
-    QFileInfo f(fileName);
-    if (extensionIcons.contains(f.suffix().toLower()))
-    {
-        return QString(extensionIcons[f.suffix().toLower()]).insert(0, prefix);
-    }
-    else
-    {
-        return prefix + QString::fromAscii("generic.png");
-    }
+    return prefix + QString::fromLatin1(EXTENSION_ICONS[findExtensionIcon(fileName)].fileName);
 }
 
-Utilities::FileType Utilities::getFileType(QString fileName, QString prefix)
+Utilities::FileType Utilities::getFileType(const QString& fileName)
 {
-    auto extensionPixmapName = getExtensionPixmapName(fileName, prefix);
-    return fileTypes.value(extensionPixmapName,FileType::TYPE_OTHER);
+    return EXTENSION_ICONS[findExtensionIcon(fileName)].fileType;
 }
 
 QString Utilities::languageCodeToString(QString code)
@@ -365,25 +430,10 @@ struct IconCache
         }
         return i->second;
     }
-
-    QIcon& getByExtension(const QString &fileName, const QString &prefix)
-    {
-        return getDirect(Utilities::getExtensionPixmapName(fileName, prefix));
-    }
 };
 
 IconCache gIconCache;
 
-QString Utilities::getExtensionPixmapNameSmall(QString fileName)
-{
-    return getExtensionPixmapName(fileName, QString::fromAscii(":/images/small_"));
-}
-
-QString Utilities::getExtensionPixmapNameMedium(QString fileName)
-{
-    return getExtensionPixmapName(fileName, QString::fromAscii(":/images/drag_"));
-}
-
 double Utilities::toDoubleInUnit(unsigned long long bytes, unsigned long long unit)
 {
     double decimalMultiplier = 100.0;
@@ -398,12 +448,12 @@ QIcon Utilities::getCachedPixmap(QString fileName)
 
 QIcon Utilities::getExtensionPixmapSmall(QString fileName)
 {
-    return gIconCache.getDirect(getExtensionPixmapNameSmall(fileName));
+    return getExtensionIcon(fileName, ICON_SIZE_SMALL);
 }
 
 QIcon Utilities::getExtensionPixmapMedium(QString fileName)
 {
-    return gIconCache.getDirect(getExtensionPixmapNameMedium(fileName));
+    return getExtensionIcon(fileName, ICON_SIZE_MEDIUM);
 }
 
 QString Utilities::getAvatarPath(QString email)
@@ -340,13 +340,7 @@ public:
 
 private:
     Utilities() {}
-    static QHash<QString, QString> extensionIcons;
-    static QHash<QString, FileType> fileTypes;
     static QHash<QString, QString> languageNames;
-    static void initializeExtensions();
-    static void initializeFileTypes();
-    static QString getExtensionPixmapNameSmall(QString fileName);
-    static QString getExtensionPixmapNameMedium(QString fileName);
     static double toDoubleInUnit(unsigned long long bytes, unsigned long long unit);
 
 //Platform dependent functions
@@ -365,7 +359,7 @@ public:
     static QIcon getExtensionPixmapSmall(QString fileName);
     static QIcon getExtensionPixmapMedium(QString fileName);
     static QString getExtensionPixmapName(QString fileName, QString prefix);
-    static FileType getFileType(QString fileName, QString prefix);
+    static FileType getFileType(const QString& fileName);
 
     static long long getSystemsAvailableMemory();
 
@@ -11,10 +11,17 @@ SOURCES += $$PWD/HTTPServer.cpp \
     $$PWD/UpdateTask.cpp \
     $$PWD/EncryptedSettings.cpp \
     $$PWD/CrashHandler.cpp \
+    $$PWD/CrashStack.cpp \
+    $$PWD/CrashSignature.cpp \
+    $$PWD/DebrisSizeAccountant.cpp \
+    $$PWD/DirectoryWalker.cpp \
     $$PWD/ExportProcessor.cpp \
     $$PWD/UserAttributesManager.cpp \
     $$PWD/Utilities.cpp \
     $$PWD/ThreadPool.cpp \
+    $$PWD/TaskScheduler.cpp \
+    $$PWD/StartupOrchestrator.cpp \
+    $$PWD/Tracer.cpp \
     $$PWD/MegaDownloader.cpp \
     $$PWD/MegaSyncLogger.cpp \
     $$PWD/ConnectivityChecker.cpp \
@@ -31,10 +38,17 @@ HEADERS  +=  $$PWD/HTTPServer.h \
     $$PWD/UpdateTask.h \
     $$PWD/EncryptedSettings.h \
     $$PWD/CrashHandler.h \
+    $$PWD/CrashStack.h \
+    $$PWD/CrashSignature.h \
+    $$PWD/DebrisSizeAccountant.h \
+    $$PWD/DirectoryWalker.h \
     $$PWD/ExportProcessor.h \
     $$PWD/UserAttributesManager.h \
     $$PWD/Utilities.h \
     $$PWD/ThreadPool.h \
+    $$PWD/TaskScheduler.h \
+    $$PWD/StartupOrchestrator.h \
+    $$PWD/Tracer.h \
     $$PWD/MegaDownloader.h \
     $$PWD/MegaSyncLogger.h \
     $$PWD/ConnectivityChecker.h \
@@ -20,8 +20,16 @@ MegaItem::MegaItem(std::unique_ptr<MegaNode> node, MegaItem *parentItem, bool sh
     mNode(std::move(node)),
     mOwner(nullptr),
     mMegaApi(MegaSyncApp->getMegaApi()),
-    mIsVault(false)
+    mIsVault(false),
+    mSortKeySet(false),
+    mIsInShare(mNode->isInShare()),
+    mAccess(MegaShare::ACCESS_UNKNOWN)
 { 
+    if(!parentItem)
+    {
+        mAccess = mMegaApi->getAccess(mNode.get());
+    }
+
     if(mNode->isFile() || mNode->isInShare())
     {
         mStatus = STATUS::NONE;
@@ -220,9 +228,11 @@ bool MegaItem::isSyncable()
             && mStatus != BACKUP;
 }
 
-void MegaItem::addNode(std::unique_ptr<MegaNode>node)
+MegaItem* MegaItem::addNode(std::unique_ptr<MegaNode>node)
 {
-    mChildItems.append(new MegaItem(move(node), this, mShowFiles));
+    auto item = new MegaItem(move(node), this, mShowFiles);
+    mChildItems.append(item);
+    return item;
 }
 
 void MegaItem::removeNode(std::shared_ptr<MegaNode> node)
@@ -251,6 +261,8 @@ void MegaItem::displayFiles(bool enable)
 void MegaItem::setAsVaultNode()
 {
     mIsVault = true;
+    // The vault shows another name
+    mSortKey.name.reset();
 }
 
 int MegaItem::row()
@@ -262,6 +274,18 @@ int MegaItem::row()
     return 0;
 }
 
+MegaItem::SortKey& MegaItem::getSortKey()
+{
+    if(!mSortKeySet)
+    {
+        mSortKey.isFile = mNode->isFile();
+        mSortKey.status = mStatus;
+        mSortKey.creationTime = mNode->getCreationTime();
+        mSortKeySet = true;
+    }
+    return mSortKey;
+}
+
 MegaItem::~MegaItem()
 {
     qDeleteAll(mChildItems);
@@ -270,8 +294,7 @@ MegaItem::~MegaItem()
 
 void MegaItem::calculateSyncStatus(const QStringList &folders)
 {
-    auto syncedFolders = SyncInfo::instance()->getMegaFolderHandles(SyncInfo::AllHandledSyncTypes);
-    if(syncedFolders.contains(mNode->getHandle()))
+    if(SyncInfo::instance()->isMegaFolderSynced(mNode->getHandle()))
     {
         mStatus = STATUS::SYNC;
         return;
@@ -315,3 +338,28 @@ bool MegaItem::isVault()
 {
     return mIsVault;
 }
+
+bool MegaItem::isInShare() const
+{
+    return mIsInShare;
+}
+
+int MegaItem::getAccess()
+{
+    if(mAccess == MegaShare::ACCESS_UNKNOWN)
+    {
+        mAccess = mMegaApi->getAccess(mNode.get());
+    }
+    return mAccess;
+}
+
+void MegaItem::updateShareState()
+{
+    auto node = std::shared_ptr<MegaNode>(mMegaApi->getNodeByHandle(mNode->getHandle()));
+    if(node)
+    {
+        mNode = node;
+        mIsInShare = mNode->isInShare();
+        mAccess = mMegaApi->getAccess(mNode.get());
+    }
+}
@@ -3,6 +3,7 @@
 
 #include <QList>
 #include <QIcon>
+#include <QCollatorSortKey>
 
 #include "megaapi.h"
 
@@ -28,6 +29,16 @@ public:
         NONE,
     };
 
+    // What the node selector sorts by, read once so that comparing two items does not go through the model data
+    struct SortKey
+    {
+        bool isFile = false;
+        int status = NONE;
+        int64_t creationTime = 0;
+        // Collation key of the name shown, set by the proxy model the first time it sorts by name
+        std::unique_ptr<QCollatorSortKey> name;
+    };
+
     explicit MegaItem(std::unique_ptr<mega::MegaNode> node, MegaItem *parentItem = 0, bool showFiles = false);
 
     std::shared_ptr<mega::MegaNode> getNode();
@@ -47,12 +58,18 @@ public:
     bool isSyncable();
     bool isRoot();
     bool isVault();
-    void addNode(std::unique_ptr<mega::MegaNode> node);
+    // Share state and access level of the node, read once (the access of the top level items, when they
+    // are created) instead of asking the SDK every time the node selector filters
+    bool isInShare() const;
+    int getAccess();
+    void updateShareState();
+    MegaItem* addNode(std::unique_ptr<mega::MegaNode> node);
     void removeNode(std::shared_ptr<mega::MegaNode> node);
     void displayFiles(bool enable);
     void setChatFilesFolder();
     void setAsVaultNode();
     int row();
+    SortKey& getSortKey();
 
     ~MegaItem();
 
@@ -79,6 +96,10 @@ private:
     mega::MegaApi* mMegaApi;
     std::shared_ptr<const UserAttributes::FullName> mFullNameAttribute;
     std::shared_ptr<const UserAttributes::Avatar> mAvatarAttribute;
+    SortKey mSortKey;
+    bool mSortKeySet;
+    bool mIsInShare;
+    int mAccess;
 };
 
 #endif // MEGAITEM_H
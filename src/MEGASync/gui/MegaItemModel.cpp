@@ -29,6 +29,7 @@ MegaItemModel::MegaItemModel(QObject *parent) :
    //cloud drive
    auto root = std::unique_ptr<MegaNode>(mMegaApi->getRootNode());
    mRootItems.append(new MegaItem(move(root)));
+   addItemToIndex(mRootItems.last());
 
    //incoming shares
    auto folders = std::unique_ptr<MegaNodeList>(mMegaApi->getInShares());
@@ -40,6 +41,7 @@ MegaItemModel::MegaItemModel(QObject *parent) :
        item->setOwner(move(user));
        connect(item, &MegaItem::infoUpdated, this, &MegaItemModel::onItemInfoUpdated);
        mRootItems.append(item);
+       addItemToIndex(item);
    }
 
    // Get "My Backups" handle to localize the name
@@ -47,6 +49,9 @@ MegaItemModel::MegaItemModel(QObject *parent) :
    connect(myBackupsHandle.get(), &UserAttributes::MyBackupsHandle::attributeReady,
            this, &MegaItemModel::onMyBackupsFolderHandleSet);
    onMyBackupsFolderHandleSet(myBackupsHandle->getMyBackupsHandle());
+
+   connect(MegaSyncApp, &MegaApplication::nodeSharesChanged, this, &MegaItemModel::onNodeSharesChanged);
+   connect(MegaSyncApp, &MegaApplication::nodeMoved, this, &MegaItemModel::onNodeMoved);
 }
 
 int MegaItemModel::columnCount(const QModelIndex &) const
@@ -152,11 +157,7 @@ QModelIndex MegaItemModel::index(int row, int column, const QModelIndex &parent)
     if (parent.isValid())
     {
         MegaItem* item = static_cast<MegaItem*>(parent.internalPointer());
-        if (!item->areChildrenSet())
-        {
-            auto children = std::shared_ptr<MegaNodeList>(mMegaApi->getChildren(item->getNode().get()));
-            item->setChildren(children);
-        }
+        loadChildren(item);
         return createIndex(row, column, item->getChild(row));
     }
     else
@@ -189,11 +190,7 @@ int MegaItemModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
     {
         MegaItem *item = static_cast<MegaItem*>(parent.internalPointer());
-        if (!item->areChildrenSet())
-        {
-            auto children = std::shared_ptr<MegaNodeList>(mMegaApi->getChildren(item->getNode().get()));
-            item->setChildren(children);
-        }
+        loadChildren(item);
         return item->getNumChildren();
     }
     return mRootItems.size();
@@ -290,6 +287,7 @@ void MegaItemModel::showFiles(bool show)
     {
         if((*it)->getNode()->isFile() && !show)
         {
+            removeItemFromIndex(*it);
             mRootItems.removeOne(*it);
             continue;
         }
@@ -303,7 +301,7 @@ void MegaItemModel::addNode(std::unique_ptr<MegaNode> node, const QModelIndex &p
     MegaItem *parentItem = static_cast<MegaItem*>(parent.internalPointer());
     int numchildren = parentItem->getNumChildren();
     beginInsertRows(parent, numchildren, numchildren);
-    parentItem->addNode(move(node));
+    addItemToIndex(parentItem->addNode(move(node)));
     endInsertRows();
 }
 
@@ -319,6 +317,7 @@ void MegaItemModel::removeNode(const QModelIndex &item)
     {
         return;
     }
+    removeItemFromIndex(static_cast<MegaItem*>(item.internalPointer()));
     if(parent)
     {
         int index = parent->indexOf(static_cast<MegaItem*>(item.internalPointer()));
@@ -478,10 +477,30 @@ void MegaItemModel::onMyBackupsFolderHandleSet(mega::MegaHandle h)
      megaItem->setAsVaultNode();
      beginInsertRows(QModelIndex(), rowCount(), rowCount());
      mRootItems.append(move(megaItem));
+     addItemToIndex(megaItem);
      endInsertRows();
     }
 }
 
+void MegaItemModel::onNodeSharesChanged(mega::MegaHandle handle)
+{
+    if(MegaItem* item = mItemsByHandle.value(handle))
+    {
+        item->updateShareState();
+        // The proxy filters the row again
+        QModelIndex idx = getIndexFromItem(item);
+        if(idx.isValid())
+        {
+            emit dataChanged(idx, idx.sibling(idx.row(), COLUMN::last - 1));
+        }
+    }
+}
+
+void MegaItemModel::onNodeMoved(mega::MegaHandle handle)
+{
+    mParentHandles.remove(handle);
+}
+
 int MegaItemModel::insertPosition(const std::unique_ptr<MegaNode>& node)
 {
     int type = node->getType();
@@ -498,36 +517,101 @@ int MegaItemModel::insertPosition(const std::unique_ptr<MegaNode>& node)
     return i;
 }
 
-QModelIndex MegaItemModel::findItemByNodeHandle(const mega::MegaHandle& handle, const QModelIndex &parent)
+QModelIndex MegaItemModel::findIndexByNodeHandle(const mega::MegaHandle& handle)
 {
-    for(int i = 0; i < rowCount(parent); ++i)
+    // Go up until an ancestor is loaded...
+    QList<MegaHandle> path;
+    auto current (handle);
+    MegaItem* item (mItemsByHandle.value(current));
+    while(!item && current != INVALID_HANDLE)
     {
-        QModelIndex idx = index(i, COLUMN::NODE, parent);
-        if(idx.isValid())
+        path.prepend(current);
+
+        auto parentIt = mParentHandles.constFind(current);
+        if(parentIt == mParentHandles.constEnd())
         {
-            QString name = idx.data(Qt::DisplayRole).toString();
-            if(MegaItem* chkItem = static_cast<MegaItem*>(idx.internalPointer()))
+            auto node = std::unique_ptr<MegaNode>(mMegaApi->getNodeByHandle(current));
+            if(!node)
             {
-                if(chkItem->getNode()->isFolder() && chkItem->getNode()->getHandle() == handle)
-                {
-                    return idx;
-                }
+                return QModelIndex();
             }
+            parentIt = mParentHandles.insert(current, node->getParentHandle());
         }
+
+        current = parentIt.value();
+        item = mItemsByHandle.value(current);
     }
-    for(int i = 0; i < rowCount(parent); ++i)
+
+    // ...and then down, loading the children of each level
+    foreach(auto pathHandle, path)
     {
-        QModelIndex child = parent.child(i, COLUMN::NODE);
-        if(child.isValid())
+        if(!item)
         {
-          auto ret = findItemByNodeHandle(handle, child);
-          if(ret.isValid())
-          {
-              return ret;
-          }
+            break;
         }
+        loadChildren(item);
+        item = mItemsByHandle.value(pathHandle);
+    }
+
+    if(!item)
+    {
+        // A node of the path may have been moved since its parent was cached
+        foreach(auto pathHandle, path)
+        {
+            mParentHandles.remove(pathHandle);
+        }
+        return QModelIndex();
+    }
+
+    return getIndexFromItem(item);
+}
+
+void MegaItemModel::loadChildren(MegaItem* item) const
+{
+    if (!item->areChildrenSet())
+    {
+        auto children = std::shared_ptr<MegaNodeList>(mMegaApi->getChildren(item->getNode().get()));
+        item->setChildren(children);
+        for(int i = 0; i < item->getNumChildren(); ++i)
+        {
+            addItemToIndex(item->getChild(i));
+        }
+    }
+}
+
+void MegaItemModel::addItemToIndex(MegaItem* item) const
+{
+    if(item && item->getNode())
+    {
+        mItemsByHandle.insert(item->getNode()->getHandle(), item);
+    }
+}
+
+void MegaItemModel::removeItemFromIndex(MegaItem* item)
+{
+    if(!item || !item->getNode())
+    {
+        return;
+    }
+
+    mItemsByHandle.remove(item->getNode()->getHandle());
+    if(item->areChildrenSet())
+    {
+        for(int i = 0; i < item->getNumChildren(); ++i)
+        {
+            removeItemFromIndex(item->getChild(i));
+        }
+    }
+}
+
+QModelIndex MegaItemModel::getIndexFromItem(MegaItem* item) const
+{
+    if(!item->getParent())
+    {
+        int row = mRootItems.indexOf(item);
+        return row >= 0 ? createIndex(row, COLUMN::NODE, item) : QModelIndex();
     }
-    return QModelIndex();
+    return createIndex(item->row(), COLUMN::NODE, item);
 }
 
 QIcon MegaItemModel::getFolderIcon(MegaItem *item) const
@@ -7,6 +7,7 @@
 #include <megaapi.h>
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QList>
 #include <QIcon>
 #include <QPointer>
@@ -68,6 +69,8 @@ public:
     void removeNode(const QModelIndex &item);
 
     std::shared_ptr<mega::MegaNode> getNode(const QModelIndex &index) const;
+    // Loads the children of the ancestors of the node when needed, invalid if the node is not in the model
+    QModelIndex findIndexByNodeHandle(const mega::MegaHandle& handle);
     QVariant getIcon(const QModelIndex &index, MegaItem* item) const;
     QVariant getText(const QModelIndex &index, MegaItem* item) const;
 
@@ -76,6 +79,8 @@ public:
 private slots:
     void onItemInfoUpdated(int role);
     void onMyBackupsFolderHandleSet(mega::MegaHandle h);
+    void onNodeSharesChanged(mega::MegaHandle handle);
+    void onNodeMoved(mega::MegaHandle handle);
 
 protected:
     QList<MegaItem *> mRootItems;
@@ -85,11 +90,19 @@ protected:
 
 private:
     int insertPosition(const std::unique_ptr<mega::MegaNode>& node);
-    QModelIndex findItemByNodeHandle(const mega::MegaHandle &handle, const QModelIndex& parent);
+    void loadChildren(MegaItem* item) const;
+    void addItemToIndex(MegaItem* item) const;
+    void removeItemFromIndex(MegaItem* item);
+    QModelIndex getIndexFromItem(MegaItem* item) const;
     QIcon getFolderIcon(MegaItem* item) const;
     std::shared_ptr<const UserAttributes::CameraUploadFolder> mCameraFolderAttribute;
     std::shared_ptr<const UserAttributes::MyChatFilesFolder> mMyChatFilesFolderAttribute;
     mega::MegaApi* mMegaApi;
+
+    // Items loaded so far by the handle of their node, filled as the children are loaded
+    mutable QHash<mega::MegaHandle, MegaItem*> mItemsByHandle;
+    // Parent handles of the nodes looked up that were not loaded yet, dropped when they are moved
+    QHash<mega::MegaHandle, mega::MegaHandle> mParentHandles;
 };
 
 #endif // MEGAITEMMODEL_H
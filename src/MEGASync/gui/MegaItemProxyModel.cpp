@@ -65,36 +65,41 @@ QModelIndex MegaItemProxyModel::getIndexFromHandle(const mega::MegaHandle& handl
     {
         return QModelIndex();
     }
-    auto megaApi = MegaSyncApp->getMegaApi();
-    auto node = std::shared_ptr<mega::MegaNode>(megaApi->getNodeByHandle(handle));
-    QModelIndex ret = getIndexFromNode(node);
-
-    return ret;
+    MegaItemModel* megaModel = getMegaModel();
+    return megaModel ? mapFromSource(megaModel->findIndexByNodeHandle(handle)) : QModelIndex();
 }
 
 QVector<QModelIndex> MegaItemProxyModel::getRelatedModelIndexes(const std::shared_ptr<mega::MegaNode> node, bool isInShare)
 {
     QVector<QModelIndex> ret;
 
-    if(!node)
+    MegaItemModel* megaModel = getMegaModel();
+    if(!node || !megaModel)
     {
         return ret;
     }
-    auto parentNodeList = std::shared_ptr<mega::MegaNodeList>(mega::MegaNodeList::createInstance());
-    parentNodeList->addNode(node.get());
-    mega::MegaApi* megaApi = MegaSyncApp->getMegaApi();
-    auto  rootNodeHandle = MegaSyncApp->getRootNode()->getHandle();
 
-    std::shared_ptr<mega::MegaNode> this_node = node;
-    while(this_node)
+    // The ancestors come from the items already loaded, from the node up
+    auto rootNodeHandle = MegaSyncApp->getRootNode()->getHandle();
+    for(QModelIndex sourceIndex = megaModel->findIndexByNodeHandle(node->getHandle());
+        sourceIndex.isValid(); sourceIndex = sourceIndex.parent())
+    {
+        if(isInShare && megaModel->getNode(sourceIndex)->getHandle() == rootNodeHandle)
+        {
+            break;
+        }
+        ret.prepend(mapFromSource(sourceIndex));
+    }
+
+    // Only the part of the path that is not filtered out
+    for(int i = 0; i < ret.size(); ++i)
     {
-        this_node.reset(megaApi->getParentNode(this_node.get()));
-        if(this_node && (!isInShare || this_node->getHandle() != rootNodeHandle))
+        if(!ret.at(i).isValid())
         {
-            parentNodeList->addNode(this_node.get());
+            ret.resize(i);
+            break;
         }
     }
-    ret.append(forEach(parentNodeList));
 
     return ret;
 }
@@ -151,68 +156,84 @@ bool MegaItemProxyModel::isShowOnlyVault()
 
 bool MegaItemProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    bool lIsFile = left.data(toInt(MegaItemModelRoles::IS_FILE_ROLE)).toBool();
-    bool rIsFile = right.data(toInt(MegaItemModelRoles::IS_FILE_ROLE)).toBool();
+    MegaItem* lItem = static_cast<MegaItem*>(left.internalPointer());
+    MegaItem* rItem = static_cast<MegaItem*>(right.internalPointer());
+    if(!lItem || !rItem)
+    {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+
+    const MegaItem::SortKey& lKey = lItem->getSortKey();
+    const MegaItem::SortKey& rKey = rItem->getSortKey();
 
-    if(lIsFile && !rIsFile)
+    if(lKey.isFile && !rKey.isFile)
     {
         return sortOrder() == Qt::DescendingOrder;
     }
-    else if(!lIsFile && rIsFile)
+    else if(!lKey.isFile && rKey.isFile)
     {
         return sortOrder() != Qt::DescendingOrder;
     }
 
     if(left.column() == MegaItemModel::DATE && right.column() == MegaItemModel::DATE)
     {
-        return left.data(toInt(MegaItemModelRoles::DATE_ROLE)) < right.data(toInt(MegaItemModelRoles::DATE_ROLE));
+        return lKey.creationTime < rKey.creationTime;
     }
     if(left.column() == MegaItemModel::STATUS && right.column() == MegaItemModel::STATUS)
     {
-      int lStatus = left.data(toInt(MegaItemModelRoles::STATUS_ROLE)).toInt();
-      int rStatus = right.data(toInt(MegaItemModelRoles::STATUS_ROLE)).toInt();
-      if(lStatus != rStatus)
+      if(lKey.status != rKey.status)
       {
-        return lStatus < rStatus;
+        return lKey.status < rKey.status;
       }
     }
 
-    return mCollator.compare(left.data(Qt::DisplayRole).toString(),
-                             right.data(Qt::DisplayRole).toString())<0;
+    // Only the name column shows text to compare
+    if(left.column() != MegaItemModel::NODE || right.column() != MegaItemModel::NODE)
+    {
+        return false;
+    }
+
+    return getNameSortKey(left, lItem).compare(getNameSortKey(right, rItem)) < 0;
 }
 
+const QCollatorSortKey& MegaItemProxyModel::getNameSortKey(const QModelIndex& index, MegaItem* item) const
+{
+    auto& key = item->getSortKey();
+    if(!key.name)
+    {
+        key.name.reset(new QCollatorSortKey(mCollator.sortKey(index.data(Qt::DisplayRole).toString())));
+    }
+    return *key.name;
+}
 
 bool MegaItemProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
 {
+    // The filters apply to the top level items, everything below them is shown
+    if(sourceParent.isValid())
+    {
+        return true;
+    }
+
     QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
     if(index.isValid())
     {
         if(MegaItem* megaItem = static_cast<MegaItem*>(index.internalPointer()))
         {
-            if(std::shared_ptr<mega::MegaNode> node = megaItem->getNode())
+            if(megaItem->isInShare())
+            {
+                int accs = megaItem->getAccess();
+                if((accs == mega::MegaShare::ACCESS_READ && !mFilter.showReadOnly)
+                   || (accs == mega::MegaShare::ACCESS_READWRITE && !mFilter.showReadWriteFolders))
+                {
+                    return false;
+                }
+            }
+            else if(megaItem->isVault())
             {
-               QModelIndex parentIndex = index.parent();
-               if(parentIndex.isValid())
-               {
-                   return filterAcceptsRow(index.row(), index);
-               }
-               mega::MegaApi* megaApi = MegaSyncApp->getMegaApi();
-               int accs = megaApi->getAccess(node.get());
-               if(node->isInShare())
-               {
-                    if((accs == mega::MegaShare::ACCESS_READ && !mFilter.showReadOnly)
-                       || (accs == mega::MegaShare::ACCESS_READWRITE && !mFilter.showReadWriteFolders))
-                    {
-                        return false;
-                    }
-               }
-               else if(megaItem->isVault())
-               {
-                    return !mFilter.showInShares && !mFilter.showCloudDrive;
-               }
-               return ((node->isInShare() && mFilter.showInShares)
-                       || (!node->isInShare() && mFilter.showCloudDrive));
+                return !mFilter.showInShares && !mFilter.showCloudDrive;
             }
+            return ((megaItem->isInShare() && mFilter.showInShares)
+                    || (!megaItem->isInShare() && mFilter.showCloudDrive));
         }
     }
     return QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
@@ -234,60 +255,9 @@ bool MegaItemProxyModel::filterAcceptsColumn(int sourceColumn, const QModelIndex
     return false;
 }
 
-QVector<QModelIndex> MegaItemProxyModel::forEach(std::shared_ptr<mega::MegaNodeList> parentNodeList, QModelIndex parent)
-{
-    QVector<QModelIndex> ret;
-
-    for(int j = parentNodeList->size()-1; j >= 0; --j)
-    {
-        auto handle = parentNodeList->get(j)->getHandle();
-        for(int i = 0; i < sourceModel()->rowCount(parent); ++i)
-        {
-            QModelIndex index = sourceModel()->index(i, 0, parent);
-
-            if(MegaItem* megaItem = static_cast<MegaItem*>(index.internalPointer()))
-            {
-                if(handle == megaItem->getNode()->getHandle())
-                {
-                    ret.append(mapFromSource(index));
-
-                    auto interList = std::shared_ptr<mega::MegaNodeList>(mega::MegaNodeList::createInstance());
-                    for(int k = 0; k < parentNodeList->size() - 1; ++k)
-                    {
-                        interList->addNode(parentNodeList->get(k));
-                    }
-                    ret.append(forEach(interList, index));
-                    break;
-                }
-            }
-        }
-    }
-
-    return ret;
-}
-
 QModelIndex MegaItemProxyModel::getIndexFromNode(const std::shared_ptr<mega::MegaNode> node)
 {
-    if(!node)
-    {
-        return QModelIndex();
-    }
-    mega::MegaApi* megaApi = MegaSyncApp->getMegaApi();
-
-    std::shared_ptr<mega::MegaNode> root_p_node = node;
-    auto p_node = std::unique_ptr<mega::MegaNode>(megaApi->getParentNode(root_p_node.get()));
-    while(p_node)
-    {
-        root_p_node = std::move(p_node);
-        p_node.reset(megaApi->getParentNode(root_p_node.get()));
-    }
-
-    QVector<QModelIndex> indexList = getRelatedModelIndexes(node, root_p_node->isInShare());
-    if(!indexList.isEmpty())
-    {
-        return indexList.last();
-    }
-    return QModelIndex();
+    return node ? getIndexFromHandle(node->getHandle()) : QModelIndex();
 }
 
 MegaItemModel *MegaItemProxyModel::getMegaModel()
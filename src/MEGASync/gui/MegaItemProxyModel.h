@@ -10,6 +10,7 @@ namespace mega{
 class MegaNode;
 }
 class MegaItemModel;
+class MegaItem;
 
 class MegaItemProxyModel : public QSortFilterProxyModel
 {
@@ -57,8 +58,9 @@ protected:
     bool filterAcceptsColumn(int sourceColumn, const QModelIndex& sourceParent) const override;
 
 private:
-    QVector<QModelIndex> forEach(std::shared_ptr<mega::MegaNodeList> parentNodeList, QModelIndex parent = QModelIndex());
     MegaItemModel* getMegaModel();
+    // Computed once per item, comparing the keys is much cheaper than comparing the names
+    const QCollatorSortKey& getNameSortKey(const QModelIndex& index, MegaItem* item) const;
     Filter mFilter;
     QCollator mCollator;
 };
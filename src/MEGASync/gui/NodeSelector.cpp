@@ -754,18 +754,15 @@ void NodeSelector::restoreExpandedItems(Navigation& nav)
     nav.expandedHandles.clear();
 }
 
-void NodeSelector::iterateForRestore(const QList<MegaHandle> &list, const QModelIndex &parent)
+void NodeSelector::iterateForRestore(const QList<MegaHandle> &list)
 {
-    if(list.isEmpty())
-        return;
-
-    for(int i=0; i < mProxyModel->rowCount(parent); ++i)
+    // The handles were saved parents first, each one is found through the model index
+    foreach(auto handle, list)
     {
-        auto idx = mProxyModel->index(i, 0, parent);
-        if(idx.isValid() && list.contains(mProxyModel->getNode(idx)->getHandle()))
+        auto idx = mProxyModel->getIndexFromHandle(handle);
+        if(idx.isValid())
         {
            ui->tMegaFolders->expand(idx);
-           iterateForRestore(list, idx);
         }
     }
 }
@@ -97,7 +97,7 @@ private:
     void iterateForSaveExpanded(QList<mega::MegaHandle>& saveList, const QModelIndex& parent = QModelIndex());
     void restoreExpandedItems();
     void restoreExpandedItems(Navigation &nav);
-    void iterateForRestore(const QList<mega::MegaHandle> &list, const QModelIndex& parent = QModelIndex());
+    void iterateForRestore(const QList<mega::MegaHandle> &list);
     bool isAllowedToEnterInIndex(const QModelIndex & idx);
     bool isCloudDrive();
     bool isVault();
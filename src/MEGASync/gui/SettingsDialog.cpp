@@ -3,6 +3,7 @@
 #include "QMegaMessageBox.h"
 #include "ui_SettingsDialog.h"
 #include "control/Utilities.h"
+#include "control/DebrisSizeAccountant.h"
 #include "platform/Platform.h"
 #include "AddExclusionDialog.h"
 #include "BandwidthSettings.h"
@@ -62,34 +63,6 @@ const QString SYNCS_TAB_MENU_LABEL_QSS = QString::fromUtf8("QLabel{ border-image
 static constexpr int NUMBER_OF_CLICKS_TO_DEBUG {5};
 static constexpr int NETWORK_LIMITS_MAX {9999};
 
-long long calculateCacheSize()
-{
-    long long cacheSize = 0;
-    auto model (SyncInfo::instance());
-    for (auto syncType : SyncInfo::AllHandledSyncTypes)
-    {
-        for (int i = 0; i < model->getNumSyncedFolders(syncType); i++)
-        {
-            auto syncSetting = model->getSyncSetting(i, syncType);
-            QString syncPath = syncSetting->getLocalFolder();
-            if (!syncPath.isEmpty())
-            {
-                Utilities::getFolderSize(syncPath + QDir::separator()
-                                         + QString::fromUtf8(MEGA_DEBRIS_FOLDER), &cacheSize);
-            }
-        }
-    }
-    return cacheSize;
-}
-
-long long calculateRemoteCacheSize(MegaApi* mMegaApi)
-{
-    MegaNode* n = mMegaApi->getNodeByPath("//bin/SyncDebris");
-    long long size = mMegaApi->getSize(n);
-    delete n;
-    return size;
-}
-
 SettingsDialog::SettingsDialog(MegaApplication* app, bool proxyOnly, QWidget* parent) :
     QDialog (parent),
     mUi (new Ui::SettingsDialog),
@@ -474,16 +447,16 @@ void SettingsDialog::loadSettings()
 
     if (mPreferences->logged())
     {
-        connect(&mCacheSizeWatcher, &QFutureWatcher<long long>::finished,
-                this, &SettingsDialog::onLocalCacheSizeAvailable);
-        QFuture<long long> futureCacheSize = QtConcurrent::run(calculateCacheSize);
-        mCacheSizeWatcher.setFuture(futureCacheSize);
-
-        connect(&mRemoteCacheSizeWatcher, &QFutureWatcher<long long>::finished,
-                this, &SettingsDialog::onRemoteCacheSizeAvailable);
-        QFuture<long long> futureRemoteCacheSize = QtConcurrent::run(calculateRemoteCacheSize,
-                                                                     mMegaApi);
-        mRemoteCacheSizeWatcher.setFuture(futureRemoteCacheSize);
+        // Last known sizes are shown right away, and updated if they change
+        auto debrisSizes (DebrisSizeAccountant::instance());
+        mCacheSize = debrisSizes->localSize();
+        mRemoteCacheSize = debrisSizes->remoteSize();
+        connect(debrisSizes, &DebrisSizeAccountant::localSizeChanged,
+                this, &SettingsDialog::onLocalCacheSizeAvailable, Qt::UniqueConnection);
+        connect(debrisSizes, &DebrisSizeAccountant::remoteSizeChanged,
+                this, &SettingsDialog::onRemoteCacheSizeAvailable, Qt::UniqueConnection);
+        onCacheSizeAvailable();
+        debrisSizes->refresh();
     }
 
     //General
@@ -689,15 +662,15 @@ void SettingsDialog::storageChanged()
     onCacheSizeAvailable();
 }
 
-void SettingsDialog::onLocalCacheSizeAvailable()
+void SettingsDialog::onLocalCacheSizeAvailable(long long size)
 {
-    mCacheSize = mCacheSizeWatcher.result();
+    mCacheSize = size;
     onCacheSizeAvailable();
 }
 
-void SettingsDialog::onRemoteCacheSizeAvailable()
+void SettingsDialog::onRemoteCacheSizeAvailable(long long size)
 {
-    mRemoteCacheSize = mRemoteCacheSizeWatcher.result();
+    mRemoteCacheSize = size;
     onCacheSizeAvailable();
 }
 
@@ -939,8 +912,7 @@ void SettingsDialog::on_bClearRemoteCache_clicked()
     delete syncDebris;
 
     QtConcurrent::run(deleteRemoteCache, mMegaApi);
-    mRemoteCacheSize = 0;
-    onCacheSizeAvailable();
+    DebrisSizeAccountant::instance()->remoteDebrisCleared();
 }
 
 void SettingsDialog::on_bClearFileVersions_clicked()
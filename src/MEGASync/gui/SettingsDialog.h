@@ -16,8 +16,6 @@
 #include "megaapi.h"
 
 #include <QDialog>
-#include <QFuture>
-#include <QFutureWatcher>
 #include <QtCore>
 
 #ifdef Q_OS_MACOS
@@ -91,8 +89,8 @@ public slots:
     void showGuestMode();
 
     // General
-    void onLocalCacheSizeAvailable();
-    void onRemoteCacheSizeAvailable();
+    void onLocalCacheSizeAvailable(long long size);
+    void onRemoteCacheSizeAvailable(long long size);
 
     // Account
     void storageStateChanged(int state);
@@ -236,8 +234,6 @@ private:
     int mLoadingSettings;
     ThreadPool* mThreadPool;
     QStringList mLanguageCodes;
-    QFutureWatcher<long long> mCacheSizeWatcher;
-    QFutureWatcher<long long> mRemoteCacheSizeWatcher;
     AccountDetailsDialog* mAccountDetailsDialog;
     long long mCacheSize;
     long long mRemoteCacheSize;
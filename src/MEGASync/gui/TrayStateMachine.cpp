@@ -0,0 +1,396 @@
+#include "TrayStateMachine.h"
+
+#include "Preferences.h"
+
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QPixmap>
+
+namespace
+{
+const int ANIMATION_INTERVAL_MS = 500;
+
+// Sizes requested by the system trays we support, in logical pixels
+const int TRAY_ICON_SIZES[] = {16, 20, 22, 24, 32, 48};
+
+#ifdef _WIN32
+const char* const ICON_PATHS[] = {
+    "://images/warning_ico.ico",
+    "://images/tray_sync.ico",
+    "://images/app_ico.ico",
+    "://images/tray_pause.ico",
+    "://images/login_ico.ico",
+    "://images/alert_ico.ico"
+};
+#elif defined(__APPLE__)
+const char* const ICON_PATHS[] = {
+    "://images/icon_overquota_mac.png",
+    "://images/icon_syncing_mac.png",
+    "://images/icon_synced_mac.png",
+    "://images/icon_paused_mac.png",
+    "://images/icon_logging_mac.png",
+    "://images/icon_alert_mac.png",
+    "://images/icon_syncing_mac1.png",
+    "://images/icon_syncing_mac2.png",
+    "://images/icon_syncing_mac3.png",
+    "://images/icon_syncing_mac4.png"
+};
+#else
+const char* const ICON_PATHS[] = {
+    "://images/warning.svg",
+    "://images/synching.svg",
+    "://images/uptodate.svg",
+    "://images/paused.svg",
+    "://images/logging.svg",
+    "://images/alert.svg"
+};
+
+// Names looked up in the icon theme before falling back to the bundled icons
+const char* const THEME_ICON_NAMES[] = {
+    "megawarning",
+    "megasynching",
+    "megauptodate",
+    "megapaused",
+    "megalogging",
+    "megaalert"
+};
+#endif
+
+void addRenderedPixmap(QIcon& icon, const QString& path, int size)
+{
+    QImageReader reader(path);
+    reader.setScaledSize(QSize(size, size));
+    QImage image = reader.read();
+    if (!image.isNull())
+    {
+        icon.addPixmap(QPixmap::fromImage(image));
+    }
+}
+}
+
+TrayStateMachine::TrayStateMachine(QSystemTrayIcon* trayIcon, QObject* parent)
+    : QObject(parent),
+      mTrayIcon(trayIcon),
+      mSession(Session::STARTING),
+      mActivity(Activity::NONE),
+      mDisabledSyncs(NO_DISABLED_SYNCS),
+      mFailedTransfers(0),
+      mOverQuota(false),
+      mBlocked(false),
+      mPaused(false),
+      mConnected(true),
+      mUpdateAvailable(false),
+      mState(State::STARTING),
+      mAppliedIcon(-1),
+      mAtlasRatio(0.0),
+      mAnimationFrame(1)
+{
+    mUpdateTimer.setSingleShot(true);
+    mUpdateTimer.setInterval(0);
+    connect(&mUpdateTimer, &QTimer::timeout, this, &TrayStateMachine::onUpdate);
+
+    mAnimationTimer.setSingleShot(false);
+    mAnimationTimer.setInterval(ANIMATION_INTERVAL_MS);
+    connect(&mAnimationTimer, &QTimer::timeout, this, &TrayStateMachine::onAnimationStep);
+
+    // The tray can't be shown without an icon, so the initial state is applied right away
+    onUpdate();
+}
+
+void TrayStateMachine::setSession(Session session)
+{
+    setInput(mSession, session);
+}
+
+void TrayStateMachine::setOverQuota(bool overQuota)
+{
+    setInput(mOverQuota, overQuota);
+}
+
+void TrayStateMachine::setBlocked(bool blocked)
+{
+    setInput(mBlocked, blocked);
+}
+
+void TrayStateMachine::setDisabledSyncs(int disabledSyncs)
+{
+    setInput(mDisabledSyncs, disabledSyncs);
+}
+
+void TrayStateMachine::setPaused(bool paused)
+{
+    setInput(mPaused, paused);
+}
+
+void TrayStateMachine::setActivity(Activity activity)
+{
+    setInput(mActivity, activity);
+}
+
+void TrayStateMachine::setFailedTransfers(long long failedTransfers)
+{
+    setInput(mFailedTransfers, failedTransfers);
+}
+
+void TrayStateMachine::setConnected(bool connected)
+{
+    setInput(mConnected, connected);
+}
+
+void TrayStateMachine::setUpdateAvailable(bool updateAvailable)
+{
+    setInput(mUpdateAvailable, updateAvailable);
+}
+
+TrayStateMachine::State TrayStateMachine::state() const
+{
+    return computeState();
+}
+
+bool TrayStateMachine::isIdle() const
+{
+    State state = computeState();
+    return !mPaused && (state == State::UP_TO_DATE || state == State::ISSUES_FOUND);
+}
+
+void TrayStateMachine::refresh()
+{
+    mAtlasRatio = 0.0;
+    mAppliedToolTip.clear();
+    mUpdateTimer.start();
+}
+
+void TrayStateMachine::onUpdate()
+{
+    if (!mTrayIcon)
+    {
+        return;
+    }
+
+    const qreal ratio = qGuiApp->devicePixelRatio();
+    if (ratio != mAtlasRatio)
+    {
+        for (QIcon& icon : mAtlas)
+        {
+            icon = QIcon();
+        }
+        mAtlasRatio = ratio;
+        mAppliedIcon = -1;
+    }
+
+    mState = computeState();
+
+    Icon icon = ICON_LOGGING;
+    QString text = QCoreApplication::translate("MegaApplication", "No Internet connection");
+    if (mConnected)
+    {
+        icon = stateIcon(mState);
+        text = stateText(mState);
+    }
+
+    QString toolTip = QString::fromUtf8("%1 %2\n%3").arg(QCoreApplication::applicationName())
+                                                    .arg(Preferences::VERSION_STRING)
+                                                    .arg(text);
+    if (mUpdateAvailable)
+    {
+        toolTip += QString::fromUtf8("\n") + QCoreApplication::translate("MegaApplication", "Update available!");
+    }
+
+    if (toolTip != mAppliedToolTip)
+    {
+        mTrayIcon->setToolTip(toolTip);
+        mAppliedToolTip = toolTip;
+    }
+
+#ifdef __APPLE__
+    if (icon == ICON_SYNCHING)
+    {
+        // The animation owns the icon while it runs
+        if (!mAnimationTimer.isActive() || mAppliedIcon < 0)
+        {
+            mAnimationFrame = 1;
+            applyIcon(icon);
+            mAnimationTimer.start();
+        }
+        return;
+    }
+    mAnimationTimer.stop();
+#endif
+
+    applyIcon(icon);
+}
+
+void TrayStateMachine::onAnimationStep()
+{
+    mAnimationFrame = mAnimationFrame % ANIMATION_FRAMES + 1;
+    applyIcon(ICON_COUNT + mAnimationFrame - 1);
+}
+
+TrayStateMachine::State TrayStateMachine::computeState() const
+{
+    if (mOverQuota)
+    {
+        return State::OVER_QUOTA;
+    }
+    if (mBlocked)
+    {
+        return State::BLOCKED;
+    }
+    if (mDisabledSyncs != NO_DISABLED_SYNCS)
+    {
+        return State::SYNCS_DISABLED;
+    }
+
+    switch (mSession)
+    {
+        case Session::STARTING:
+            return State::STARTING;
+        case Session::LOGGING_IN:
+            return State::LOGGING_IN;
+        case Session::LOGGED_OUT:
+            return State::LOGGED_OUT;
+        case Session::FETCHING_NODES:
+            return State::FETCHING_NODES;
+        case Session::READY:
+            break;
+    }
+
+    if (mPaused)
+    {
+        return mFailedTransfers > 0 ? State::ISSUES_FOUND : State::PAUSED;
+    }
+    if (mActivity != Activity::NONE)
+    {
+        return State::BUSY;
+    }
+    return mFailedTransfers > 0 ? State::ISSUES_FOUND : State::UP_TO_DATE;
+}
+
+QString TrayStateMachine::stateText(State state) const
+{
+    switch (state)
+    {
+        case State::STARTING:
+            return QCoreApplication::translate("MegaApplication", "Starting");
+        case State::LOGGING_IN:
+            return QCoreApplication::translate("MegaApplication", "Logging in");
+        case State::LOGGED_OUT:
+            return QCoreApplication::translate("MegaApplication", "You are not logged in");
+        case State::FETCHING_NODES:
+            return QCoreApplication::translate("MegaApplication", "Fetching file list...");
+        case State::OVER_QUOTA:
+            return QCoreApplication::translate("MegaApplication", "Over quota");
+        case State::BLOCKED:
+            return QCoreApplication::translate("MegaApplication", "Locked account");
+        case State::SYNCS_DISABLED:
+            if (mDisabledSyncs == (DISABLED_SYNCS | DISABLED_BACKUPS))
+            {
+                return QCoreApplication::translate("MegaApplication", "Some syncs and backups have been disabled");
+            }
+            else if (mDisabledSyncs & DISABLED_BACKUPS)
+            {
+                return QCoreApplication::translate("MegaApplication", "One or more backups have been disabled");
+            }
+            return QCoreApplication::translate("MegaApplication", "One or more syncs have been disabled");
+        case State::PAUSED:
+            return QCoreApplication::translate("MegaApplication", "Paused");
+        case State::BUSY:
+            switch (mActivity)
+            {
+                case Activity::INDEXING:
+                    return QCoreApplication::translate("MegaApplication", "Scanning");
+                case Activity::SYNCING:
+                    return QCoreApplication::translate("MegaApplication", "Syncing");
+                case Activity::WAITING:
+                    return QCoreApplication::translate("MegaApplication", "Waiting");
+                default:
+                    return QCoreApplication::translate("MegaApplication", "Transferring");
+            }
+        case State::UP_TO_DATE:
+            return QCoreApplication::translate("MegaApplication", "Up to date");
+        case State::ISSUES_FOUND:
+            return QCoreApplication::translate("TransferManager", "Issue found", "", static_cast<int>(mFailedTransfers));
+    }
+    return QString();
+}
+
+TrayStateMachine::Icon TrayStateMachine::stateIcon(State state) const
+{
+    switch (state)
+    {
+        case State::STARTING:
+        case State::LOGGING_IN:
+        case State::FETCHING_NODES:
+        case State::BUSY:
+            return ICON_SYNCHING;
+        case State::LOGGED_OUT:
+        case State::UP_TO_DATE:
+            return ICON_UPTODATE;
+        case State::OVER_QUOTA:
+        case State::ISSUES_FOUND:
+            return ICON_WARNING;
+        case State::BLOCKED:
+        case State::SYNCS_DISABLED:
+            return ICON_ALERT;
+        case State::PAUSED:
+            return ICON_PAUSED;
+    }
+    return ICON_UPTODATE;
+}
+
+const QIcon& TrayStateMachine::atlasIcon(int index)
+{
+    QIcon& icon = mAtlas[index];
+    if (icon.isNull())
+    {
+        icon = renderIcon(index);
+    }
+    return icon;
+}
+
+QIcon TrayStateMachine::renderIcon(int index) const
+{
+#ifdef _WIN32
+    // .ico files already contain a bitmap for each size
+    return index < ICON_COUNT ? QIcon(QString::fromUtf8(ICON_PATHS[index])) : QIcon();
+#else
+    if (index >= static_cast<int>(sizeof(ICON_PATHS) / sizeof(ICON_PATHS[0])))
+    {
+        return QIcon();
+    }
+
+    QString path = QString::fromUtf8(ICON_PATHS[index]);
+    QIcon rendered;
+    for (int size : TRAY_ICON_SIZES)
+    {
+        addRenderedPixmap(rendered, path, size);
+        if (mAtlasRatio > 1.0)
+        {
+            addRenderedPixmap(rendered, path, qRound(size * mAtlasRatio));
+        }
+    }
+
+#ifdef __APPLE__
+    rendered.setIsMask(true);
+    return rendered;
+#else
+    return QIcon::fromTheme(QString::fromUtf8(THEME_ICON_NAMES[index]), rendered);
+#endif
+#endif
+}
+
+void TrayStateMachine::applyIcon(int index)
+{
+    if (index == mAppliedIcon || !mTrayIcon)
+    {
+        return;
+    }
+
+    const QIcon& icon = atlasIcon(index);
+    if (!icon.isNull())
+    {
+        mTrayIcon->setIcon(icon);
+        mAppliedIcon = index;
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef TRAYSTATEMACHINE_H
+#define TRAYSTATEMACHINE_H
+
+#include <QIcon>
+#include <QObject>
+#include <QPointer>
+#include <QSystemTrayIcon>
+#include <QTimer>
+
+// Icon and tooltip of the tray, derived from explicit inputs (session, sync and transfer activity,
+// quota, account block...). Setting an input only reevaluates the state, and the tray is touched
+// only when the icon or the tooltip that would be shown actually change.
+// Icons are rendered once per state and device pixel ratio and reused afterwards.
+class TrayStateMachine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Session
+    {
+        STARTING,
+        LOGGING_IN,
+        LOGGED_OUT,
+        FETCHING_NODES,
+        READY
+    };
+
+    // Ordered by priority when several of them happen at the same time
+    enum class Activity
+    {
+        NONE,
+        TRANSFERRING,
+        WAITING,
+        SYNCING,
+        INDEXING
+    };
+
+    enum DisabledSyncs
+    {
+        NO_DISABLED_SYNCS = 0x0,
+        DISABLED_SYNCS    = 0x1,
+        DISABLED_BACKUPS  = 0x2
+    };
+
+    enum class State
+    {
+        STARTING,
+        LOGGING_IN,
+        LOGGED_OUT,
+        FETCHING_NODES,
+        OVER_QUOTA,
+        BLOCKED,
+        SYNCS_DISABLED,
+        PAUSED,
+        BUSY,
+        UP_TO_DATE,
+        ISSUES_FOUND
+    };
+
+    explicit TrayStateMachine(QSystemTrayIcon* trayIcon, QObject* parent = nullptr);
+
+    void setSession(Session session);
+    void setOverQuota(bool overQuota);
+    void setBlocked(bool blocked);
+    void setDisabledSyncs(int disabledSyncs);
+    void setPaused(bool paused);
+    void setActivity(Activity activity);
+    void setFailedTransfers(long long failedTransfers);
+    void setConnected(bool connected);
+    void setUpdateAvailable(bool updateAvailable);
+
+    // Connectivity is not part of the state: it only overrides what is shown
+    State state() const;
+    bool isIdle() const;
+
+    // Renders the icons and the texts again, e.g. after a change of icon theme or language
+    void refresh();
+
+private slots:
+    void onUpdate();
+    void onAnimationStep();
+
+private:
+    enum Icon
+    {
+        ICON_WARNING,
+        ICON_SYNCHING,
+        ICON_UPTODATE,
+        ICON_PAUSED,
+        ICON_LOGGING,
+        ICON_ALERT,
+        ICON_COUNT
+    };
+
+    static const int ANIMATION_FRAMES = 4;
+    static const int ATLAS_SIZE = ICON_COUNT + ANIMATION_FRAMES;
+
+    template <typename T>
+    void setInput(T& input, T value)
+    {
+        if (input != value)
+        {
+            input = value;
+            // Inputs usually change in groups, they are applied together once control returns to the event loop
+            mUpdateTimer.start();
+        }
+    }
+
+    State computeState() const;
+    QString stateText(State state) const;
+    Icon stateIcon(State state) const;
+
+    const QIcon& atlasIcon(int index);
+    QIcon renderIcon(int index) const;
+    void applyIcon(int index);
+
+    QPointer<QSystemTrayIcon> mTrayIcon;
+
+    Session mSession;
+    Activity mActivity;
+    int mDisabledSyncs;
+    long long mFailedTransfers;
+    bool mOverQuota;
+    bool mBlocked;
+    bool mPaused;
+    bool mConnected;
+    bool mUpdateAvailable;
+
+    State mState;
+    int mAppliedIcon;
+    QString mAppliedToolTip;
+
+    QIcon mAtlas[ATLAS_SIZE];
+    qreal mAtlasRatio;
+
+    QTimer mUpdateTimer;
+    QTimer mAnimationTimer;
+    int mAnimationFrame;
+};
+
+#endif // TRAYSTATEMACHINE_H
@@ -4,6 +4,7 @@ SOURCES += $$PWD/SettingsDialog.cpp \
     $$PWD/BalloonToolTip.cpp \
     $$PWD/BlurredShadowEffect.cpp \
     $$PWD/ButtonIconManager.cpp \
+    $$PWD/TrayStateMachine.cpp \
     $$PWD/MegaItemDelegates.cpp \
     $$PWD/EventHelper.cpp \
     $$PWD/InfoDialog.cpp \
@@ -72,6 +73,7 @@ HEADERS  += $$PWD/SettingsDialog.h \
     $$PWD/BalloonToolTip.h \
     $$PWD/BlurredShadowEffect.h \
     $$PWD/ButtonIconManager.h \
+    $$PWD/TrayStateMachine.h \
     $$PWD/DialogGeometryRetainer.h \
     $$PWD/MegaItemDelegates.h \
     $$PWD/EventHelper.h \
@@ -6,6 +6,7 @@
 #include "control/CrashHandler.h"
 #include "ScaleFactorManager.h"
 
+#include <QElapsedTimer>
 #include <QFontDatabase>
 #include <assert.h>
 
@@ -481,9 +482,20 @@ int main(int argc, char *argv[])
     CrashHandler::instance()->Init(QDir::toNativeSeparators(crashPath));
 #endif
 
+    // A previous instance exiting after an update or a relaunch usually releases the lock
+    // in a fraction of a second, so the lock is polled often until the deadline
+    const int singleInstanceWaitMs = 10000;
+    const unsigned int singleInstancePollMs = 100;
+    const qint64 lockWaitStart = app.getStartupOrchestrator()->elapsed();
+    QElapsedTimer lockTimer;
+    lockTimer.start();
+#ifdef __APPLE__
+    bool staleInstanceKilled = false;
+#endif
+
     QtLockedFile singleInstanceChecker(appLockPath);
     bool alreadyStarted = true;
-    for (int i = 0; i < 10; i++)
+    for (int i = 0; lockTimer.elapsed() < singleInstanceWaitMs; i++)
     {
         if (i > 0)
         {
@@ -517,8 +529,9 @@ int main(int argc, char *argv[])
              }
         }
 #ifdef __APPLE__
-        else if (i == 5)
+        else if (!staleInstanceKilled && lockTimer.elapsed() >= singleInstanceWaitMs / 2)
         {
+            staleInstanceKilled = true;
             QString appVersionPath = dataDir.filePath(QString::fromUtf8("megasync.version"));
             QFile fappVersionPath(appVersionPath);
             if (!fappVersionPath.exists())
@@ -528,12 +541,9 @@ int main(int argc, char *argv[])
         }
 #endif
 
-        #ifdef WIN32
-            Sleep(1000);
-        #else
-            sleep(1);
-        #endif
+        Utilities::sleepMilliseconds(singleInstancePollMs);
     }
+    app.getStartupOrchestrator()->recordPhase(QString::fromUtf8("singleInstanceLock"), lockWaitStart, lockTimer.elapsed());
 
     QString appVersionPath = dataDir.filePath(QString::fromUtf8("megasync.version"));
     QFile fappVersionPath(appVersionPath);
@@ -568,7 +578,10 @@ int main(int argc, char *argv[])
     QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Semibold.ttf"));
 
     app.initialize();
+    const qint64 startBegin = app.getStartupOrchestrator()->elapsed();
     app.start();
+    app.getStartupOrchestrator()->recordPhase(QString::fromUtf8("start"), startBegin,
+                                              app.getStartupOrchestrator()->elapsed() - startBegin);
 
     int toret = app.exec();
 
@@ -5,6 +5,7 @@
 #include <unistd.h>
 #include "CommonMessages.h"
 #include "control/Utilities.h"
+#include "control/Tracer.h"
 
 using namespace mega;
 using namespace std;
@@ -89,6 +90,7 @@ void ExtServer::onClientDisconnected()
 // client sends some data
 void ExtServer::onClientData()
 {
+    TraceSpan span("ExtServer::onClientData", "shell");
     QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
     if (!client)
         return;
@@ -118,6 +120,7 @@ void ExtServer::onClientData()
 // parse incoming request and send response back to client
 const char *ExtServer::GetAnswerToRequest(const char *buf)
 {
+    TraceSpan span("ExtServer::GetAnswerToRequest", "shell", 0, static_cast<unsigned char>(buf[0]));
     char c = buf[0];
     const char *content = buf+2;
     static char out[BUFSIZE];
@@ -195,6 +195,14 @@ void LinuxPlatform::notifyAllSyncFoldersRemoved()
 
 }
 
+void LinuxPlatform::notifyLanguageChange(QString languageCode)
+{
+    if (notify_server)
+    {
+        notify_server->notifyLanguageChange(languageCode);
+    }
+}
+
 QByteArray LinuxPlatform::encrypt(QByteArray data, QByteArray /*key*/)
 {
     return data;
@@ -45,6 +45,7 @@ public:
     static void notifyRestartSyncFolders();
     static void notifyAllSyncFoldersAdded();
     static void notifyAllSyncFoldersRemoved();
+    static void notifyLanguageChange(QString languageCode);
     static QByteArray encrypt(QByteArray data, QByteArray key);
     static QByteArray decrypt(QByteArray data, QByteArray key);
     static QByteArray getLocalStorageKey();
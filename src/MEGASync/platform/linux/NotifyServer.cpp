@@ -3,6 +3,7 @@
 #include <pwd.h>
 #include <unistd.h>
 #include "control/Utilities.h"
+#include "control/Tracer.h"
 
 using namespace mega;
 using namespace std;
@@ -95,6 +96,7 @@ void NotifyServer::onClientDisconnected()
 // send string to all connected clients
 void NotifyServer::doSendToAll(const char *type, QByteArray str)
 {
+    TraceSpan span("NotifyServer::doSendToAll", "shell", 0, m_clients.size());
     foreach(QLocalSocket *socket, m_clients)
         if (socket && socket->state() == QLocalSocket::ConnectedState) {
             socket->write(type);
@@ -119,3 +121,9 @@ void NotifyServer::notifySyncDel(QString path)
     emit sendToAll("D", path.toUtf8());
 }
 
+// clients drop the translated strings they cached
+void NotifyServer::notifyLanguageChange(QString languageCode)
+{
+    emit sendToAll("L", languageCode.toUtf8());
+}
+
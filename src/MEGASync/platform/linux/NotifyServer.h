@@ -15,6 +15,7 @@ class NotifyServer: public QObject
     void notifyItemChange(std::string *localPath);
     void notifySyncAdd(QString path);
     void notifySyncDel(QString path);
+    void notifyLanguageChange(QString languageCode);
 
  protected:
     QLocalServer *m_localServer;
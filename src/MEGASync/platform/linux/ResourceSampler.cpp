@@ -0,0 +1,256 @@
+#include "ResourceSampler.h"
+
+#include "megaapi.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace mega;
+
+namespace
+{
+constexpr size_t PROC_BUFFER_SIZE = 4096;
+// Warn once about RSS growth over a full ring when it is above both thresholds
+constexpr long long GROWTH_WARNING_BYTES = 128 * 1024 * 1024;
+constexpr int GROWTH_WARNING_PERCENT = 50;
+
+// Reads a whole /proc file into buffer without going through Qt or iostreams
+bool readProcFile(const char* path, char* buffer, size_t size)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    size_t used = 0;
+    while (used + 1 < size)
+    {
+        ssize_t bytes = read(fd, buffer + used, size - used - 1);
+        if (bytes <= 0)
+        {
+            break;
+        }
+        used += static_cast<size_t>(bytes);
+    }
+    close(fd);
+    buffer[used] = '\0';
+    return used > 0;
+}
+
+// Returns the number following "key" at the beginning of a line, or -1
+long long parseField(const char* buffer, const char* key)
+{
+    size_t keyLen = strlen(key);
+    for (const char* line = buffer; line && *line; )
+    {
+        if (!strncmp(line, key, keyLen))
+        {
+            return strtoll(line + keyLen, nullptr, 10);
+        }
+        line = strchr(line, '\n');
+        if (line)
+        {
+            ++line;
+        }
+    }
+    return -1;
+}
+}
+
+ResourceSampler::ResourceSampler(QObject* parent)
+    : QObject(parent),
+      mNext(0),
+      mCount(0),
+      mGrowthReported(false)
+{
+    connect(&mTimer, &QTimer::timeout, this, &ResourceSampler::onSampleTimeout);
+}
+
+bool ResourceSampler::addProbe(const QString& name, std::function<long long()> probe)
+{
+    if (mProbes.size() >= MAX_PROBES)
+    {
+        return false;
+    }
+    mProbeNames.append(name);
+    mProbes.append(std::move(probe));
+    return true;
+}
+
+void ResourceSampler::start(int intervalMs)
+{
+    mTimer.start(intervalMs);
+}
+
+void ResourceSampler::stop()
+{
+    mTimer.stop();
+}
+
+const ResourceSampler::Sample& ResourceSampler::takeSample()
+{
+    Sample& sample = mRing[mNext];
+    sample = Sample();
+    sample.timestamp = QDateTime::currentMSecsSinceEpoch();
+    readStatus(sample);
+    readSmapsRollup(sample);
+    readIo(sample);
+    sample.openFds = countOpenFds();
+    for (int i = 0; i < mProbes.size(); ++i)
+    {
+        sample.probes[i] = mProbes[i] ? mProbes[i]() : 0;
+    }
+
+    mNext = (mNext + 1) % RING_SIZE;
+    if (mCount < RING_SIZE)
+    {
+        ++mCount;
+    }
+    return sample;
+}
+
+bool ResourceSampler::getLatestSample(Sample& sample) const
+{
+    if (!mCount)
+    {
+        return false;
+    }
+    sample = mRing[(mNext + RING_SIZE - 1) % RING_SIZE];
+    return true;
+}
+
+long long ResourceSampler::getRssGrowth() const
+{
+    if (mCount < 2)
+    {
+        return 0;
+    }
+    const Sample& newest = mRing[(mNext + RING_SIZE - 1) % RING_SIZE];
+    const Sample& oldest = mRing[(mNext + RING_SIZE - mCount) % RING_SIZE];
+    return newest.rss - oldest.rss;
+}
+
+void ResourceSampler::onSampleTimeout()
+{
+    const Sample& sample = takeSample();
+    logSample(sample);
+
+    if (mCount == RING_SIZE && !mGrowthReported)
+    {
+        long long growth = getRssGrowth();
+        long long base = sample.rss - growth;
+        if (growth > GROWTH_WARNING_BYTES && base > 0 && growth * 100 / base > GROWTH_WARNING_PERCENT)
+        {
+            mGrowthReported = true;
+            MegaApi::log(MegaApi::LOG_LEVEL_WARNING,
+                         QString::fromUtf8("Sustained memory growth: RSS +%1 MB in the last %2 samples")
+                         .arg(growth / (1024 * 1024)).arg(RING_SIZE).toUtf8().constData());
+        }
+    }
+}
+
+void ResourceSampler::logSample(const Sample& sample) const
+{
+    QString probes;
+    for (int i = 0; i < mProbeNames.size(); ++i)
+    {
+        probes += QString::fromUtf8(" / %1: %2").arg(mProbeNames[i]).arg(sample.probes[i]);
+    }
+
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG,
+                 QString::fromUtf8("Resource usage: RSS %1 MB / PSS %2 MB / Swap %3 MB / %4 threads / %5 fds / IO %6 MB read %7 MB written%8")
+                 .arg(sample.rss / (1024 * 1024))
+                 .arg(sample.pss / (1024 * 1024))
+                 .arg(sample.swap / (1024 * 1024))
+                 .arg(sample.threads)
+                 .arg(sample.openFds)
+                 .arg(sample.readBytes / (1024 * 1024))
+                 .arg(sample.writtenBytes / (1024 * 1024))
+                 .arg(probes).toUtf8().constData());
+}
+
+void ResourceSampler::readSmapsRollup(Sample& sample)
+{
+    // Available since Linux 4.14. VmRSS from status is kept when it is missing
+    char buffer[PROC_BUFFER_SIZE];
+    if (!readProcFile("/proc/self/smaps_rollup", buffer, sizeof(buffer)))
+    {
+        return;
+    }
+
+    long long rss = parseField(buffer, "Rss:");
+    long long pss = parseField(buffer, "Pss:");
+    long long swap = parseField(buffer, "Swap:");
+    if (rss >= 0)
+    {
+        sample.rss = rss * 1024;
+    }
+    if (pss >= 0)
+    {
+        sample.pss = pss * 1024;
+    }
+    if (swap >= 0)
+    {
+        sample.swap = swap * 1024;
+    }
+}
+
+void ResourceSampler::readStatus(Sample& sample)
+{
+    char buffer[PROC_BUFFER_SIZE];
+    if (!readProcFile("/proc/self/status", buffer, sizeof(buffer)))
+    {
+        return;
+    }
+
+    long long rss = parseField(buffer, "VmRSS:");
+    long long swap = parseField(buffer, "VmSwap:");
+    long long threads = parseField(buffer, "Threads:");
+    sample.rss = rss > 0 ? rss * 1024 : 0;
+    sample.swap = swap > 0 ? swap * 1024 : 0;
+    sample.threads = threads > 0 ? static_cast<int>(threads) : 0;
+}
+
+void ResourceSampler::readIo(Sample& sample)
+{
+    char buffer[PROC_BUFFER_SIZE];
+    if (!readProcFile("/proc/self/io", buffer, sizeof(buffer)))
+    {
+        return;
+    }
+
+    sample.readBytes = std::max(0LL, parseField(buffer, "rchar:"));
+    sample.writtenBytes = std::max(0LL, parseField(buffer, "wchar:"));
+    sample.storageReadBytes = std::max(0LL, parseField(buffer, "read_bytes:"));
+    sample.storageWrittenBytes = std::max(0LL, parseField(buffer, "write_bytes:"));
+}
+
+int ResourceSampler::countOpenFds()
+{
+    DIR* dir = opendir("/proc/self/fd");
+    if (!dir)
+    {
+        return 0;
+    }
+
+    int count = 0;
+    while (struct dirent* entry = readdir(dir))
+    {
+        if (entry->d_name[0] != '.')
+        {
+            ++count;
+        }
+    }
+    closedir(dir);
+
+    // Do not count the descriptor used to read the folder
+    return count > 0 ? count - 1 : 0;
+}
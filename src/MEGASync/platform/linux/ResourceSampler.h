@@ -0,0 +1,73 @@
+#ifndef RESOURCESAMPLER_H
+#define RESOURCESAMPLER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+#include <QVector>
+
+#include <array>
+#include <functional>
+
+// Periodically samples the process resources from /proc/self (smaps_rollup, status, io and fd)
+// and keeps the last samples in a fixed-size ring. Probes registered with addProbe attribute
+// usage to in-app structures (transfer rows, alerts, pending log buffer...) and are recorded
+// together with each sample.
+class ResourceSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_PROBES = 8;
+    static constexpr int RING_SIZE = 120;
+    static constexpr int DEFAULT_INTERVAL_MS = 30000;
+
+    struct Sample
+    {
+        qint64 timestamp = 0;        // ms since epoch
+        long long rss = 0;           // bytes
+        long long pss = 0;           // bytes, 0 if smaps_rollup is not available
+        long long swap = 0;          // bytes
+        int threads = 0;
+        int openFds = 0;
+        long long readBytes = 0;     // rchar
+        long long writtenBytes = 0;  // wchar
+        long long storageReadBytes = 0;
+        long long storageWrittenBytes = 0;
+        std::array<long long, MAX_PROBES> probes {};
+    };
+
+    explicit ResourceSampler(QObject* parent = nullptr);
+
+    // Probes are called from the thread owning the sampler (the GUI thread)
+    bool addProbe(const QString& name, std::function<long long()> probe);
+
+    void start(int intervalMs = DEFAULT_INTERVAL_MS);
+    void stop();
+
+    const Sample& takeSample();
+    bool getLatestSample(Sample& sample) const;
+    // RSS increase between the oldest and the newest sample in the ring
+    long long getRssGrowth() const;
+
+private slots:
+    void onSampleTimeout();
+
+private:
+    void logSample(const Sample& sample) const;
+
+    static void readSmapsRollup(Sample& sample);
+    static void readStatus(Sample& sample);
+    static void readIo(Sample& sample);
+    static int countOpenFds();
+
+    QTimer mTimer;
+    std::array<Sample, RING_SIZE> mRing;
+    int mNext;
+    int mCount;
+    QVector<QString> mProbeNames;
+    QVector<std::function<long long()>> mProbes;
+    bool mGrowthReported;
+};
+
+#endif // RESOURCESAMPLER_H
@@ -217,6 +217,11 @@ void MacXPlatform::notifyAllSyncFoldersRemoved()
     }
 }
 
+void MacXPlatform::notifyLanguageChange(QString /*languageCode*/)
+{
+
+}
+
 QByteArray MacXPlatform::encrypt(QByteArray data, QByteArray key)
 {
     return data;
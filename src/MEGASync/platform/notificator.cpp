@@ -52,6 +52,7 @@ Notificator::Notificator(const QString &programName, QSystemTrayIcon *trayicon,
     trayIcon(trayicon)
 #ifdef USE_DBUS
     ,interface(0)
+    ,dbusPendingReplies(0)
 #endif
 {
 #ifndef Q_OS_MAC
@@ -70,6 +71,14 @@ Notificator::Notificator(const QString &programName, QSystemTrayIcon *trayicon,
         if (!getenv("XDG_CURRENT_DESKTOP") || strcmp(getenv("XDG_CURRENT_DESKTOP"), "Unity") ) //unity shows notification with actions as a popup
         {
             dbussSupportsActions = true;
+
+            // The server signals are received once, and routed to their notification by id
+            QDBusConnection::sessionBus().connect(QString::fromUtf8("org.freedesktop.Notifications"), QString::fromUtf8("/org/freedesktop/Notifications"),
+                                                  QString::fromUtf8("org.freedesktop.Notifications"), QString::fromUtf8("ActionInvoked"),
+                                                  this, SLOT(onDBusActionInvoked(uint, QString)));
+            QDBusConnection::sessionBus().connect(QString::fromUtf8("org.freedesktop.Notifications"), QString::fromUtf8("/org/freedesktop/Notifications"),
+                                                  QString::fromUtf8("org.freedesktop.Notifications"), QString::fromUtf8("NotificationClosed"),
+                                                  this, SLOT(onDBusNotificationClosed(uint, uint)));
         }
         else
         {
@@ -190,7 +199,7 @@ QVariant FreedesktopImage::toVariant(const QImage &img)
     return QVariant(FreedesktopImage::metaType(), &fimg);
 }
 
-void Notificator::notifyDBus(Class cls, const QString &title, const QString &text, const QIcon &icon, int millisTimeout, QStringList actions, MegaNotification *notification)
+void Notificator::notifyDBus(Class cls, const QString &title, const QString &text, const QIcon &icon, int millisTimeout, QStringList actions, MegaNotification *notification, uint replacesId)
 {
     Q_UNUSED(cls);
     // Arguments for DBus call:
@@ -199,8 +208,8 @@ void Notificator::notifyDBus(Class cls, const QString &title, const QString &tex
     // Program Name:
     args.append(programName);
 
-    // Unique ID of this notification type:
-    args.append(0U);
+    // Id of the notification replaced by this one, 0 for a new one:
+    args.append(replacesId);
 
     // Application Icon, empty string
     args.append(QString());
@@ -251,11 +260,17 @@ void Notificator::notifyDBus(Class cls, const QString &title, const QString &tex
     // Timeout (in msec)
     args.append(millisTimeout);
 
-    if(dbussSupportsActions)
+    if(dbussSupportsActions && notification)
     {
         // fire with callback to gather ID
-        interface->callWithCallback(QString::fromUtf8("Notify"), args, notification,
-                                    SLOT(dBusNotificationSentCallback(QDBusMessage)), SLOT(dbusNotificationSentErrorCallback()));
+        QPointer<MegaNotification> sentNotification(notification);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(interface->asyncCallWithArgumentList(QString::fromUtf8("Notify"), args), this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, sentNotification](QDBusPendingCallWatcher *call)
+        {
+            onDBusNotificationSent(sentNotification, *call);
+            call->deleteLater();
+        });
+        dbusPendingReplies++;
     }
     else
     {
@@ -457,17 +472,17 @@ void Notificator::notify(MegaNotification *notification)
 #ifdef USE_DBUS
     if (mode == Freedesktop && dbussSupportsActions)
     {
-        QStringList actions;
-        for (auto a : notification->getActions())
+        dbusQueue.append(notification);
+        if (dbusQueue.size() > MAX_DBUS_NOTIFICATIONS)
         {
-            //Dbus likes pairs (Text and argument for the callback)
-            actions.append(a);
-            actions.append(a);
+            // A burst of notifications: the oldest waiting ones would only be replaced right after being shown
+            QPointer<MegaNotification> superseded = dbusQueue.takeFirst();
+            if (superseded)
+            {
+                emit superseded->closed(MegaNotification::CloseReason::AppHidden);
+            }
         }
-        QDBusConnection::sessionBus().connect(QString::fromUtf8("org.freedesktop.Notifications"),QString::fromUtf8("/org/freedesktop/Notifications"),
-                                              QString::fromUtf8("org.freedesktop.Notifications"),QString::fromUtf8(""), notification, SLOT(dBusNotificationCallback(QDBusMessage)));
-        notifyDBus((Class)notification->getType(), notification->getTitle(), notification->getText(),
-                   notification->getImage(), notification->getExpirationTime(), actions, notification);
+        dispatchDBusQueue();
     }
     else
 #endif
@@ -544,62 +559,130 @@ void MegaNotification::emitLegacyNotificationActivated()
 }
 
 #ifdef USE_DBUS
-void MegaNotification::dBusNotificationSentCallback(QDBusMessage dbusMssage)
+void Notificator::dispatchDBusQueue()
 {
-    if (dbusMssage.arguments().size())
+    while (!dbusQueue.isEmpty())
     {
-        dbusId = dbusMssage.arguments().at(0).toInt();
-        MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Notification sent to DBUS. Id = %1").arg(dbusId).toUtf8().constData());
+        uint replacesId = 0;
+        if (dbusNotifications.size() + dbusPendingReplies >= MAX_DBUS_NOTIFICATIONS)
+        {
+            if (dbusNotificationOrder.isEmpty())
+            {
+                // Every slot is waiting for the server to answer
+                return;
+            }
+
+            replacesId = dbusNotificationOrder.first();
+            MegaNotification *replaced = takeDBusNotification(replacesId);
+            if (replaced)
+            {
+                emit replaced->closed(MegaNotification::CloseReason::AppHidden);
+            }
+        }
+
+        QPointer<MegaNotification> notification = dbusQueue.takeFirst();
+        if (!notification)
+        {
+            continue;
+        }
+
+        QStringList actions;
+        for (auto a : notification->getActions())
+        {
+            //Dbus likes pairs (Text and argument for the callback)
+            actions.append(a);
+            actions.append(a);
+        }
+        notifyDBus((Class)notification->getType(), notification->getTitle(), notification->getText(),
+                   notification->getImage(), notification->getExpirationTime(), actions, notification, replacesId);
     }
-    else
+}
+
+void Notificator::onDBusNotificationSent(QPointer<MegaNotification> notification, const QDBusPendingCall &call)
+{
+    dbusPendingReplies--;
+
+    QDBusPendingReply<uint> reply(call);
+    if (reply.isError())
     {
-        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Notification sent to DBUS: missing id").arg(dbusId).toUtf8().constData());
-        assert(false && "QDBusMessage missing id");
+        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Notification to DBUS failed: %1").arg(reply.error().message()).toUtf8().constData());
+        if (notification)
+        {
+            notification->deleteLater();
+        }
+    }
+    else if (notification)
+    {
+        uint dbusId = reply.value();
+        MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Notification sent to DBUS. Id = %1").arg(dbusId).toUtf8().constData());
+
+        dbusNotifications.insert(dbusId, notification);
+        dbusNotificationOrder.removeOne(dbusId);
+        dbusNotificationOrder.append(dbusId);
+        connect(notification, &QObject::destroyed, this, [this, dbusId](QObject *object)
+        {
+            // The id may have been reused by a newer notification since
+            if (dbusNotifications.value(dbusId) == object)
+            {
+                takeDBusNotification(dbusId);
+            }
+        });
     }
+
+    dispatchDBusQueue();
 }
 
-void MegaNotification::dbusNotificationSentErrorCallback()
+MegaNotification *Notificator::takeDBusNotification(uint dbusId)
 {
-    MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Notification to DBUS failed").toUtf8().constData());
-    deleteLater();
+    dbusNotificationOrder.removeOne(dbusId);
+    return dbusNotifications.take(dbusId);
 }
 
-void MegaNotification::dBusNotificationCallback(QDBusMessage dbusMssage)
+void Notificator::onDBusActionInvoked(uint dbusId, QString actionKey)
 {
-    if (dbusMssage.arguments().size() && dbusId != dbusMssage.arguments().at(0).toInt() )
+    MegaNotification *notification = dbusNotifications.value(dbusId);
+    if (!notification)
     {
-        MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Received notification corresponding to another notification. current = %1. Received = %1").arg(dbusId).arg(dbusMssage.member()).toUtf8().constData());
         return;
     }
-    else if (!dbusMssage.arguments().size())
+
+    const auto actionIndex = notification->getActions().indexOf(actionKey);
+    if (actionIndex == 0)
+    {
+        emit notification->activated(MegaNotification::Action::firstButton);
+    }
+    else if (actionIndex == 1)
     {
-        assert(false && "QDBusMessage missing id");
+        emit notification->activated(MegaNotification::Action::secondButton);
     }
+}
 
-    if (dbusMssage.member() == QString::fromUtf8("ActionInvoked"))
+void Notificator::onDBusNotificationClosed(uint dbusId, uint reason)
+{
+    MegaNotification *notification = takeDBusNotification(dbusId);
+    if (!notification)
     {
-        if(dbusMssage.arguments().size() > 1)
-        {
-            const QString actionText{dbusMssage.arguments().at(1).toString()};
-            const auto actionIndex = getActions().indexOf(actionText);
-            if(actionIndex == 0)
-            {
-                emit activated(Action::firstButton);
-            }
-            else if(actionIndex == 1)
-            {
-                emit activated(Action::secondButton);
-            }
-        }
-        else
-        {
-            emit activated(Action::firstButton);
-        }
+        return;
     }
-    else if (dbusMssage.member() == QString::fromUtf8("NotificationClosed"))
+
+    // Reasons defined by the Desktop Notifications Specification
+    MegaNotification::CloseReason closeReason = MegaNotification::CloseReason::Unknown;
+    switch (reason)
     {
-        emit closed(CloseReason::Unknown);
+        case 1:
+            closeReason = MegaNotification::CloseReason::TimedOut;
+            break;
+        case 2:
+            closeReason = MegaNotification::CloseReason::UserAction;
+            break;
+        case 3:
+            closeReason = MegaNotification::CloseReason::AppHidden;
+            break;
+        default:
+            break;
     }
+    emit notification->closed(closeReason);
+    dispatchDBusQueue();
 }
 #endif
 
@@ -613,9 +696,6 @@ MegaNotification::MegaNotification()
     style = -1;
     type = Notificator::Information;
     id = -1;
-#if USE_DBUS
-    dbusId = -1;
-#endif
 
     connect(this, &MegaNotification::activated, this, &MegaNotification::deleteLater, Qt::QueuedConnection);
     connect(this, &MegaNotification::closed, this, &MegaNotification::deleteLater, Qt::QueuedConnection);
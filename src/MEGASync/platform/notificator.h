@@ -15,7 +15,7 @@ QT_BEGIN_NAMESPACE
 class QSystemTrayIcon;
 
 #ifdef USE_DBUS
-#include <QDBusMessage>
+#include <QDBusPendingCall>
 class QDBusInterface;
 #endif
 QT_END_NAMESPACE
@@ -80,20 +80,10 @@ protected:
     int64_t id;
     QString data;
 
-#ifdef USE_DBUS
-    int dbusId;
-#endif
 signals:
     void activated(Action action);
     void closed(CloseReason reason);
     void failed();
-
-#ifdef USE_DBUS
-public slots:
-    void dBusNotificationSentCallback(QDBusMessage dbusMssage);
-    void dbusNotificationSentErrorCallback();
-    void dBusNotificationCallback(QDBusMessage dbusMssage);
-#endif
 };
 
 #ifdef _WIN32
@@ -168,10 +158,24 @@ private:
     MegaNotification* currentNotification;
 
 #ifdef USE_DBUS
+    // Notifications with actions shown at the same time. Beyond that, the oldest one is replaced
+    static const int MAX_DBUS_NOTIFICATIONS = 8;
+
     QDBusInterface *interface;
     bool dbussSupportsActions;
 
-    void notifyDBus(Class cls, const QString &title, const QString &text, const QIcon &icon, int millisTimeout, QStringList actions = QStringList(), MegaNotification *notification = NULL);
+    // Notifications shown by the server, by id, and their ids in the order they were shown.
+    // A single subscription to the server signals routes them to their notification
+    QHash<uint, MegaNotification *> dbusNotifications;
+    QList<uint> dbusNotificationOrder;
+    // Notifications waiting for a free slot, and Notify calls not answered yet
+    QList<QPointer<MegaNotification>> dbusQueue;
+    int dbusPendingReplies;
+
+    void notifyDBus(Class cls, const QString &title, const QString &text, const QIcon &icon, int millisTimeout, QStringList actions = QStringList(), MegaNotification *notification = NULL, uint replacesId = 0);
+    void dispatchDBusQueue();
+    void onDBusNotificationSent(QPointer<MegaNotification> notification, const QDBusPendingCall &call);
+    MegaNotification *takeDBusNotification(uint dbusId);
 #endif
     void notifySystray(Class cls, const QString &title, const QString &text, const QIcon &icon, int millisTimeout, bool forceQt = false);
     void notifySystray(MegaNotification *notification);
@@ -179,6 +183,10 @@ private:
 protected slots:
     void onModernNotificationFailed();
     void onMessageClicked();
+#ifdef USE_DBUS
+    void onDBusActionInvoked(uint dbusId, QString actionKey);
+    void onDBusNotificationClosed(uint dbusId, uint reason);
+#endif
 };
 
 #endif // NOTIFICATOR_H
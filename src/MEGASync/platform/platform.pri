@@ -48,11 +48,13 @@ unix:!macx {
     SOURCES += $$PWD/linux/LinuxPlatform.cpp \
         $$PWD/linux/ExtServer.cpp \
         $$PWD/linux/NotifyServer.cpp \
+        $$PWD/linux/ResourceSampler.cpp \
         $$PWD/linux/PowerOptions.cpp \
         $$PWD/linux/PlatformStrings.cpp
     HEADERS += $$PWD/linux/LinuxPlatform.h \
         $$PWD/linux/ExtServer.h \
-        $$PWD/linux/NotifyServer.h
+        $$PWD/linux/NotifyServer.h \
+        $$PWD/linux/ResourceSampler.h
 
     LIBS += -lssl -lcrypto -ldl -lxcb
     DEFINES += USE_DBUS
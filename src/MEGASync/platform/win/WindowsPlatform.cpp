@@ -890,6 +890,11 @@ void WindowsPlatform::notifyAllSyncFoldersRemoved()
 
 }
 
+void WindowsPlatform::notifyLanguageChange(QString /*languageCode*/)
+{
+
+}
+
 QByteArray WindowsPlatform::encrypt(QByteArray data, QByteArray key)
 {
     DATA_BLOB dataIn;
@@ -0,0 +1,141 @@
+#include "LocalFolderTrie.h"
+
+#include <QDir>
+
+#include <vector>
+
+void LocalFolderTrie::insert(const QString& path, mega::MegaHandle backupId, mega::MegaSync::SyncType type)
+{
+    std::vector<Node*> walked;
+    Node* node = &mRoot;
+    for (const auto& component : split(path))
+    {
+        walked.push_back(node);
+        auto& child = node->children[component];
+        if (!child)
+        {
+            child.reset(new Node());
+        }
+        node = child.get();
+    }
+
+    if (!node->syncs.contains(backupId))
+    {
+        for (auto parent : walked)
+        {
+            parent->syncsBelow++;
+        }
+    }
+    node->syncs.insert(backupId, type);
+}
+
+void LocalFolderTrie::remove(const QString& path, mega::MegaHandle backupId)
+{
+    std::vector<std::pair<Node*, QString>> walked;
+    Node* node = &mRoot;
+    for (const auto& component : split(path))
+    {
+        auto it = node->children.find(component);
+        if (it == node->children.end())
+        {
+            return;
+        }
+        walked.emplace_back(node, component);
+        node = it->second.get();
+    }
+
+    if (!node->syncs.remove(backupId))
+    {
+        return;
+    }
+
+    // Update the counters from the bottom, pruning the nodes left empty
+    bool prune = node->syncs.isEmpty() && node->children.empty();
+    for (auto it = walked.rbegin(); it != walked.rend(); ++it)
+    {
+        Node* parent = it->first;
+        parent->syncsBelow--;
+        if (prune)
+        {
+            parent->children.erase(it->second);
+            prune = parent->syncs.isEmpty() && parent->children.empty();
+        }
+    }
+}
+
+void LocalFolderTrie::clear()
+{
+    mRoot.children.clear();
+    mRoot.syncs.clear();
+    mRoot.syncsBelow = 0;
+}
+
+LocalFolderTrie::Relation LocalFolderTrie::find(const QString& path, mega::MegaSync::SyncType* type) const
+{
+    const Node* insideOf = nullptr;
+    const Node* node = &mRoot;
+    for (const auto& component : split(path))
+    {
+        if (!node->syncs.isEmpty())
+        {
+            insideOf = node;
+        }
+
+        auto it = node->children.find(component);
+        if (it == node->children.end())
+        {
+            node = nullptr;
+            break;
+        }
+        node = it->second.get();
+    }
+
+    if (node && !node->syncs.isEmpty())
+    {
+        if (type)
+        {
+            *type = node->syncs.first();
+        }
+        return SAME;
+    }
+
+    if (insideOf)
+    {
+        if (type)
+        {
+            *type = insideOf->syncs.first();
+        }
+        return INSIDE;
+    }
+
+    if (node && node->syncsBelow && findBelow(*node, type))
+    {
+        return CONTAINS;
+    }
+    return NONE;
+}
+
+QStringList LocalFolderTrie::split(const QString& path)
+{
+    return QDir::toNativeSeparators(path).split(QDir::separator(), QString::SkipEmptyParts);
+}
+
+bool LocalFolderTrie::findBelow(const Node& node, mega::MegaSync::SyncType* type)
+{
+    for (const auto& child : node.children)
+    {
+        if (!child.second->syncs.isEmpty())
+        {
+            if (type)
+            {
+                *type = child.second->syncs.first();
+            }
+            return true;
+        }
+        if (child.second->syncsBelow && findBelow(*child.second, type))
+        {
+            return true;
+        }
+    }
+    return false;
+}
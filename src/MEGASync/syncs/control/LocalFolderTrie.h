@@ -0,0 +1,51 @@
+#pragma once
+
+#include "megaapi.h"
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include <map>
+#include <memory>
+
+/**
+ * @brief Trie of the local folders of the syncs, by path component
+ *
+ * Tells in a single walk down the path whether a folder is synced, is inside a synced folder
+ * or contains synced folders, instead of comparing its path with every sync.
+ * Paths are compared component by component, so trailing separators do not matter.
+ */
+class LocalFolderTrie
+{
+public:
+    enum Relation
+    {
+        NONE = 0,
+        SAME,     // The path is a synced folder
+        INSIDE,   // The path is inside a synced folder
+        CONTAINS  // The path contains synced folders
+    };
+
+    void insert(const QString& path, mega::MegaHandle backupId, mega::MegaSync::SyncType type);
+    void remove(const QString& path, mega::MegaHandle backupId);
+    void clear();
+
+    // type is set to the type of the sync the path is related to
+    Relation find(const QString& path, mega::MegaSync::SyncType* type = nullptr) const;
+
+private:
+    struct Node
+    {
+        std::map<QString, std::unique_ptr<Node>> children;
+        // Syncs of this folder, by backup id
+        QMap<mega::MegaHandle, mega::MegaSync::SyncType> syncs;
+        // Syncs of the folders below this one
+        int syncsBelow = 0;
+    };
+
+    static QStringList split(const QString& path);
+    static bool findBelow(const Node& node, mega::MegaSync::SyncType* type);
+
+    Node mRoot;
+};
@@ -154,59 +154,60 @@ QString SyncController::getIsLocalFolderAlreadySyncedMsg(const QString& path, co
     QString inputPath (QDir::toNativeSeparators(QDir(path).absolutePath()));
     QString message;
 
-    // Gather all synced or backed-up dirs
-    QMap<QString, MegaSync::SyncType> localFolders = SyncInfo::instance()->getLocalFoldersAndTypeMap();
-
     // Check if the path is already synced or part of a sync
-    foreach (auto& existingPath, localFolders.keys())
+    MegaSync::SyncType existingType (MegaSync::SyncType::TYPE_TWOWAY);
+    switch (SyncInfo::instance()->getLocalFolderRelation(inputPath, &existingType))
     {
-        if (inputPath == existingPath)
+        case LocalFolderTrie::SAME:
         {
             if (syncType == MegaSync::SyncType::TYPE_BACKUP)
             {
-                message = localFolders.value(existingPath) == MegaSync::SyncType::TYPE_TWOWAY ?
+                message = existingType == MegaSync::SyncType::TYPE_TWOWAY ?
                             tr("You can't backup this folder as it's already synced.")
                           : tr("Folder is already backed up. Select a different one.");
             }
             else
             {
-                message = localFolders.value(existingPath) == MegaSync::SyncType::TYPE_TWOWAY ?
+                message = existingType == MegaSync::SyncType::TYPE_TWOWAY ?
                             tr("You can't sync this folder as it's already synced.")
                           : tr("You can't sync this folder as it's already backed up.");
             }
+            break;
         }
-        else if (inputPath.startsWith(existingPath)
-                 && inputPath[existingPath.size() - QDir(existingPath).isRoot()] == QDir::separator())
+        case LocalFolderTrie::INSIDE:
         {
             if (syncType == MegaSync::SyncType::TYPE_BACKUP)
             {
-                message = localFolders.value(existingPath) == MegaSync::SyncType::TYPE_TWOWAY ?
+                message = existingType == MegaSync::SyncType::TYPE_TWOWAY ?
                             tr("You can't backup this folder as it's already inside a synced folder.")
                           : getErrStrCurrentBackupInsideExistingBackup();
             }
             else
             {
-                message = localFolders.value(existingPath) == MegaSync::SyncType::TYPE_TWOWAY ?
+                message = existingType == MegaSync::SyncType::TYPE_TWOWAY ?
                             tr("You can't sync folders that are inside synced folders.")
                           : tr("You can't sync folders that are inside backed up folders.");
             }
+            break;
         }
-        else if (existingPath.startsWith(inputPath)
-                 && existingPath[inputPath.size() - QDir(inputPath).isRoot()] == QDir::separator())
+        case LocalFolderTrie::CONTAINS:
         {
             if (syncType == MegaSync::SyncType::TYPE_BACKUP)
             {
-                message = localFolders.value(existingPath) == MegaSync::SyncType::TYPE_TWOWAY ?
+                message = existingType == MegaSync::SyncType::TYPE_TWOWAY ?
                             tr("You can't backup this folder as it contains synced folders.")
                           : getErrStrCurrentBackupOverExistingBackup();
             }
             else
             {
-                message = localFolders.value(existingPath) == MegaSync::SyncType::TYPE_TWOWAY ?
+                message = existingType == MegaSync::SyncType::TYPE_TWOWAY ?
                             tr("You can't sync folders that contain synced folders.")
                           : tr("You can't sync folders that contain backed up folders.");
             }
+            break;
         }
+        case LocalFolderTrie::NONE:
+            break;
     }
     return message;
 }
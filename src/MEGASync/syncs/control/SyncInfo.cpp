@@ -34,8 +34,13 @@ SyncInfo::SyncInfo() : QObject(),
     preferences (Preferences::instance()),
     mIsFirstTwoWaySyncDone (preferences->isFirstSyncDone()),
     mIsFirstBackupDone (preferences->isFirstBackupDone()),
-    syncMutex (QMutex::Recursive)
+    syncMutex (QMutex::Recursive),
+    mRemoteDeviceHandle (INVALID_HANDLE),
+    mRemoteBackupNamesValid (false),
+    mRemoteBackupNamesGeneration (0)
 {
+    connect(this, &SyncInfo::syncStateChanged, this, &SyncInfo::onSyncStateChanged, Qt::DirectConnection);
+    connect(this, &SyncInfo::syncRemoved, this, &SyncInfo::onSyncRemoved, Qt::DirectConnection);
 }
 
 bool SyncInfo::hasUnattendedDisabledSyncs(const QVector<SyncType>& types) const
@@ -107,6 +112,7 @@ void SyncInfo::removeAllFolders()
     configuredSyncsMap.clear();
     syncsSettingPickedFromOldConfig.clear();
     unattendedDisabledSyncs.clear();
+    clearIndexes();
 }
 
 void SyncInfo::activateSync(std::shared_ptr<SyncSettings> syncSetting)
@@ -341,6 +347,7 @@ void SyncInfo::reset()
     configuredSyncsMap.clear();
     syncsSettingPickedFromOldConfig.clear();
     unattendedDisabledSyncs.clear();
+    clearIndexes();
     mIsFirstTwoWaySyncDone = false;
     mIsFirstBackupDone = false;
 }
@@ -404,29 +411,22 @@ QStringList SyncInfo::getCloudDriveSyncMegaFolders(bool cloudDrive)
 {
     QMutexLocker qm(&syncMutex);
     QStringList value;
-    mega::MegaApi* megaApi = MegaSyncApp->getMegaApi();
 
     for (auto type : AllHandledSyncTypes)
     {
         for (auto &cs : configuredSyncs[type])
         {
-            QString megaFolder = configuredSyncsMap[cs]->getMegaFolder();
-            auto parent_node = std::unique_ptr<MegaNode>(megaApi->getNodeByPath(megaFolder.toStdString().data()));
-
-            while(parent_node && parent_node->getParentHandle() != INVALID_HANDLE)
-            {
-                parent_node = std::unique_ptr<MegaNode>(megaApi->getNodeByHandle(parent_node->getParentHandle()));
-            }
-
-            if(!parent_node)
+            auto indexedSync = mIndexedSyncs.find(cs);
+            if (indexedSync == mIndexedSyncs.end())
             {
                 continue;
             }
 
-            if((parent_node->isInShare() && !cloudDrive)
-                    || (megaApi->getRootNode()->getHandle() == parent_node->getHandle() && cloudDrive))
+            MegaFolderRoot root = getMegaFolderRoot(indexedSync.value());
+            if ((root == MegaFolderRoot::INSHARE && !cloudDrive)
+                    || (root == MegaFolderRoot::CLOUD_DRIVE && cloudDrive))
             {
-                value.append(megaFolder.append(QLatin1Char('/')));
+                value.append(indexedSync->megaFolder + QLatin1Char('/'));
             }
         }
     }
@@ -435,6 +435,17 @@ QStringList SyncInfo::getCloudDriveSyncMegaFolders(bool cloudDrive)
 
 QSet<QString> SyncInfo::getRemoteBackupFolderNames()
 {
+    unsigned int generation (0);
+    {
+        QMutexLocker qm(&syncMutex);
+        if (mRemoteBackupNamesValid)
+        {
+            return mRemoteBackupNames;
+        }
+        generation = mRemoteBackupNamesGeneration;
+    }
+
+    // The lookups may block on the SDK, so they are done without holding the lock
     auto myBackupsHandle = UserAttributes::MyBackupsHandle::requestMyBackupsHandle();
     QSet<QString> backupsNames;
 
@@ -460,16 +471,50 @@ QSet<QString> SyncInfo::getRemoteBackupFolderNames()
 
         if (deviceNode)
         {
+            QSet<MegaHandle> backupsHandles;
             std::unique_ptr<MegaNodeList> folders (api->getChildren(deviceNode));
             for (int j = 0; folders && j < folders->size(); j++)
             {
                 backupsNames.insert(QString::fromUtf8(folders->get(j)->getName()));
+                backupsHandles.insert(folders->get(j)->getHandle());
+            }
+
+            // Until the device folder exists there is nothing to keep
+            QMutexLocker qm(&syncMutex);
+            if (generation == mRemoteBackupNamesGeneration)
+            {
+                mRemoteBackupNames = backupsNames;
+                mRemoteBackupHandles = backupsHandles;
+                mRemoteDeviceHandle = deviceNode->getHandle();
+                mRemoteBackupNamesValid = true;
             }
         }
     }
     return backupsNames;
 }
 
+void SyncInfo::onNodesUpdate(MegaNodeList* nodes)
+{
+    QMutexLocker qm(&syncMutex);
+    if (!mRemoteBackupNamesValid || !nodes)
+    {
+        return;
+    }
+
+    // Covers the folders added to, renamed in, moved out of or removed from the device folder
+    for (int i = 0; i < nodes->size(); i++)
+    {
+        MegaNode* node (nodes->get(i));
+        if (node->getHandle() == mRemoteDeviceHandle
+                || node->getParentHandle() == mRemoteDeviceHandle
+                || mRemoteBackupHandles.contains(node->getHandle()))
+        {
+            invalidateRemoteBackupNames();
+            return;
+        }
+    }
+}
+
 QStringList SyncInfo::getMegaFolders(const QVector<SyncType>& types)
 {
     QMutexLocker qm(&syncMutex);
@@ -514,6 +559,18 @@ QMap<QString, SyncInfo::SyncType> SyncInfo::getLocalFoldersAndTypeMap()
     return ret;
 }
 
+LocalFolderTrie::Relation SyncInfo::getLocalFolderRelation(const QString& path, SyncType* type)
+{
+    QMutexLocker qm(&syncMutex);
+    return mLocalFolderTrie.find(path, type);
+}
+
+bool SyncInfo::isMegaFolderSynced(MegaHandle handle)
+{
+    QMutexLocker qm(&syncMutex);
+    return mMegaFolderHandles.contains(handle);
+}
+
 QList<MegaHandle> SyncInfo::getMegaFolderHandles(const QVector<SyncType>& types)
 {
     QMutexLocker qm(&syncMutex);
@@ -607,3 +664,125 @@ void SyncInfo::dismissUnattendedDisabledSyncs(const QVector<SyncType>& types)
     saveUnattendedDisabledSyncs();
     emit syncDisabledListUpdated();
 }
+
+void SyncInfo::onSyncStateChanged(std::shared_ptr<SyncSettings> syncSettings)
+{
+    QMutexLocker qm(&syncMutex);
+    const MegaHandle backupId (syncSettings->backupId());
+    if (!configuredSyncsMap.contains(backupId))
+    {
+        return;
+    }
+
+    auto indexedSync = mIndexedSyncs.find(backupId);
+    if (indexedSync == mIndexedSyncs.end())
+    {
+        IndexedSync newSync;
+        newSync.megaHandle = INVALID_HANDLE;
+        newSync.megaFolderRoot = MegaFolderRoot::UNKNOWN;
+        indexedSync = mIndexedSyncs.insert(backupId, newSync);
+    }
+    else
+    {
+        mLocalFolderTrie.remove(indexedSync->localFolder, backupId);
+    }
+
+    indexedSync->localFolder = syncSettings->getLocalFolder();
+    indexedSync->type = syncSettings->getType();
+    mLocalFolderTrie.insert(indexedSync->localFolder, backupId, indexedSync->type);
+
+    if (indexedSync->megaHandle != syncSettings->getMegaHandle()
+            || indexedSync->megaFolder != syncSettings->getMegaFolder())
+    {
+        indexedSync->megaHandle = syncSettings->getMegaHandle();
+        indexedSync->megaFolder = syncSettings->getMegaFolder();
+        indexedSync->megaFolderRoot = MegaFolderRoot::UNKNOWN;
+        updateMegaFolderHandles();
+    }
+
+    if (indexedSync->type == SyncType::TYPE_BACKUP)
+    {
+        invalidateRemoteBackupNames();
+    }
+}
+
+void SyncInfo::onSyncRemoved(std::shared_ptr<SyncSettings> syncSettings)
+{
+    QMutexLocker qm(&syncMutex);
+    const MegaHandle backupId (syncSettings->backupId());
+    auto indexedSync = mIndexedSyncs.find(backupId);
+    if (indexedSync == mIndexedSyncs.end())
+    {
+        return;
+    }
+
+    mLocalFolderTrie.remove(indexedSync->localFolder, backupId);
+    if (indexedSync->type == SyncType::TYPE_BACKUP)
+    {
+        invalidateRemoteBackupNames();
+    }
+    mIndexedSyncs.erase(indexedSync);
+    updateMegaFolderHandles();
+}
+
+void SyncInfo::clearIndexes()
+{
+    mIndexedSyncs.clear();
+    mLocalFolderTrie.clear();
+    mMegaFolderHandles.clear();
+    invalidateRemoteBackupNames();
+}
+
+void SyncInfo::invalidateRemoteBackupNames()
+{
+    mRemoteBackupNames.clear();
+    mRemoteBackupHandles.clear();
+    mRemoteDeviceHandle = INVALID_HANDLE;
+    mRemoteBackupNamesValid = false;
+    mRemoteBackupNamesGeneration++;
+}
+
+void SyncInfo::updateMegaFolderHandles()
+{
+    mMegaFolderHandles.clear();
+    for (const auto& indexedSync : mIndexedSyncs)
+    {
+        mMegaFolderHandles.insert(indexedSync.megaHandle);
+    }
+}
+
+SyncInfo::MegaFolderRoot SyncInfo::getMegaFolderRoot(IndexedSync& indexedSync)
+{
+    if (indexedSync.megaFolderRoot != MegaFolderRoot::UNKNOWN)
+    {
+        return indexedSync.megaFolderRoot;
+    }
+
+    mega::MegaApi* megaApi = MegaSyncApp->getMegaApi();
+    auto parent_node = std::unique_ptr<MegaNode>(megaApi->getNodeByPath(indexedSync.megaFolder.toStdString().data()));
+    while(parent_node && parent_node->getParentHandle() != INVALID_HANDLE)
+    {
+        parent_node = std::unique_ptr<MegaNode>(megaApi->getNodeByHandle(parent_node->getParentHandle()));
+    }
+
+    // Not known yet (e.g. the nodes are still being fetched), it is checked again next time
+    if (!parent_node)
+    {
+        return MegaFolderRoot::UNKNOWN;
+    }
+
+    std::unique_ptr<MegaNode> rootNode (megaApi->getRootNode());
+    if (parent_node->isInShare())
+    {
+        indexedSync.megaFolderRoot = MegaFolderRoot::INSHARE;
+    }
+    else if (rootNode && rootNode->getHandle() == parent_node->getHandle())
+    {
+        indexedSync.megaFolderRoot = MegaFolderRoot::CLOUD_DRIVE;
+    }
+    else
+    {
+        indexedSync.megaFolderRoot = MegaFolderRoot::OTHER;
+    }
+    return indexedSync.megaFolderRoot;
+}
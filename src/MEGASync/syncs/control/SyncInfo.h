@@ -1,6 +1,7 @@
 #pragma once
 
 #include "syncs/control/SyncSettings.h"
+#include "syncs/control/LocalFolderTrie.h"
 
 #include "megaapi.h"
 
@@ -41,6 +42,10 @@ signals:
     void syncRemoved(std::shared_ptr<SyncSettings> syncSettings);
     void syncDisabledListUpdated();
 
+private slots:
+    void onSyncStateChanged(std::shared_ptr<SyncSettings> syncSettings);
+    void onSyncRemoved(std::shared_ptr<SyncSettings> syncSettings);
+
 private:
     static std::unique_ptr<SyncInfo> model;
     SyncInfo();
@@ -51,6 +56,43 @@ private:
 
     void saveUnattendedDisabledSyncs();
 
+    // Where the remote folder of a sync hangs from, resolved the first time it is needed
+    enum class MegaFolderRoot
+    {
+        UNKNOWN = 0,
+        CLOUD_DRIVE,
+        INSHARE,
+        OTHER
+    };
+
+    struct IndexedSync
+    {
+        QString localFolder;
+        SyncType type;
+        mega::MegaHandle megaHandle;
+        QString megaFolder;
+        MegaFolderRoot megaFolderRoot;
+    };
+
+    void clearIndexes();
+    void updateMegaFolderHandles();
+    MegaFolderRoot getMegaFolderRoot(IndexedSync& indexedSync);
+
+    // Indexes derived from the configured syncs, updated on syncStateChanged and syncRemoved
+    QMap<mega::MegaHandle, IndexedSync> mIndexedSyncs;
+    LocalFolderTrie mLocalFolderTrie;
+    QSet<mega::MegaHandle> mMegaFolderHandles;
+    void invalidateRemoteBackupNames();
+
+    // Names of the remote folders of the backups of this device, filled on demand and dropped
+    // when a backup or a node under the device folder changes
+    QSet<QString> mRemoteBackupNames;
+    QSet<mega::MegaHandle> mRemoteBackupHandles;
+    mega::MegaHandle mRemoteDeviceHandle;
+    bool mRemoteBackupNamesValid;
+    // Increased on every invalidation, so names looked up meanwhile are not kept
+    unsigned int mRemoteBackupNamesGeneration;
+
 protected:
     QMutex syncMutex;
 
@@ -128,12 +170,16 @@ public:
     QStringList getLocalFolders(SyncType type)
         {return getLocalFolders(QVector<SyncType>({type}));}
     QMap<QString, SyncType> getLocalFoldersAndTypeMap();
+    // type is set to the type of the sync the path is related to
+    LocalFolderTrie::Relation getLocalFolderRelation(const QString& path, SyncType* type = nullptr);
+    bool isMegaFolderSynced(mega::MegaHandle handle);
     QList<mega::MegaHandle> getMegaFolderHandles(const QVector<SyncType>& types);
     QList<mega::MegaHandle> getMegaFolderHandles(SyncType type)
         {return getMegaFolderHandles(QVector<SyncType>({type}));}
     //cloudDrive = true: only cloud drive mega folders. If false will return only inshare syncs.
     QStringList getCloudDriveSyncMegaFolders(bool cloudDrive = true);
-    static QSet<QString> getRemoteBackupFolderNames();
+    QSet<QString> getRemoteBackupFolderNames();
+    void onNodesUpdate(mega::MegaNodeList* nodes);
 
     void updateMegaFolder(QString newRemotePath, std::shared_ptr<SyncSettings> cs);
 };
@@ -84,7 +84,7 @@ bool BackupNameConflictDialog::backupNamesValid(QStringList candidatePaths)
     }
 
     return areValid && candidatePaths.size() == candidatesNames.size()
-            && !candidatesNames.intersects(SyncInfo::getRemoteBackupFolderNames());
+            && !candidatesNames.intersects(SyncInfo::instance()->getRemoteBackupFolderNames());
 }
 
 bool BackupNameConflictDialog::eventFilter(QObject *obj, QEvent *event)
@@ -110,7 +110,7 @@ void BackupNameConflictDialog::checkChangedNames()
     const auto conflicts = ui->wConflictZone->findChildren<BackupRenameWidget*>();
 
     // Get the remote names
-    QStringList chosenNames (SyncInfo::getRemoteBackupFolderNames().toList());
+    QStringList chosenNames (SyncInfo::instance()->getRemoteBackupFolderNames().toList());
 
     // First pass to get all the new names:
     //   - First replace in candidate nams all the changed names
@@ -147,7 +147,7 @@ void BackupNameConflictDialog::createWidgets()
     QString conflictText;
 
     // Check conflicts and add widgets
-    const auto currentNames = SyncInfo::getRemoteBackupFolderNames();
+    const auto currentNames = SyncInfo::instance()->getRemoteBackupFolderNames();
     for (auto it = mBackupNames.cbegin(); it != mBackupNames.cend(); it++)
     {
         if (currentNames.contains(it.value()))
@@ -100,17 +100,17 @@ void SyncsMenu::refresh()
 
     int activeFolders (0);
 
-    // Get number of <type>. Show only "Add <type>" button if no items, and whole menu otherwise.
-    int numItems = (Preferences::instance()->logged()) ?
-                       model->getNumSyncedFolders(mType)
-                     : 0;
+    // Get the <type> settings at once. Show only "Add <type>" button if no items, and whole menu otherwise.
+    const auto syncSettings = (Preferences::instance()->logged()) ?
+                                  model->getSyncSettingsByType(mType)
+                                : QList<std::shared_ptr<SyncSettings>>();
+    int numItems = syncSettings.size();
     if (numItems > 0)
     {
         int itemIndent (mType == mega::MegaSync::TYPE_BACKUP);
 
-        for (int i = 0; i < numItems; ++i)
+        for (const auto& backupSetting : syncSettings)
         {
-            auto backupSetting = model->getSyncSetting(i, mType);
 
             if (backupSetting->isActive())
             {
@@ -16,6 +16,7 @@ SOURCES += $$PWD/gui/Backups/AddBackupDialog.cpp \
            $$PWD/model/SyncItemModel.cpp \
            $$PWD/control/SyncInfo.cpp \
            $$PWD/control/SyncController.cpp \
+           $$PWD/control/LocalFolderTrie.cpp \
            $$PWD/control/SyncSettings.cpp
 
 HEADERS += $$PWD/gui/Backups/AddBackupDialog.h \
@@ -32,6 +33,7 @@ HEADERS += $$PWD/gui/Backups/AddBackupDialog.h \
            $$PWD/model/BackupItemModel.h \
            $$PWD/model/SyncItemModel.h \
            $$PWD/control/SyncController.h \
+           $$PWD/control/LocalFolderTrie.h \
            $$PWD/control/SyncInfo.h \
            $$PWD/control/SyncSettings.h
 
@@ -83,7 +83,7 @@ void DuplicatedNodeItem::fillUi()
 
     auto nodeName(getNodeName());
 
-    QIcon icon = isFile() ? QIcon(Utilities::getExtensionPixmapName(nodeName, QLatin1Literal(":/images/drag_")))
+    QIcon icon = isFile() ? Utilities::getExtensionPixmapMedium(nodeName)
                                         : QIcon(QLatin1Literal(":/images/icons/folder/medium-folder.png"));
 
     ui->lIcon->setPixmap(icon.pixmap(ui->lIcon->size()));
@@ -161,51 +161,80 @@ void MegaTransferView::setup(TransfersWidget* tw)
     connect(MegaSyncApp->getTransfersModel(), &TransfersModel::internalMoveFinished, this, &MegaTransferView::onInternalMoveFinished);
 }
 
-QModelIndexList MegaTransferView::getTransfers(bool onlyVisible, TransferData::TransferStates state)
+TransferTagSet MegaTransferView::getVisibleTransferTags(TransferData::TransferStates state)
 {
-    QModelIndexList indexes;
+    QVector<int> sourceRows;
 
     auto proxy(qobject_cast<QSortFilterProxyModel*>(model()));
     if(proxy)
     {
-        auto sourceModel = MegaSyncApp->getTransfersModel();
-
-        auto rowCount = onlyVisible ? proxy->rowCount(QModelIndex()) : sourceModel->rowCount(QModelIndex());
+        auto rowCount = proxy->rowCount(QModelIndex());
+        sourceRows.reserve(rowCount);
 
         for (auto row (0); row < rowCount; ++row)
         {
-            auto index (model()->index(row, 0, QModelIndex()));
-            auto d (qvariant_cast<TransferItem>(index.data()).getTransferData());
-            if(state == TransferData::TRANSFER_NONE || (d && d->getState() & state))
+            sourceRows.append(proxy->mapToSource(proxy->index(row, 0, QModelIndex())).row());
+        }
+    }
+
+    return MegaSyncApp->getTransfersModel()->getTransferTags(sourceRows, state);
+}
+
+TransferTagSet MegaTransferView::getSelectedTransferTags()
+{
+    QVector<int> sourceRows;
+
+    auto proxy(qobject_cast<QSortFilterProxyModel*>(model()));
+    if(proxy)
+    {
+        const auto selection = selectionModel()->selection();
+        for (const auto& range : selection)
+        {
+            for (auto row (range.top()); row <= range.bottom(); ++row)
             {
-                if (proxy)
-                {
-                    index = proxy->mapToSource(index);
-                }
-                indexes.push_back(index);
+                sourceRows.append(proxy->mapToSource(proxy->index(row, 0, QModelIndex())).row());
             }
         }
     }
 
-    return indexes;
+    return MegaSyncApp->getTransfersModel()->getTransferTags(sourceRows);
 }
 
-QModelIndexList MegaTransferView::getSelectedTransfers()
+QList<QModelIndexList> MegaTransferView::getSelectedRowBlocks()
 {
-    auto selection = selectionModel()->selection();
-    QModelIndexList indexes;
+    QList<QModelIndexList> blocks;
+
+    auto indexes = selectionModel()->selectedRows();
+    std::sort(indexes.begin(), indexes.end(),[](const QModelIndex& check1, const QModelIndex& check2){
+        return check1.row() < check2.row();
+    });
 
-    if (selection.size() > 0)
+    foreach(auto index, indexes)
     {
-        auto proxy(qobject_cast<QSortFilterProxyModel*>(model()));
-        if (proxy)
+        if(blocks.isEmpty() || blocks.last().last().row() + 1 != index.row())
         {
-            selection = proxy->mapSelectionToSource(selection);
+            blocks.append(QModelIndexList());
         }
-        indexes = selection.indexes();
+        blocks.last().append(index);
     }
 
-    return indexes;
+    return blocks;
+}
+
+QList<TransferTag> MegaTransferView::getTransferTags(const QModelIndexList& indexes) const
+{
+    QList<TransferTag> tags;
+
+    foreach(auto index, indexes)
+    {
+        auto d = qvariant_cast<TransferItem>(index.data()).getTransferData();
+        if(d)
+        {
+            tags.append(d->mTag);
+        }
+    }
+
+    return tags;
 }
 
 MegaTransferView::SelectedIndexesInfo MegaTransferView::getVisibleCancelOrClearInfo()
@@ -261,15 +290,16 @@ MegaTransferView::SelectedIndexesInfo MegaTransferView::getVisibleCancelOrClearI
 
 MegaTransferView::SelectedIndexesInfo MegaTransferView::getSelectedCancelOrClearInfo()
 {
-    auto indexes = getSelectedTransfers();
+    auto tags = getSelectedTransferTags();
+    auto sourceModel = MegaSyncApp->getTransfersModel();
 
     SelectedIndexesInfo info;
     bool isAnyActiveSync(false);
     bool isAnyCompleted(false);
 
-    foreach(auto& index, indexes)
+    for (auto tag : tags)
     {
-        auto transfer (qvariant_cast<TransferItem>(index.data()).getTransferData());
+        auto transfer (sourceModel->getTransferByTag(tag));
         if(transfer)
         {
             if(!transfer->isSyncTransfer())
@@ -299,7 +329,7 @@ MegaTransferView::SelectedIndexesInfo MegaTransferView::getSelectedCancelOrClear
     }
 
 
-    if(indexes.size() > 1)
+    if(tags.size() > 1)
     {
         info.buttonsText = getCancelDialogButtons();
         if(isAnyActiveSync)
@@ -352,10 +382,10 @@ MegaTransferView::SelectedIndexesInfo MegaTransferView::getSelectedCancelOrClear
 
 void MegaTransferView::onPauseResumeVisibleRows(bool pauseState)
 {
-    QModelIndexList indexes = getTransfers(true);
+    auto tags = getVisibleTransferTags();
 
     auto sourceModel = MegaSyncApp->getTransfersModel();
-    sourceModel->pauseTransfers(indexes, pauseState);
+    sourceModel->pauseTransfers(tags, pauseState);
 
     //Use to repaint and update the transfers state
     update();
@@ -363,10 +393,10 @@ void MegaTransferView::onPauseResumeVisibleRows(bool pauseState)
 
 void MegaTransferView::onPauseResumeSelection(bool pauseState)
 {
-    QModelIndexList indexes = getSelectedTransfers();
+    auto tags = getSelectedTransferTags();
     auto sourceModel = MegaSyncApp->getTransfersModel();
 
-    sourceModel->pauseTransfers(indexes, pauseState);
+    sourceModel->pauseTransfers(tags, pauseState);
 
     //Use to repaint and update the transfers state
     update();
@@ -386,10 +416,10 @@ void MegaTransferView::onCancelVisibleTransfers()
                 == QMessageBox::Yes
                 && dialog)
         {
-            auto indexes = getTransfers(true);
+            auto tags = getVisibleTransferTags();
 
             auto sourceModel = MegaSyncApp->getTransfersModel();
-            sourceModel->cancelAndClearTransfers(indexes, this);
+            sourceModel->cancelAndClearTransfers(tags, this);
         }
     }
 }
@@ -408,10 +438,10 @@ void MegaTransferView::onCancelSelectedTransfers()
                 == QMessageBox::Yes
                 && dialog)
         {
-            QModelIndexList indexes = getSelectedTransfers();
+            auto tags = getSelectedTransferTags();
 
             auto sourceModel = MegaSyncApp->getTransfersModel();
-            sourceModel->cancelAndClearTransfers(indexes, this);
+            sourceModel->cancelAndClearTransfers(tags, this);
         }
     }
 }
@@ -464,12 +494,12 @@ void MegaTransferView::onCancelAndClearVisibleTransfers()
     {
         auto sourceModel = MegaSyncApp->getTransfersModel();
 
-        auto indexes = getTransfers(true, TransferData::FINISHED_STATES_MASK);
-        sourceModel->clearTransfers(indexes);
+        auto tags = getVisibleTransferTags(TransferData::FINISHED_STATES_MASK);
+        sourceModel->clearTransfers(tags);
 
         //Cancel transfers
-        auto cancelIndexes = getTransfers(true);
-        sourceModel->cancelAndClearTransfers(cancelIndexes, this);
+        auto cancelTags = getVisibleTransferTags();
+        sourceModel->cancelAndClearTransfers(cancelTags, this);
     }
 }
 
@@ -485,8 +515,8 @@ void MegaTransferView::onClearVisibleTransfers()
     {
         auto sourceModel = MegaSyncApp->getTransfersModel();
 
-        auto indexes = getTransfers(true, TransferData::FINISHED_STATES_MASK);
-        sourceModel->clearTransfers(indexes);
+        auto tags = getVisibleTransferTags(TransferData::FINISHED_STATES_MASK);
+        sourceModel->clearTransfers(tags);
     }
 }
 
@@ -515,18 +545,18 @@ int MegaTransferView::getVerticalScrollBarWidth() const
 
 void MegaTransferView::onRetryVisibleTransfers()
 {
-    QModelIndexList indexes = getTransfers(true, TransferData::TRANSFER_FAILED);
+    auto tags = getVisibleTransferTags(TransferData::TRANSFER_FAILED);
 
     auto sourceModel = MegaSyncApp->getTransfersModel();
-    sourceModel->retryTransfers(indexes);
+    sourceModel->retryTransfers(tags);
 }
 
 void MegaTransferView::onCancelClearSelection(bool isClear)
 {
-    QModelIndexList indexes = getSelectedTransfers();
+    auto tags = getSelectedTransferTags();
 
     auto sourceModel = MegaSyncApp->getTransfersModel();
-    isClear ? sourceModel->clearTransfers(indexes) : sourceModel->cancelAndClearTransfers(indexes, this);
+    isClear ? sourceModel->clearTransfers(tags) : sourceModel->cancelAndClearTransfers(tags, this);
 }
 
 void MegaTransferView::enableContextMenu()
@@ -886,34 +916,22 @@ bool MegaTransferView::eventFilter(QObject *object, QEvent *event)
 
 void MegaTransferView::moveToTopClicked()
 {
-    auto proxy(qobject_cast<QSortFilterProxyModel*>(model()));
-    if(proxy)
+    auto blocks = getSelectedRowBlocks();
+    if(!blocks.isEmpty())
     {
-        auto indexes = selectionModel()->selectedRows();
-        if(!indexes.isEmpty())
+        // Already at the top
+        if(blocks.size() == 1 && blocks.first().first().row() == 0)
         {
-            auto sourceModel = MegaSyncApp->getTransfersModel();
-
-            // Sort to keep items in the same order
-            std::sort(indexes.begin(), indexes.end(),[](QModelIndex check1, QModelIndex check2){
-                return check1.row() > check2.row();
-            });
-
-            auto firstToMove = indexes.first();
-
-            if(firstToMove.row() == 0)
-            {
-                return;
-            }
-
-            for (int item = 0; item < indexes.size(); ++item)
-            {
-                auto index = indexes.at(item);
-                auto sourceIndex = proxy->mapToSource(index);
+            return;
+        }
 
-                sourceModel->moveTransferPriority(QModelIndex(), QList<int>() << sourceIndex.row(), QModelIndex(), -1);
-            }
+        QList<TransferTag> tags;
+        foreach(auto block, blocks)
+        {
+            tags.append(getTransferTags(block));
         }
+
+        MegaSyncApp->getTransfersModel()->moveTransfers(tags, TransfersBulkAction::MOVE_TO_TOP);
     }
 
     clearSelection();
@@ -921,102 +939,64 @@ void MegaTransferView::moveToTopClicked()
 
 void MegaTransferView::moveUpClicked()
 {
-    auto indexes = selectionModel()->selectedRows();
-    if(!indexes.isEmpty())
+    auto blocks = getSelectedRowBlocks();
+    if(!blocks.isEmpty())
     {
-        auto proxy(qobject_cast<QSortFilterProxyModel*>(model()));
-        if(proxy)
+        if(blocks.first().first().row() == 0)
         {
-            auto sourceModel = MegaSyncApp->getTransfersModel();
-
-            // Sort to keep items in the same order
-            std::sort(indexes.begin(), indexes.end(),[](QModelIndex check1, QModelIndex check2){
-                return check1.row() < check2.row();
-            });
-
-            auto firstToMove = indexes.first();
+            return;
+        }
 
-            if(firstToMove.row() == 0)
+        // Every block goes before the row above it. The targets are read before moving anything
+        QList<QPair<QList<TransferTag>, TransferTag>> moves;
+        foreach(auto block, blocks)
+        {
+            auto target = getTransferTags(QModelIndexList() << model()->index(block.first().row() - 1, 0));
+            if(!target.isEmpty())
             {
-                return;
+                moves.append(qMakePair(getTransferTags(block), target.first()));
             }
+        }
 
-            auto proxyTargetIndex = proxy->index(indexes.first().row() - 1,0);
-            auto sourceTargetIndex = proxy->mapToSource(proxyTargetIndex);
-            auto rowTarget = sourceTargetIndex.row();
-
-            for (int item = 0; item < indexes.size(); ++item)
-            {
-                auto index = indexes.at(item);
-                auto sourceIndex = proxy->mapToSource(index);
-
-                if(item != 0)
-                {
-                    auto previousIndex = indexes.at(item-1);
-
-                    if(index.row() - previousIndex.row() != 1)
-                    {
-                        proxyTargetIndex = proxy->index(index.row()-1,0);
-                        sourceTargetIndex = proxy->mapToSource(proxyTargetIndex);
-                        rowTarget = sourceTargetIndex.row();
-                    }
-                }
-
-                sourceModel->moveTransferPriority(QModelIndex(), QList<int>() << sourceIndex.row(), QModelIndex(), rowTarget);
-            }
+        auto sourceModel = MegaSyncApp->getTransfersModel();
+        foreach(auto move, moves)
+        {
+            sourceModel->moveTransfers(move.first, move.second);
         }
     }
+
     clearSelection();
 }
 
 void MegaTransferView::moveDownClicked()
 {
-    auto indexes = selectionModel()->selectedRows();
-    if(!indexes.isEmpty())
+    auto blocks = getSelectedRowBlocks();
+    if(!blocks.isEmpty())
     {
-        auto proxy(qobject_cast<QSortFilterProxyModel*>(model()));
-        if(proxy)
+        if(blocks.last().last().row() == model()->rowCount() - 1)
         {
-            auto sourceModel = MegaSyncApp->getTransfersModel();
-
-            // Sort to keep items in the same order
-            std::sort(indexes.begin(), indexes.end(),[](QModelIndex check1, QModelIndex check2){
-                return check1.row() > check2.row();
-            });
-
-            auto firstToMove = indexes.first();
+            return;
+        }
 
-            if(firstToMove.row() == model()->rowCount())
+        // The row below every block goes before it, from the last block to the first one.
+        // The targets are read before moving anything
+        QList<QPair<QList<TransferTag>, QList<TransferTag>>> moves;
+        foreach(auto block, blocks)
+        {
+            auto next = getTransferTags(QModelIndexList() << model()->index(block.last().row() + 1, 0));
+            if(!next.isEmpty())
             {
-                return;
+                moves.prepend(qMakePair(next, getTransferTags(block)));
             }
+        }
 
-            auto proxyTargetIndex = proxy->index(indexes.first().row() + 1,0);
-            auto sourceTargetIndex = proxy->mapToSource(proxyTargetIndex);
-            auto rowTarget = sourceTargetIndex.row();
-
-            sourceModel->inverseMoveRowsSignal(true);
-
-            for (int item = 0; item < indexes.size(); ++item)
+        auto sourceModel = MegaSyncApp->getTransfersModel();
+        foreach(auto move, moves)
+        {
+            if(!move.second.isEmpty())
             {
-                auto index = indexes.at(item);
-                auto sourceIndex = proxy->mapToSource(index);
-
-                if(item != 0)
-                {
-                    auto previousIndex = indexes.at(item-1);
-
-                    if(previousIndex.row() - index.row() != 1)
-                    {
-                        proxyTargetIndex = proxy->index(index.row() + 1,0);
-                        sourceTargetIndex = proxy->mapToSource(proxyTargetIndex);
-                        rowTarget = sourceTargetIndex.row();
-                    }
-                }
-                sourceModel->moveTransferPriority(QModelIndex(), QList<int>() << rowTarget, QModelIndex(), sourceIndex.row());
+                sourceModel->moveTransfers(move.first, move.second.first(), move.second);
             }
-
-            sourceModel->inverseMoveRowsSignal(false);
         }
     }
 
@@ -1025,34 +1005,22 @@ void MegaTransferView::moveDownClicked()
 
 void MegaTransferView::moveToBottomClicked()
 {
-    auto indexes = selectionModel()->selectedRows();
-    if(!indexes.isEmpty())
+    auto blocks = getSelectedRowBlocks();
+    if(!blocks.isEmpty())
     {
-        auto proxy(qobject_cast<QSortFilterProxyModel*>(model()));
-        if(proxy)
+        // Already at the bottom
+        if(blocks.size() == 1 && blocks.first().last().row() == model()->rowCount() - 1)
         {
-            auto sourceModel = MegaSyncApp->getTransfersModel();
-
-            // Sort to keep items in the same order
-            std::sort(indexes.begin(), indexes.end(),[](QModelIndex check1, QModelIndex check2){
-                return check1.row() < check2.row();
-            });
-
-            auto firstToMove = indexes.last();
-
-            if(firstToMove.row() == model()->rowCount())
-            {
-                return;
-            }
-
-            for (int item = 0; item < indexes.size(); ++item)
-            {
-                auto index = indexes.at(item);
-                auto sourceIndex = proxy->mapToSource(index);
+            return;
+        }
 
-                sourceModel->moveTransferPriority(QModelIndex(), QList<int>() << sourceIndex.row(), QModelIndex(), -2);
-            }
+        QList<TransferTag> tags;
+        foreach(auto block, blocks)
+        {
+            tags.append(getTransferTags(block));
         }
+
+        MegaSyncApp->getTransfersModel()->moveTransfers(tags, TransfersBulkAction::MOVE_TO_BOTTOM);
     }
 
     clearSelection();
@@ -2,6 +2,7 @@
 #define MEGATRANSFERVIEW_H
 
 #include "TransfersWidget.h"
+#include "TransfersBulkAction.h"
 
 #include <QGraphicsEffect>
 #include <QTreeView>
@@ -44,6 +45,8 @@ public:
     SelectedIndexesInfo getVisibleCancelOrClearInfo();
     SelectedIndexesInfo getSelectedCancelOrClearInfo();
 
+    TransferTagSet getSelectedTransferTags();
+
     //Static messages for messageboxes
     static QString cancelAllAskActionText();
     static QString cancelAndClearAskActionText();
@@ -117,8 +120,11 @@ private:
     void clearAllTransfers();
     void cancelAllTransfers();
 
-    QModelIndexList getTransfers(bool onlyVisible, TransferData::TransferStates state = TransferData::TRANSFER_NONE);
-    QModelIndexList getSelectedTransfers();
+    // Tags of the visible transfers, read from the proxy row mapping
+    TransferTagSet getVisibleTransferTags(TransferData::TransferStates state = TransferData::TRANSFER_NONE);
+    // Selected rows sorted by row, split in blocks of consecutive rows
+    QList<QModelIndexList> getSelectedRowBlocks();
+    QList<TransferTag> getTransferTags(const QModelIndexList& indexes) const;
 
     void showOpeningFileError();
 
@@ -60,7 +60,7 @@ const TransferData::TransferStates TransferData::ACTIVE_STATES_MASK = TransferDa
 void TransferData::update(mega::MegaTransfer* transfer)
 {
     auto megaApi = MegaSyncApp->getMegaApi();
-    if(transfer && megaApi)
+    if(transfer)
     {   
         mTag = transfer->getTag();
 
@@ -73,7 +73,7 @@ void TransferData::update(mega::MegaTransfer* transfer)
             mType |= TransferData::TRANSFER_SYNC;
         }
 
-        mFileType = Utilities::getFileType(mFilename, QString());
+        mFileType = Utilities::getFileType(mFilename);
 
         //Update priority before setState as the setState changes the priority
         mPriority = transfer->getPriority();
@@ -101,7 +101,9 @@ void TransferData::update(mega::MegaTransfer* transfer)
             }
             else
             {
-                long long httpSpeed = static_cast<unsigned long long>(megaApi->getCurrentSpeed(transfer->getType()));
+                // Without the application MegaApi (replay tests) the transfer speed is used as is
+                long long httpSpeed = megaApi ? static_cast<unsigned long long>(megaApi->getCurrentSpeed(transfer->getType()))
+                                              : transfer->getSpeed();
                 mSpeed = std::min(transfer->getSpeed(), httpSpeed);
             }
 
@@ -326,8 +326,7 @@ void TransferManagerDelegateWidget::setFileNameAndType()
     // Update members
     QIcon icon;
     // File type icon
-    icon = Utilities::getCachedPixmap(Utilities::getExtensionPixmapName(
-                                          getData()->mFilename, QLatin1Literal(":/images/drag_")));
+    icon = Utilities::getExtensionPixmapMedium(getData()->mFilename);
     mUi->tFileType->setIcon(icon);
 
     // File name
@@ -453,9 +453,9 @@ void TransfersWidget::onModelChanged()
     selectAndScrollToMovedTransfer();
 }
 
-void TransfersWidget::onRowsAboutToBeMoved(int scrollTo)
+void TransfersWidget::onRowsAboutToBeMoved(const QList<TransferTag>& tags)
 {
-    mScrollToAfterMovingRow.append(scrollTo);
+    mScrollToAfterMovingRow.append(tags);
 
     if(mProxyModel->getSortCriterion() != static_cast<int>(SortCriterion::PRIORITY))
     {
@@ -502,9 +502,7 @@ void TransfersWidget::onPauseResumeTransfer(bool pause)
 
 void TransfersWidget::onCancelClearButtonPressedOnDelegate()
 {
-    auto selection = ui->tvTransfers->selectionModel()->selection();
-    auto sourceSelection= mProxyModel->mapSelectionToSource(selection);
-    auto sourceSelectionIndexes = sourceSelection.indexes();
+    auto tags = ui->tvTransfers->getSelectedTransferTags();
 
     auto info = ui->tvTransfers->getSelectedCancelOrClearInfo();
 
@@ -519,16 +517,12 @@ void TransfersWidget::onCancelClearButtonPressedOnDelegate()
         return;
     }
 
-    getModel()->cancelAndClearTransfers(sourceSelectionIndexes, this);
+    getModel()->cancelAndClearTransfers(tags, this);
 }
 
 void TransfersWidget::onRetryButtonPressedOnDelegate()
 {
-    auto selection = ui->tvTransfers->selectionModel()->selection();
-    auto sourceSelection= mProxyModel->mapSelectionToSource(selection);
-    auto sourceSelectionIndexes = sourceSelection.indexes();
-
-    getModel()->retryTransfers(sourceSelectionIndexes);
+    getModel()->retryTransfers(ui->tvTransfers->getSelectedTransferTags());
 }
 
 void TransfersWidget::on_tPauseResumeVisible_toggled(bool state)
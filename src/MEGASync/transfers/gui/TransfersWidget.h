@@ -97,7 +97,7 @@ private slots:
     void onUiUnblockedAndFilter();
     void onModelChanged();
     void onModelAboutToBeChanged();
-    void onRowsAboutToBeMoved(int scrollTo);
+    void onRowsAboutToBeMoved(const QList<TransferTag>& tags);
     void onPauseResumeTransfer(bool pause);
     void onCancelClearButtonPressedOnDelegate();
     void onRetryButtonPressedOnDelegate();
@@ -0,0 +1,184 @@
+#include "TransferLinksResolver.h"
+
+#include "MegaApplication.h"
+#include "Preferences.h"
+#include "Utilities.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QFutureWatcher>
+#include <QUrl>
+
+#include <memory>
+
+using namespace mega;
+
+namespace
+{
+// Completed transfers whose nodes are remembered
+constexpr int MAX_CACHED_NODES = 20000;
+}
+
+TransferLinksResolver::TransferLinksResolver(MegaApi* megaApi, QObject* parent)
+    : QObject(parent),
+      mMegaApi(megaApi)
+{
+    connect(MegaSyncApp, &MegaApplication::nodePublicLinkChanged, this, &TransferLinksResolver::onNodeChanged);
+    connect(MegaSyncApp, &MegaApplication::nodeRemoved, this, &TransferLinksResolver::onNodeChanged);
+}
+
+void TransferLinksResolver::copyLinks(const QList<Request>& requests)
+{
+    resolve(COPY_LINKS, requests);
+}
+
+void TransferLinksResolver::openInMEGA(const QList<Request>& requests)
+{
+    resolve(OPEN_IN_MEGA, requests);
+}
+
+void TransferLinksResolver::clearCache()
+{
+    mCache.clear();
+}
+
+void TransferLinksResolver::onNodeChanged(MegaHandle handle)
+{
+    mCache.remove(handle);
+}
+
+void TransferLinksResolver::resolve(Action action, const QList<Request>& requests)
+{
+    // Results in the order of the requests, the ones not cached are filled by the thread pool
+    QList<Resolved> resolved;
+    QList<Request> toResolve;
+    QList<int> positions;
+
+    for (const auto& request : requests)
+    {
+        // Nodes without a link are cached too: exporting one drops its entry
+        auto cached (request.completed ? mCache.constFind(request.nodeHandle) : mCache.constEnd());
+        if (cached != mCache.constEnd())
+        {
+            resolved.append(cached.value());
+        }
+        else
+        {
+            positions.append(resolved.size());
+            resolved.append(Resolved());
+            toResolve.append(request);
+        }
+    }
+
+    if (toResolve.isEmpty())
+    {
+        finish(action, resolved);
+        return;
+    }
+
+    auto watcher (new QFutureWatcher<Resolved>(this));
+    connect(watcher, &QFutureWatcher<Resolved>::finished, this, [this, watcher, action, resolved, positions]() mutable
+    {
+        const auto results (watcher->future().results());
+        for (int i = 0; i < results.size(); ++i)
+        {
+            resolved[positions.at(i)] = results.at(i);
+        }
+        finish(action, resolved);
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::mapped(toResolve, NodeResolver{mMegaApi}));
+}
+
+void TransferLinksResolver::finish(Action action, QList<Resolved> resolved)
+{
+    QList<MegaHandle> exportList;
+    QStringList linkList;
+
+    for (const auto& node : qAsConst(resolved))
+    {
+        if (node.completed && node.found)
+        {
+            if (mCache.size() >= MAX_CACHED_NODES)
+            {
+                mCache.clear();
+            }
+            mCache.insert(node.nodeHandle, node);
+        }
+
+        if (action == OPEN_IN_MEGA)
+        {
+            if (node.found && !node.base64Handle.isEmpty())
+            {
+                Utilities::openUrl(QUrl(QString::fromUtf8("mega://#fm/") + node.base64Handle));
+            }
+        }
+        else if (node.link.isEmpty())
+        {
+            exportList.push_back(node.nodeHandle);
+        }
+        else
+        {
+            linkList.push_back(node.link);
+        }
+    }
+
+    if (exportList.size() || linkList.size())
+    {
+        MegaSyncApp->exportNodes(exportList, linkList);
+    }
+}
+
+TransferLinksResolver::Resolved TransferLinksResolver::NodeResolver::operator()(const Request& request) const
+{
+    Resolved resolved;
+    resolved.nodeHandle = request.nodeHandle;
+    resolved.completed = request.completed;
+
+    std::unique_ptr<MegaNode> node;
+    if (request.failed)
+    {
+        std::unique_ptr<MegaTransfer> transfer (megaApi->getTransferByTag(request.tag));
+        if (transfer)
+        {
+            node.reset(transfer->getPublicMegaNode());
+        }
+    }
+    else if (request.nodeHandle)
+    {
+        node.reset(megaApi->getNodeByHandle(request.nodeHandle));
+    }
+
+    if (node)
+    {
+        resolved.found = true;
+
+        std::unique_ptr<char[]> handle (node->getBase64Handle());
+        if (handle)
+        {
+            resolved.base64Handle = QString::fromUtf8(handle.get());
+        }
+
+        // Public nodes come from a link of someone else, the link can be built from them.
+        // Own nodes have a link only if they were exported
+        if (node->isPublic())
+        {
+            std::unique_ptr<char[]> key (node->getBase64Key());
+            if (handle && key)
+            {
+                resolved.link = Preferences::BASE_URL + QString::fromUtf8("/#!%1!%2")
+                        .arg(resolved.base64Handle, QString::fromUtf8(key.get()));
+            }
+        }
+        else if (node->isExported())
+        {
+            std::unique_ptr<char[]> link (node->getPublicLink());
+            if (link)
+            {
+                resolved.link = QString::fromUtf8(link.get());
+            }
+        }
+    }
+
+    return resolved;
+}
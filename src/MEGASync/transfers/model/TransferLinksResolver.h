@@ -0,0 +1,73 @@
+#ifndef TRANSFERLINKSRESOLVER_H
+#define TRANSFERLINKSRESOLVER_H
+
+#include "TransferItem.h"
+
+#include <megaapi.h>
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+// Resolves the nodes of the transfers (and their links, when they are exported already) on the
+// thread pool, so the model mutex is only held while the handles are read.
+// The results of completed transfers are cached, as their nodes do not change; an entry is dropped
+// when the public link of its node is created, changed or removed, or when the node is removed.
+class TransferLinksResolver : public QObject
+{
+    Q_OBJECT
+
+public:
+    // What the model knows about a transfer, read under its mutex
+    struct Request
+    {
+        TransferTag tag = 0;
+        mega::MegaHandle nodeHandle = mega::INVALID_HANDLE;
+        bool failed = false;
+        bool completed = false;
+    };
+
+    TransferLinksResolver(mega::MegaApi* megaApi, QObject* parent);
+
+    // The links not exported yet are exported by MegaApplication::exportNodes
+    void copyLinks(const QList<Request>& requests);
+    void openInMEGA(const QList<Request>& requests);
+    void clearCache();
+
+private slots:
+    void onNodeChanged(mega::MegaHandle handle);
+
+private:
+    enum Action
+    {
+        COPY_LINKS = 0,
+        OPEN_IN_MEGA
+    };
+
+    struct Resolved
+    {
+        mega::MegaHandle nodeHandle = mega::INVALID_HANDLE;
+        bool completed = false;
+        bool found = false;
+        QString base64Handle;
+        // Empty if the node is not exported
+        QString link;
+    };
+
+    void resolve(Action action, const QList<Request>& requests);
+    void finish(Action action, QList<Resolved> resolved);
+
+    // Run on the thread pool
+    struct NodeResolver
+    {
+        typedef Resolved result_type;
+
+        mega::MegaApi* megaApi;
+        Resolved operator()(const Request& request) const;
+    };
+
+    mega::MegaApi* mMegaApi;
+    QHash<mega::MegaHandle, Resolved> mCache;
+};
+
+#endif // TRANSFERLINKSRESOLVER_H
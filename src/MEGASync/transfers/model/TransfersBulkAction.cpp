@@ -0,0 +1,221 @@
+#include "TransfersBulkAction.h"
+
+#include "TransfersModel.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+
+namespace
+{
+// SDK requests sent by a worker thread in one go, the GUI thread gets control back between chunks
+constexpr int CHUNK_SIZE = 500;
+}
+
+void sortTransferTagSet(TransferTagSet& tags)
+{
+    std::sort(tags.begin(), tags.end());
+    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+}
+
+int TransfersBulkAction::Job::size() const
+{
+    return action == RETRY ? failedTransfers.size() : static_cast<int>(tags.size());
+}
+
+TransfersBulkAction::TransfersBulkAction(TransfersModel* model, mega::MegaApi* megaApi)
+    : QObject(model),
+      mModel(model),
+      mMegaApi(megaApi),
+      mChunkRunning(false)
+{
+    connect(&mChunkWatcher, &QFutureWatcher<void>::finished, this, &TransfersBulkAction::onChunkFinished);
+}
+
+TransfersBulkAction::~TransfersBulkAction()
+{
+    mJobs.clear();
+    mChunkWatcher.waitForFinished();
+}
+
+void TransfersBulkAction::start(Action action, TransferTagSet tags)
+{
+    if (tags.empty() || action == RETRY)
+    {
+        return;
+    }
+
+    if (action == PAUSE || action == RESUME)
+    {
+        for (auto& job : mJobs)
+        {
+            if (job.action == PAUSE || job.action == RESUME)
+            {
+                job.cancelled = true;
+            }
+        }
+    }
+
+    Job job;
+    job.action = action;
+    job.tags = std::move(tags);
+    mJobs.push_back(std::move(job));
+
+    if (!mChunkRunning)
+    {
+        startNextChunk();
+    }
+}
+
+void TransfersBulkAction::start(QList<std::shared_ptr<mega::MegaTransfer>> failedTransfers)
+{
+    if (failedTransfers.isEmpty())
+    {
+        return;
+    }
+
+    Job job;
+    job.action = RETRY;
+    job.failedTransfers = std::move(failedTransfers);
+    mJobs.push_back(std::move(job));
+
+    if (!mChunkRunning)
+    {
+        startNextChunk();
+    }
+}
+
+void TransfersBulkAction::startMove(std::vector<TransferTag> tags, TransferTag target)
+{
+    if (tags.empty())
+    {
+        return;
+    }
+
+    // Each transfer moved to the top goes before the previous ones, so they are sent the other way round
+    if (target == MOVE_TO_TOP)
+    {
+        std::reverse(tags.begin(), tags.end());
+    }
+
+    Job job;
+    job.action = MOVE;
+    job.tags = std::move(tags);
+    job.moveTarget = target;
+    mJobs.push_back(std::move(job));
+
+    if (!mChunkRunning)
+    {
+        startNextChunk();
+    }
+}
+
+bool TransfersBulkAction::isRunning() const
+{
+    return !mJobs.empty();
+}
+
+void TransfersBulkAction::onChunkFinished()
+{
+    mChunkRunning = false;
+    startNextChunk();
+}
+
+void TransfersBulkAction::startNextChunk()
+{
+    while (!mJobs.empty() && (mJobs.front().cancelled || mJobs.front().done >= mJobs.front().size()))
+    {
+        finishJob();
+    }
+
+    if (mJobs.empty())
+    {
+        return;
+    }
+
+    auto& job = mJobs.front();
+    const int first = job.done;
+    const int last = std::min(job.size(), first + CHUNK_SIZE);
+    auto megaApi = mMegaApi;
+
+    QFuture<void> future;
+    switch (job.action)
+    {
+        case PAUSE:
+        case RESUME:
+        {
+            // The model shows the new state right away, the SDK confirms it later
+            const bool pause = job.action == PAUSE;
+            auto tags = mModel->pauseResumeTransfersByTag(job.tags.cbegin() + first, job.tags.cbegin() + last, pause);
+            future = QtConcurrent::run([megaApi, tags, pause]()
+            {
+                for (auto tag : tags)
+                {
+                    megaApi->pauseTransferByTag(tag, pause);
+                }
+            });
+            break;
+        }
+        case CANCEL:
+        {
+            TransferTagSet tags(job.tags.cbegin() + first, job.tags.cbegin() + last);
+            future = QtConcurrent::run([megaApi, tags]()
+            {
+                for (auto tag : tags)
+                {
+                    megaApi->cancelTransferByTag(tag);
+                }
+            });
+            break;
+        }
+        case RETRY:
+        {
+            auto transfers = job.failedTransfers.mid(first, last - first);
+            future = QtConcurrent::run([megaApi, transfers]()
+            {
+                for (const auto& transfer : transfers)
+                {
+                    megaApi->retryTransfer(transfer.get());
+                }
+            });
+            break;
+        }
+        case MOVE:
+        {
+            // The SDK has no call to move a block: moving every transfer before the same target
+            // (or to the same end of the queue) keeps them together and in order
+            TransferTagSet tags(job.tags.cbegin() + first, job.tags.cbegin() + last);
+            const auto target = job.moveTarget;
+            future = QtConcurrent::run([megaApi, tags, target]()
+            {
+                for (auto tag : tags)
+                {
+                    if (target == MOVE_TO_TOP)
+                    {
+                        megaApi->moveTransferToFirstByTag(tag);
+                    }
+                    else if (target == MOVE_TO_BOTTOM)
+                    {
+                        megaApi->moveTransferToLastByTag(tag);
+                    }
+                    else
+                    {
+                        megaApi->moveTransferBeforeByTag(tag, target);
+                    }
+                }
+            });
+            break;
+        }
+    }
+
+    job.done = last;
+    mChunkRunning = true;
+    mChunkWatcher.setFuture(future);
+}
+
+void TransfersBulkAction::finishJob()
+{
+    const Action action = mJobs.front().action;
+    mJobs.pop_front();
+    emit finished(action);
+}
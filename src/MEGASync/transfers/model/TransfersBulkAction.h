@@ -0,0 +1,87 @@
+#ifndef TRANSFERSBULKACTION_H
+#define TRANSFERSBULKACTION_H
+
+#include "TransferItem.h"
+
+#include <megaapi.h>
+
+#include <QFutureWatcher>
+#include <QObject>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+class TransfersModel;
+
+// Tags of the transfers an action is applied to, sorted and without repetitions
+using TransferTagSet = std::vector<TransferTag>;
+
+void sortTransferTagSet(TransferTagSet& tags);
+
+// Applies an action to many transfers in chunks: the model is updated on the GUI thread and the SDK
+// requests of the chunk are sent from a worker thread, without holding the model mutex.
+// Jobs run one after the other; a new pause or resume drops the remaining chunks of the previous ones.
+class TransfersBulkAction : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Action
+    {
+        PAUSE = 0,
+        RESUME,
+        CANCEL,
+        RETRY,
+        MOVE
+    };
+
+    // Destinations of a move besides a transfer tag
+    enum MoveDestination
+    {
+        MOVE_TO_TOP = -1,
+        MOVE_TO_BOTTOM = -2
+    };
+
+    TransfersBulkAction(TransfersModel* model, mega::MegaApi* megaApi);
+    ~TransfersBulkAction();
+
+    // A pause or a resume cancels the pause or resume jobs not finished yet
+    void start(Action action, TransferTagSet tags);
+    void start(QList<std::shared_ptr<mega::MegaTransfer>> failedTransfers);
+    // Sends the SDK the moves of the transfers (in their final order) before target,
+    // which is a tag or a MoveDestination
+    void startMove(std::vector<TransferTag> tags, TransferTag target);
+    bool isRunning() const;
+
+signals:
+    void finished(int action);
+
+private slots:
+    void onChunkFinished();
+
+private:
+    struct Job
+    {
+        Action action;
+        // Sorted, except for MOVE where they are kept in the order they are sent
+        TransferTagSet tags;
+        TransferTag moveTarget = MOVE_TO_TOP;
+        QList<std::shared_ptr<mega::MegaTransfer>> failedTransfers;
+        int done = 0;
+        bool cancelled = false;
+
+        int size() const;
+    };
+
+    void startNextChunk();
+    void finishJob();
+
+    TransfersModel* mModel;
+    mega::MegaApi* mMegaApi;
+    std::deque<Job> mJobs;
+    QFutureWatcher<void> mChunkWatcher;
+    bool mChunkRunning;
+};
+
+#endif // TRANSFERSBULKACTION_H
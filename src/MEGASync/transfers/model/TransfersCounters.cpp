@@ -0,0 +1,173 @@
+#include "TransfersCounters.h"
+
+#include <megaapi.h>
+
+long long TransfersCount::getTransfersByType(Utilities::FileType fileType) const
+{
+    auto index = TransfersCounters::fileTypeIndex(fileType);
+    return index >= 0 ? transfersByType[index] : 0;
+}
+
+long long TransfersCount::getFinishedByType(Utilities::FileType fileType) const
+{
+    auto index = TransfersCounters::fileTypeIndex(fileType);
+    return index >= 0 ? transfersFinishedByType[index] : 0;
+}
+
+TransfersCounters::TransfersCounters()
+    : mSequence(0)
+{
+    for (int scope = 0; scope < SCOPES; ++scope)
+    {
+        for (int direction = 0; direction < DIRECTIONS; ++direction)
+        {
+            for (int counter = 0; counter < COUNTERS; ++counter)
+            {
+                mCounters[scope][direction][counter].store(0, std::memory_order_relaxed);
+            }
+        }
+        for (int type = 0; type < TRANSFER_FILE_TYPES; ++type)
+        {
+            for (int counter = 0; counter < TYPE_COUNTERS; ++counter)
+            {
+                mByType[scope][type][counter].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+TransfersCount TransfersCounters::snapshot(Scope scope) const
+{
+    TransfersCount count;
+    unsigned int before = 0;
+    unsigned int after = 0;
+    do
+    {
+        before = mSequence.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            // A writer is in the middle of a group of changes
+            continue;
+        }
+
+        auto& uploads = mCounters[scope][UPLOAD];
+        auto& downloads = mCounters[scope][DOWNLOAD];
+        count.totalUploads = static_cast<int>(uploads[TOTAL].load(std::memory_order_relaxed));
+        count.pendingUploads = static_cast<int>(uploads[PENDING].load(std::memory_order_relaxed));
+        count.failedUploads = static_cast<int>(uploads[FAILED].load(std::memory_order_relaxed));
+        count.completedUploadBytes = uploads[COMPLETED_BYTES].load(std::memory_order_relaxed);
+        count.totalUploadBytes = uploads[TOTAL_BYTES].load(std::memory_order_relaxed);
+        count.totalDownloads = static_cast<int>(downloads[TOTAL].load(std::memory_order_relaxed));
+        count.pendingDownloads = static_cast<int>(downloads[PENDING].load(std::memory_order_relaxed));
+        count.failedDownloads = static_cast<int>(downloads[FAILED].load(std::memory_order_relaxed));
+        count.completedDownloadBytes = downloads[COMPLETED_BYTES].load(std::memory_order_relaxed);
+        count.totalDownloadBytes = downloads[TOTAL_BYTES].load(std::memory_order_relaxed);
+        for (int type = 0; type < TRANSFER_FILE_TYPES; ++type)
+        {
+            count.transfersByType[type] = mByType[scope][type][TYPE_STARTED].load(std::memory_order_relaxed);
+            count.transfersFinishedByType[type] = mByType[scope][type][TYPE_FINISHED].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = mSequence.load(std::memory_order_relaxed);
+    }
+    while ((before & 1) || before != after);
+
+    return count;
+}
+
+TransfersCounters::Direction TransfersCounters::direction(int megaTransferType)
+{
+    return megaTransferType == mega::MegaTransfer::TYPE_UPLOAD ? UPLOAD : DOWNLOAD;
+}
+
+int TransfersCounters::fileTypeIndex(Utilities::FileType fileType)
+{
+    switch (fileType)
+    {
+        case Utilities::FileType::TYPE_OTHER:
+            return 0;
+        case Utilities::FileType::TYPE_AUDIO:
+            return 1;
+        case Utilities::FileType::TYPE_VIDEO:
+            return 2;
+        case Utilities::FileType::TYPE_ARCHIVE:
+            return 3;
+        case Utilities::FileType::TYPE_DOCUMENT:
+            return 4;
+        case Utilities::FileType::TYPE_IMAGE:
+            return 5;
+    }
+    return -1;
+}
+
+TransfersCounters::Writer::Writer(TransfersCounters& counters)
+    : mCounters(counters),
+      mLock(&counters.mWriterMutex)
+{
+    mCounters.mSequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+TransfersCounters::Writer::~Writer()
+{
+    mCounters.mSequence.fetch_add(1, std::memory_order_release);
+}
+
+void TransfersCounters::Writer::add(Scope scope, Direction direction, Counter counter, long long delta)
+{
+    auto& value = mCounters.mCounters[scope][direction][counter];
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+void TransfersCounters::Writer::addByType(Scope scope, Utilities::FileType fileType, TypeCounter counter, long long delta)
+{
+    auto index = fileTypeIndex(fileType);
+    if (index >= 0)
+    {
+        auto& value = mCounters.mByType[scope][index][counter];
+        value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+}
+
+long long TransfersCounters::Writer::value(Scope scope, Direction direction, Counter counter) const
+{
+    return mCounters.mCounters[scope][direction][counter].load(std::memory_order_relaxed);
+}
+
+long long TransfersCounters::Writer::pendingTransfers(Scope scope) const
+{
+    return value(scope, UPLOAD, PENDING) + value(scope, DOWNLOAD, PENDING);
+}
+
+void TransfersCounters::Writer::markCompleted(Direction direction, int tag)
+{
+    mCounters.mLastCompletedTags[direction].insert(tag);
+}
+
+bool TransfersCounters::Writer::unmarkCompleted(Direction direction, int tag)
+{
+    return mCounters.mLastCompletedTags[direction].remove(tag);
+}
+
+void TransfersCounters::Writer::clear(Scope scope)
+{
+    for (int direction = 0; direction < DIRECTIONS; ++direction)
+    {
+        for (int counter = 0; counter < COUNTERS; ++counter)
+        {
+            mCounters.mCounters[scope][direction][counter].store(0, std::memory_order_relaxed);
+        }
+        if (scope == SCOPE_LAST)
+        {
+            mCounters.mLastCompletedTags[direction].clear();
+        }
+    }
+    for (int type = 0; type < TRANSFER_FILE_TYPES; ++type)
+    {
+        for (int counter = 0; counter < TYPE_COUNTERS; ++counter)
+        {
+            mCounters.mByType[scope][type][counter].store(0, std::memory_order_relaxed);
+        }
+    }
+}
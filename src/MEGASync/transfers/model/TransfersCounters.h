@@ -0,0 +1,143 @@
+#ifndef TRANSFERSCOUNTERS_H
+#define TRANSFERSCOUNTERS_H
+
+#include "control/Utilities.h"
+
+#include <QMutex>
+#include <QSet>
+
+#include <array>
+#include <atomic>
+
+constexpr int TRANSFER_FILE_TYPES = 6;
+
+struct TransfersCount
+{
+    int totalUploads;
+    int totalDownloads;
+
+    int pendingUploads;
+    int pendingDownloads;
+
+    int failedUploads;
+    int failedDownloads;
+
+    long long completedUploadBytes;
+    long long completedDownloadBytes;
+
+    long long totalUploadBytes;
+    long long totalDownloadBytes;
+
+    // Indexed by TransfersCounters::fileTypeIndex
+    std::array<long long, TRANSFER_FILE_TYPES> transfersByType;
+    std::array<long long, TRANSFER_FILE_TYPES> transfersFinishedByType;
+
+    TransfersCount():
+        totalUploads(0),
+        totalDownloads(0),
+        pendingUploads(0),
+        pendingDownloads(0),
+        failedUploads(0),
+        failedDownloads(0),
+        completedUploadBytes(0),
+        completedDownloadBytes(0),
+        totalUploadBytes(0),
+        totalDownloadBytes(0),
+        transfersByType{},
+        transfersFinishedByType{}
+    {}
+
+    int completedDownloads()const {return totalDownloads - pendingDownloads - failedDownloads;}
+    int completedUploads() const {return totalUploads - pendingUploads - failedUploads;}
+    int pendingTransfers() const {return pendingDownloads + pendingUploads;}
+
+    long long totalFailedTransfers() const {return failedUploads + failedDownloads;}
+
+    long long getTransfersByType(Utilities::FileType fileType) const;
+    long long getFinishedByType(Utilities::FileType fileType) const;
+
+    void clear()
+    {
+        *this = TransfersCount();
+    }
+};
+
+// Transfer counters kept in fixed-size arrays and updated by deltas from the transfer listener
+// thread. Writers are serialized with a mutex and publish through a sequence lock, so readers
+// get a consistent snapshot without locking.
+class TransfersCounters
+{
+public:
+    enum Scope
+    {
+        SCOPE_ALL = 0,
+        // Transfers since the last time there were no pending ones
+        SCOPE_LAST,
+        SCOPES
+    };
+
+    enum Direction
+    {
+        UPLOAD = 0,
+        DOWNLOAD,
+        DIRECTIONS
+    };
+
+    enum Counter
+    {
+        TOTAL = 0,
+        PENDING,
+        FAILED,
+        COMPLETED_BYTES,
+        TOTAL_BYTES,
+        COUNTERS
+    };
+
+    enum TypeCounter
+    {
+        TYPE_STARTED = 0,
+        TYPE_FINISHED,
+        TYPE_COUNTERS
+    };
+
+    // Exclusive write access for a group of changes. Readers never see a group half applied
+    class Writer
+    {
+    public:
+        explicit Writer(TransfersCounters& counters);
+        ~Writer();
+
+        void add(Scope scope, Direction direction, Counter counter, long long delta);
+        void addByType(Scope scope, Utilities::FileType fileType, TypeCounter counter, long long delta);
+        long long value(Scope scope, Direction direction, Counter counter) const;
+        long long pendingTransfers(Scope scope) const;
+
+        // Completed transfers tracked in the last scope
+        void markCompleted(Direction direction, int tag);
+        bool unmarkCompleted(Direction direction, int tag);
+
+        void clear(Scope scope);
+
+    private:
+        Q_DISABLE_COPY(Writer)
+        TransfersCounters& mCounters;
+        QMutexLocker mLock;
+    };
+
+    TransfersCounters();
+
+    TransfersCount snapshot(Scope scope) const;
+
+    static Direction direction(int megaTransferType);
+    static int fileTypeIndex(Utilities::FileType fileType);
+
+private:
+    std::atomic<long long> mCounters[SCOPES][DIRECTIONS][COUNTERS];
+    std::atomic<long long> mByType[SCOPES][TRANSFER_FILE_TYPES][TYPE_COUNTERS];
+    std::atomic<unsigned int> mSequence;
+
+    QMutex mWriterMutex;
+    QSet<int> mLastCompletedTags[DIRECTIONS];
+};
+
+#endif // TRANSFERSCOUNTERS_H
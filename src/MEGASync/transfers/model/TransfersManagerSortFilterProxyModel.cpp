@@ -2,6 +2,7 @@
 #include "TransfersModel.h"
 #include "MegaApplication.h"
 #include "TransferManagerDelegateWidget.h"
+#include "Tracer.h"
 #include <megaapi.h>
 
 #include <QMutexLocker>
@@ -92,6 +93,7 @@ void TransfersManagerSortFilterProxyModel::textSearchTypeChanged()
 
 void TransfersManagerSortFilterProxyModel::invalidateModel()
 {
+    TraceSpan span("TransfersManagerSortFilterProxyModel::invalidateModel", "transfers");
     if(!dynamicSortFilter())
     {
         setDynamicSortFilter(true);
@@ -501,40 +503,38 @@ bool TransfersManagerSortFilterProxyModel::dropMimeData(const QMimeData *data, Q
     if (destRow >= 0 && destRow <= rowCount() && action == Qt::MoveAction)
     {
         auto sourceM = dynamic_cast<TransfersModel*>(sourceModel());
-        auto rows = sourceM->getDragAndDropRows(data);
-
-        if(destRow == rowCount())
+        auto tags = sourceM->getDragAndDropTags(data);
+        if(tags.isEmpty())
         {
-            //Move the rows to the second to last, and then move the last to the first tag moved (there is not a method for that on the SDK)
-            destRow--;
-            QModelIndex proxyIndex = index(destRow, column,parent);
-            auto sourceIndex = mapToSource(proxyIndex);
-
-            sourceM->moveTransferPriority(parent,rows,parent, sourceIndex.row());
-
-            sourceM->ignoreMoveRowsSignal(true);
-            sourceM->moveTransferPriority(parent, QList<int>() << sourceIndex.row(), parent, rows.first());
-            sourceM->ignoreMoveRowsSignal(false);
+            return false;
         }
-        else if(destRow == 0)
+
+        if(destRow == rowCount())
         {
-            QModelIndex proxyIndex = index(destRow, column,parent);
-            auto sourceIndex = mapToSource(proxyIndex);
-            sourceM->moveTransferPriority(parent, rows , parent, sourceIndex.row());
+            sourceM->moveTransfers(tags, TransfersBulkAction::MOVE_TO_BOTTOM);
         }
         else
         {
-            QModelIndex proxyIndex = index(destRow, column,parent);
-            auto sourceIndex = mapToSource(proxyIndex);
-            sourceM->moveTransferPriority(parent, rows , parent, sourceIndex.row());
+            auto target = qvariant_cast<TransferItem>(index(destRow, column, parent).data()).getTransferData();
+            if(!target)
+            {
+                return false;
+            }
+
+            // Sorted by other criteria, the previous row is not the previous transfer in the queue:
+            // it is moved before the dropped ones to keep the order shown.
+            // It is read first, as the views sort by priority once the rows are moved
+            QExplicitlySharedDataPointer<TransferData> previous;
+            if(destRow > 0 && mSortCriterion != SortCriterion::PRIORITY)
+            {
+                previous = qvariant_cast<TransferItem>(index(destRow - 1, column, parent).data()).getTransferData();
+            }
+
+            sourceM->moveTransfers(tags, target->mTag);
 
-            if(mSortCriterion != SortCriterion::PRIORITY)
+            if(previous && !tags.contains(previous->mTag))
             {
-                sourceM->ignoreMoveRowsSignal(true);
-                auto previousProxyIndex = index(destRow -1, column, parent);
-                auto previousSourceIndex = mapToSource(previousProxyIndex);
-                sourceM->moveTransferPriority(parent, QList<int>() << previousSourceIndex.row() , parent, rows.first());
-                sourceM->ignoreMoveRowsSignal(false);
+                sourceM->moveTransfers(QList<TransferTag>() << previous->mTag, tags.first(), QList<TransferTag>());
             }
         }
     }
@@ -615,32 +615,38 @@ bool TransfersManagerSortFilterProxyModel::isModelProcessing() const
 bool TransfersManagerSortFilterProxyModel::moveRows(const QModelIndex &proxyParent, int proxyRow, int count,
               const QModelIndex &destinationParent, int destinationChild)
 {
-    bool moveOk(true);
-    int row(proxyRow);
-    auto totalRows(rowCount());
-
     auto sourceM = dynamic_cast<TransfersModel*>(sourceModel());
-    auto sourceTotalRows(sourceM->rowCount());
 
-    while (moveOk && row < (proxyRow+count))
+    QList<TransferTag> tags;
+    for (int row = proxyRow; row < proxyRow + count; ++row)
     {
-        auto sourceIndex(mapToSource(index(proxyRow, 0, proxyParent)));
-        int destRow;
-        if (destinationChild == totalRows)
+        auto d = qvariant_cast<TransferItem>(index(row, 0, proxyParent).data()).getTransferData();
+        if(d)
         {
-            destRow = sourceTotalRows;
+            tags.append(d->mTag);
         }
-        else
+    }
+
+    if(tags.isEmpty())
+    {
+        return false;
+    }
+
+    if (destinationChild == rowCount())
+    {
+        sourceM->moveTransfers(tags, TransfersBulkAction::MOVE_TO_BOTTOM);
+    }
+    else
+    {
+        auto target = qvariant_cast<TransferItem>(index(destinationChild, 0, destinationParent).data()).getTransferData();
+        if(!target)
         {
-            destRow = mapToSource(index(destinationChild, 0, destinationParent)).row();
+            return false;
         }
-
-        moveOk = sourceM->moveTransferPriority(sourceIndex.parent(), QList<int>() << sourceIndex.row(),
-                                         sourceIndex.parent(), destRow);
-        row++;
+        sourceM->moveTransfers(tags, target->mTag);
     }
 
-    return moveOk;
+    return true;
 }
 
 void TransfersManagerSortFilterProxyModel::onCancelClearTransfer()
@@ -8,10 +8,12 @@
 #include "SettingsDialog.h"
 #include "platform/PowerOptions.h"
 #include "PlatformStrings.h"
+#include "Tracer.h"
 
 #include <QSharedData>
 
 #include <algorithm>
+#include <limits>
 
 using namespace mega;
 
@@ -23,6 +25,8 @@ const int START_THRESHOLD_THREAD = 50;
 const int FAILED_THRESHOLD_THREAD = 100;
 const int PAUSE_RESUME_THRESHOLD_THREAD = 300;
 const int CLEAR_THRESHOLD_THREAD = 300;
+// Distance between the priorities of consecutive transfers in the SDK queue
+const unsigned long long PRIORITY_STEP = 0x10000;
 
 //LISTENER THREAD
 TransferThread::TransferThread() : mMaxTransfersToProcess(MAX_TRANSFERS)
@@ -30,6 +34,7 @@ TransferThread::TransferThread() : mMaxTransfersToProcess(MAX_TRANSFERS)
 
 TransferThread::TransfersToProcess TransferThread::processTransfers()
 {
+   TraceSpan span("TransferThread::processTransfers", "transfers");
    TransfersToProcess transfers;
    if(mCacheMutex.tryLock())
    {
@@ -60,7 +65,8 @@ void TransferThread::clear()
     QMutexLocker lock(&mCacheMutex);
 
     mTransfersToProcess.clear();
-    mTransfersCount.clear();
+    TransfersCounters::Writer counters(mCounters);
+    counters.clear(TransfersCounters::SCOPE_ALL);
 }
 
 QList<QExplicitlySharedDataPointer<TransferData>> TransferThread::extractFromCache(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, int spaceForTransfers)
@@ -195,37 +201,23 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::onTransferEvent(MegaT
 
 void TransferThread::onTransferStart(MegaApi *, MegaTransfer *transfer)
 {
+    TraceSpan span("TransferThread::onTransferStart", "transfers");
     if (!transfer->isStreamingTransfer()
             && !transfer->isFolderTransfer())
     {
         {
-            QMutexLocker counterLock(&mCountersMutex);
-            auto fileType = Utilities::getFileType(QString::fromStdString(transfer->getFileName()), QString());
-            mTransfersCount.transfersByType[fileType]++;
+            auto fileType = Utilities::getFileType(QString::fromStdString(transfer->getFileName()));
+            auto direction = TransfersCounters::direction(transfer->getType());
 
-            if(transfer->getType() == MegaTransfer::TYPE_UPLOAD)
-            {
-                mTransfersCount.totalUploads++;
-                mTransfersCount.pendingUploads++;
-                mTransfersCount.totalUploadBytes += transfer->getTotalBytes();
-                mTransfersCount.completedUploadBytes += transfer->getTransferredBytes();
-
-                mLastTransfersCount.totalUploads++;
-                mLastTransfersCount.pendingUploads++;
-                mLastTransfersCount.totalUploadBytes += transfer->getTotalBytes();
-                mLastTransfersCount.completedUploadBytes += transfer->getTransferredBytes();
-            }
-            else
+            TransfersCounters::Writer counters(mCounters);
+            counters.addByType(TransfersCounters::SCOPE_ALL, fileType, TransfersCounters::TYPE_STARTED, 1);
+
+            for (auto scope : {TransfersCounters::SCOPE_ALL, TransfersCounters::SCOPE_LAST})
             {
-                mTransfersCount.totalDownloads++;
-                mTransfersCount.pendingDownloads++;
-                mTransfersCount.totalDownloadBytes += transfer->getTotalBytes();
-                mTransfersCount.completedDownloadBytes += transfer->getTransferredBytes();
-
-                mLastTransfersCount.totalDownloads++;
-                mLastTransfersCount.pendingDownloads++;
-                mLastTransfersCount.totalDownloadBytes += transfer->getTotalBytes();
-                mLastTransfersCount.completedDownloadBytes += transfer->getTransferredBytes();
+                counters.add(scope, direction, TransfersCounters::TOTAL, 1);
+                counters.add(scope, direction, TransfersCounters::PENDING, 1);
+                counters.add(scope, direction, TransfersCounters::TOTAL_BYTES, transfer->getTotalBytes());
+                counters.add(scope, direction, TransfersCounters::COMPLETED_BYTES, transfer->getTransferredBytes());
             }
         }
 
@@ -250,23 +242,11 @@ void TransferThread::onTransferStart(MegaApi *, MegaTransfer *transfer)
 
 void TransferThread::onTransferUpdate(MegaApi *, MegaTransfer *transfer)
 {
+    TraceSpan span("TransferThread::onTransferUpdate", "transfers");
     if (!transfer->isStreamingTransfer()
             && !transfer->isFolderTransfer())
     {
-        {
-            QMutexLocker counterLock(&mCountersMutex);
-            if(transfer->getType() == MegaTransfer::TYPE_UPLOAD)
-            {
-                mTransfersCount.completedUploadBytes += transfer->getDeltaSize();
-
-                mLastTransfersCount.completedUploadBytes += transfer->getDeltaSize();
-            }
-            else
-            {
-                mTransfersCount.completedDownloadBytes += transfer->getDeltaSize();
-                mLastTransfersCount.completedDownloadBytes += transfer->getDeltaSize();
-            }
-        }
+        addCompletedBytes(transfer);
 
         {
             QMutexLocker cacheLock(&mCacheMutex);
@@ -282,91 +262,53 @@ void TransferThread::onTransferUpdate(MegaApi *, MegaTransfer *transfer)
 
 void TransferThread::onTransferFinish(MegaApi*, MegaTransfer *transfer, MegaError*)
 {
+    TraceSpan span("TransferThread::onTransferFinish", "transfers");
     if (!transfer->isStreamingTransfer()
             && !transfer->isFolderTransfer())
     {
         {
-            QMutexLocker counterLock(&mCountersMutex);
-            auto fileType = Utilities::getFileType(QString::fromStdString(transfer->getFileName()), QString());
+            auto fileType = Utilities::getFileType(QString::fromStdString(transfer->getFileName()));
+            auto direction = TransfersCounters::direction(transfer->getType());
+            const auto scopes = {TransfersCounters::SCOPE_ALL, TransfersCounters::SCOPE_LAST};
+
+            TransfersCounters::Writer counters(mCounters);
             if(transfer->getState() == MegaTransfer::STATE_CANCELLED || (transfer->getState() == MegaTransfer::STATE_FAILED
                                                                          && transfer->isSyncTransfer()))
             {
-                mTransfersCount.transfersByType[fileType]--;
-
-                if(transfer->getType() == MegaTransfer::TYPE_UPLOAD)
-                {
-                    mTransfersCount.completedUploadBytes -= transfer->getTransferredBytes();
-                    mTransfersCount.totalUploadBytes -= transfer->getTotalBytes();
-                    mTransfersCount.pendingUploads--;
-                    mTransfersCount.totalUploads--;
-
-                    mLastTransfersCount.completedUploadBytes -= transfer->getTransferredBytes();
-                    mLastTransfersCount.totalUploadBytes -= transfer->getTotalBytes();
-                    mLastTransfersCount.pendingUploads--;
-                    mLastTransfersCount.totalUploads--;
-                }
-                else
-                {
-                    mTransfersCount.completedDownloadBytes -= transfer->getTransferredBytes();
-                    mTransfersCount.totalDownloadBytes -= transfer->getTotalBytes();
-                    mTransfersCount.pendingDownloads--;
-                    mTransfersCount.totalDownloads--;
-
-                    mLastTransfersCount.completedDownloadBytes -= transfer->getTransferredBytes();
-                    mLastTransfersCount.totalDownloadBytes -= transfer->getTotalBytes();
-                    mLastTransfersCount.pendingDownloads--;
-                    mLastTransfersCount.totalDownloads--;
-                }
+                counters.addByType(TransfersCounters::SCOPE_ALL, fileType, TransfersCounters::TYPE_STARTED, -1);
 
-                if(mTransfersCount.pendingTransfers() == 0)
+                for (auto scope : scopes)
                 {
-                    mLastTransfersCount.clear();
+                    counters.add(scope, direction, TransfersCounters::COMPLETED_BYTES, -transfer->getTransferredBytes());
+                    counters.add(scope, direction, TransfersCounters::TOTAL_BYTES, -transfer->getTotalBytes());
+                    counters.add(scope, direction, TransfersCounters::PENDING, -1);
+                    counters.add(scope, direction, TransfersCounters::TOTAL, -1);
                 }
             }
             else
             {
-                mTransfersCount.transfersFinishedByType[fileType]++;
-                if(transfer->getType() == MegaTransfer::TYPE_UPLOAD)
-                {
-                    mTransfersCount.pendingUploads--;
-                    mLastTransfersCount.pendingUploads--;
+                counters.addByType(TransfersCounters::SCOPE_ALL, fileType, TransfersCounters::TYPE_FINISHED, 1);
 
-                    if(transfer->getTransferredBytes() < transfer->getTotalBytes())
-                    {
-                        mTransfersCount.completedUploadBytes += transfer->getDeltaSize();
-                        mLastTransfersCount.completedUploadBytes += transfer->getDeltaSize();
-                    }
-
-                    if(transfer->getState() == MegaTransfer::STATE_FAILED && !transfer->isSyncTransfer())
-                    {
-                        mTransfersCount.failedUploads++;
-                    }
-
-                    mLastTransfersCount.completedUploadsByTag.insert(transfer->getTag());
-                }
-                else
+                for (auto scope : scopes)
                 {
-                    mTransfersCount.pendingDownloads--;
-                    mLastTransfersCount.pendingDownloads--;
-
+                    counters.add(scope, direction, TransfersCounters::PENDING, -1);
                     if(transfer->getTransferredBytes() < transfer->getTotalBytes())
                     {
-                        mTransfersCount.completedDownloadBytes += transfer->getDeltaSize();
-                        mLastTransfersCount.completedDownloadBytes += transfer->getDeltaSize();
-                    }
-
-                    if(transfer->getState() == MegaTransfer::STATE_FAILED && !transfer->isSyncTransfer())
-                    {
-                        mTransfersCount.failedDownloads++;
+                        counters.add(scope, direction, TransfersCounters::COMPLETED_BYTES, transfer->getDeltaSize());
                     }
-
-                    mLastTransfersCount.completedDownloadsByTag.insert(transfer->getTag());
                 }
 
-                if(mTransfersCount.pendingTransfers() == 0)
+                if(transfer->getState() == MegaTransfer::STATE_FAILED && !transfer->isSyncTransfer())
                 {
-                    mLastTransfersCount.clear();
+                    counters.add(TransfersCounters::SCOPE_ALL, direction, TransfersCounters::FAILED, 1);
                 }
+
+                counters.markCompleted(direction, transfer->getTag());
+            }
+
+            if(counters.pendingTransfers(TransfersCounters::SCOPE_ALL) == 0)
+            {
+                counters.clear(TransfersCounters::SCOPE_LAST);
             }
         }
 
@@ -395,22 +337,11 @@ void TransferThread::onTransferFinish(MegaApi*, MegaTransfer *transfer, MegaErro
 
 void TransferThread::onTransferTemporaryError(MegaApi*, MegaTransfer *transfer, MegaError *)
 {
+    TraceSpan span("TransferThread::onTransferTemporaryError", "transfers");
     if (!transfer->isStreamingTransfer()
             && !transfer->isFolderTransfer())
     {
-        {
-            QMutexLocker counterLock(&mCountersMutex);
-            if(transfer->getType() == MegaTransfer::TYPE_UPLOAD)
-            {
-                mTransfersCount.completedUploadBytes += transfer->getDeltaSize();
-                mLastTransfersCount.completedUploadBytes += transfer->getDeltaSize();
-            }
-            else
-            {
-                mTransfersCount.completedDownloadBytes += transfer->getDeltaSize();
-                mLastTransfersCount.completedDownloadBytes += transfer->getDeltaSize();
-            }
-        }
+        addCompletedBytes(transfer);
 
         {
             QMutexLocker cacheLock(&mCacheMutex);
@@ -426,14 +357,21 @@ void TransferThread::onTransferTemporaryError(MegaApi*, MegaTransfer *transfer,
 
 TransfersCount TransferThread::getTransfersCount()
 {
-    QMutexLocker lock(&mCountersMutex);
-    return mTransfersCount;
+    return mCounters.snapshot(TransfersCounters::SCOPE_ALL);
 }
 
-LastTransfersCount TransferThread::getLastTransfersCount()
+TransfersCount TransferThread::getLastTransfersCount()
 {
-    QMutexLocker lock(&mCountersMutex);
-    return mLastTransfersCount;
+    return mCounters.snapshot(TransfersCounters::SCOPE_LAST);
+}
+
+void TransferThread::addCompletedBytes(MegaTransfer* transfer)
+{
+    auto direction = TransfersCounters::direction(transfer->getType());
+
+    TransfersCounters::Writer counters(mCounters);
+    counters.add(TransfersCounters::SCOPE_ALL, direction, TransfersCounters::COMPLETED_BYTES, transfer->getDeltaSize());
+    counters.add(TransfersCounters::SCOPE_LAST, direction, TransfersCounters::COMPLETED_BYTES, transfer->getDeltaSize());
 }
 
 int TransfersModel::hasActiveTransfers() const
@@ -472,75 +410,50 @@ void TransfersModel::uiUnblocked()
 
 void TransferThread::resetCompletedUploads(QList<QExplicitlySharedDataPointer<TransferData>> transfersToReset)
 {
-    QMutexLocker lock(&mCountersMutex);
-
-    foreach(auto& transfer, transfersToReset)
-    {
-        if(mTransfersCount.totalUploads > 0)
-        {
-            mTransfersCount.totalUploads--;
-            mTransfersCount.completedUploadBytes -= transfer->mTotalSize;
-            mTransfersCount.totalUploadBytes -= transfer->mTotalSize;
-            mTransfersCount.transfersByType[transfer->mFileType]--;
-            mTransfersCount.transfersFinishedByType[transfer->mFileType]--;
-
-            if(transfer->isFailed() && !transfer->isSyncTransfer())
-            {
-                mTransfersCount.failedUploads--;
-                transfer->removeFailedTransfer();
-            }
-        }
-
-        if(mLastTransfersCount.completedUploadsByTag.contains(transfer->mTag))
-        {
-            mLastTransfersCount.completedUploadsByTag.remove(transfer->mTag);
-            mLastTransfersCount.totalUploads--;
-            mLastTransfersCount.completedUploadBytes -= transfer->mTotalSize;
-            mLastTransfersCount.totalUploadBytes -= transfer->mTotalSize;
-            mLastTransfersCount.transfersByType[transfer->mFileType]--;
-            mLastTransfersCount.transfersFinishedByType[transfer->mFileType]--;
-
-            if(transfer->isFailed() && !transfer->isSyncTransfer())
-            {
-                mLastTransfersCount.failedUploads--;
-            }
-        }
-    }
+    resetCompletedCounters(TransfersCounters::UPLOAD, transfersToReset);
 }
 
 void TransferThread::resetCompletedDownloads(QList<QExplicitlySharedDataPointer<TransferData>> transfersToReset)
 {
-    QMutexLocker lock(&mCountersMutex);
+    resetCompletedCounters(TransfersCounters::DOWNLOAD, transfersToReset);
+}
+
+void TransferThread::resetCompletedCounters(TransfersCounters::Direction direction,
+                                            const QList<QExplicitlySharedDataPointer<TransferData>>& transfersToReset)
+{
+    TransfersCounters::Writer counters(mCounters);
 
     foreach(auto& transfer, transfersToReset)
     {
-        if(mTransfersCount.totalDownloads > 0)
+        bool failed = transfer->isFailed() && !transfer->isSyncTransfer();
+        auto size = static_cast<long long>(transfer->mTotalSize);
+
+        if(counters.value(TransfersCounters::SCOPE_ALL, direction, TransfersCounters::TOTAL) > 0)
         {
-            mTransfersCount.totalDownloads--;
-            mTransfersCount.completedDownloadBytes -= transfer->mTotalSize;
-            mTransfersCount.totalDownloadBytes -= transfer->mTotalSize;
-            mTransfersCount.transfersByType[transfer->mFileType]--;
-            mTransfersCount.transfersFinishedByType[transfer->mFileType]--;
+            counters.add(TransfersCounters::SCOPE_ALL, direction, TransfersCounters::TOTAL, -1);
+            counters.add(TransfersCounters::SCOPE_ALL, direction, TransfersCounters::COMPLETED_BYTES, -size);
+            counters.add(TransfersCounters::SCOPE_ALL, direction, TransfersCounters::TOTAL_BYTES, -size);
+            counters.addByType(TransfersCounters::SCOPE_ALL, transfer->mFileType, TransfersCounters::TYPE_STARTED, -1);
+            counters.addByType(TransfersCounters::SCOPE_ALL, transfer->mFileType, TransfersCounters::TYPE_FINISHED, -1);
 
-            if(transfer->isFailed() && !transfer->isSyncTransfer())
+            if(failed)
             {
-                mTransfersCount.failedDownloads--;
+                counters.add(TransfersCounters::SCOPE_ALL, direction, TransfersCounters::FAILED, -1);
                 transfer->removeFailedTransfer();
             }
         }
 
-        if(mLastTransfersCount.completedDownloadsByTag.contains(transfer->mTag))
+        if(counters.unmarkCompleted(direction, transfer->mTag))
         {
-            mLastTransfersCount.completedDownloadsByTag.remove(transfer->mTag);
-            mLastTransfersCount.totalDownloads--;
-            mLastTransfersCount.completedDownloadBytes -= transfer->mTotalSize;
-            mLastTransfersCount.totalDownloadBytes -= transfer->mTotalSize;
-            mLastTransfersCount.transfersByType[transfer->mFileType]--;
-            mLastTransfersCount.transfersFinishedByType[transfer->mFileType]--;
+            counters.add(TransfersCounters::SCOPE_LAST, direction, TransfersCounters::TOTAL, -1);
+            counters.add(TransfersCounters::SCOPE_LAST, direction, TransfersCounters::COMPLETED_BYTES, -size);
+            counters.add(TransfersCounters::SCOPE_LAST, direction, TransfersCounters::TOTAL_BYTES, -size);
+            counters.addByType(TransfersCounters::SCOPE_LAST, transfer->mFileType, TransfersCounters::TYPE_STARTED, -1);
+            counters.addByType(TransfersCounters::SCOPE_LAST, transfer->mFileType, TransfersCounters::TYPE_FINISHED, -1);
 
-            if(transfer->isFailed() && !transfer->isSyncTransfer())
+            if(failed)
             {
-                mLastTransfersCount.failedDownloads--;
+                counters.add(TransfersCounters::SCOPE_LAST, direction, TransfersCounters::FAILED, -1);
             }
         }
     }
@@ -558,17 +471,20 @@ const int RESET_AFTER_EMPTY_RECEIVES = 10;
 const int MODEL_HAS_CHANGED_AFTER_EMPTY_RECEIVES = 5;
 
 TransfersModel::TransfersModel(QObject *parent) :
+    TransfersModel(MegaSyncApp->getMegaApi(), parent)
+{
+}
+
+TransfersModel::TransfersModel(MegaApi* megaApi, QObject *parent) :
     QAbstractItemModel (parent),
-    mMegaApi (MegaSyncApp->getMegaApi()),
+    mMegaApi (megaApi),
     mPreferences (Preferences::instance()),
     mTransfersProcessChanged(0),
     mUpdateMostPriorityTransfer(0),
     mUiBlockedCounter(0),
     mUiBlockedByCounter(0),
     mCancelledFrom(nullptr),
-    mSyncsInRowsToCancel(false),
-    mIgnoreMoveSignal(false),
-    mInverseMoveSignal(false)
+    mSyncsInRowsToCancel(false)
 {
     qRegisterMetaType<QList<QPersistentModelIndex>>("QList<QPersistentModelIndex>");
     qRegisterMetaType<QAbstractItemModel::LayoutChangeHint>("QAbstractItemModel::LayoutChangeHint");
@@ -585,6 +501,11 @@ TransfersModel::TransfersModel(QObject *parent) :
     mDelegateListener->moveToThread(mTransferEventThread);
     mMegaApi->addTransferListener(mDelegateListener);
 
+    mBulkAction = new TransfersBulkAction(this, mMegaApi);
+    connect(mBulkAction, &TransfersBulkAction::finished, this, &TransfersModel::onBulkActionFinished);
+
+    mLinksResolver = new TransferLinksResolver(mMegaApi, this);
+
     //Update transfers state for the first time
     updateTransfersCount();
 
@@ -690,6 +611,7 @@ QModelIndex TransfersModel::index(int row, int column, const QModelIndex&) const
 
 void TransfersModel::onProcessTransfers()
 {
+    TraceSpan span("TransfersModel::onProcessTransfers", "transfers");
     if(mTransfersToProcess.isEmpty())
     {
         mTransfersToProcess = mTransferEventWorker->processTransfers();
@@ -1006,53 +928,7 @@ void TransfersModel::getLinks(QList<int>& rows)
 {
     if (!rows.isEmpty())
     {
-        QList<MegaHandle> exportList;
-        QStringList linkList;
-
-        QMutexLocker lock(&mModelMutex);
-
-        for (auto row : rows)
-        {
-            auto d (getTransfer(row));
-
-            MegaNode *node (nullptr);
-
-            if (d->getState() == TransferData::TRANSFER_FAILED)
-            {
-                auto transfer = mMegaApi->getTransferByTag(d->mTag);
-                if(transfer)
-                {
-                    node = transfer->getPublicMegaNode();
-                }
-            }
-            else if(d->mNodeHandle)
-            {
-                node = ((MegaApplication*)qApp)->getMegaApi()->getNodeByHandle(d->mNodeHandle);
-            }
-
-            if (!node || !node->isPublic())
-            {
-                exportList.push_back(d->mNodeHandle);
-            }
-            else if (node)
-            {
-                char *handle = node->getBase64Handle();
-                char *key = node->getBase64Key();
-                if (handle && key)
-                {
-                    QString link = Preferences::BASE_URL + QString::fromUtf8("/#!%1!%2")
-                            .arg(QString::fromUtf8(handle), QString::fromUtf8(key));
-                    linkList.push_back(link);
-                }
-                delete [] key;
-                delete [] handle;
-                delete node;
-            }
-        }
-        if (exportList.size() || linkList.size())
-        {
-            qobject_cast<MegaApplication*>(qApp)->exportNodes(exportList, linkList);
-        }
+        mLinksResolver->copyLinks(getLinkRequests(rows));
     }
 }
 
@@ -1060,42 +936,32 @@ void TransfersModel::openInMEGA(QList<int> &rows)
 {
     if (!rows.isEmpty())
     {
-        QMutexLocker lock(&mModelMutex);
-
-        for (auto row : rows)
-        {
-            auto d (getTransfer(row));
+        mLinksResolver->openInMEGA(getLinkRequests(rows));
+    }
+}
 
-            MegaNode *node (nullptr);
+QList<TransferLinksResolver::Request> TransfersModel::getLinkRequests(const QList<int>& rows) const
+{
+    QList<TransferLinksResolver::Request> requests;
+    requests.reserve(rows.size());
 
-            if (d->getState() == TransferData::TRANSFER_FAILED)
-            {
-                auto transfer = mMegaApi->getTransferByTag(d->mTag);
-                if(transfer)
-                {
-                    node = transfer->getPublicMegaNode();
-                }
-            }
-            else if(d->mNodeHandle)
-            {
-                node = ((MegaApplication*)qApp)->getMegaApi()->getNodeByHandle(d->mNodeHandle);
-            }
+    QMutexLocker lock(&mModelMutex);
 
-            if (node)
-            {
-                char *handle = node->getBase64Handle();
-                char *key = node->getBase64Key();
-                if (handle && key)
-                {
-                    QString url = QString::fromUtf8("mega://#fm/") + QString::fromUtf8(handle);
-                    Utilities::openUrl(QUrl(url));
-                }
-                delete [] key;
-                delete [] handle;
-                delete node;
-            }
+    for (auto row : rows)
+    {
+        auto d (getTransfer(row));
+        if(d)
+        {
+            TransferLinksResolver::Request request;
+            request.tag = d->mTag;
+            request.nodeHandle = d->mNodeHandle;
+            request.failed = d->getState() == TransferData::TRANSFER_FAILED;
+            request.completed = d->getState() == TransferData::TRANSFER_COMPLETED;
+            requests.append(request);
         }
     }
+
+    return requests;
 }
 
 void TransfersModel::openFolderByIndex(const QModelIndex& index)
@@ -1152,69 +1018,27 @@ void TransfersModel::retryTransferByIndex(const QModelIndex& index)
     }
 }
 
-void TransfersModel::retryTransfers(QModelIndexList indexes)
+void TransfersModel::retryTransfers(const TransferTagSet& tags)
 {
-    if(indexes.size() > FAILED_THRESHOLD_THREAD)
-    {
-        setUiBlockedMode(true);
-    }
-
-    std::sort(indexes.begin(), indexes.end(),[](QModelIndex index1, QModelIndex index2){
-        return index1.row() > index2.row();
-    });
-
-    //Try to add more threads to speed up
-    auto threadsToUse(1);
-
-    auto availableThreads = QThreadPool::globalInstance()->maxThreadCount() - QThreadPool::globalInstance()->activeThreadCount();
-    if(availableThreads > 2)
-    {
-        threadsToUse = availableThreads / 2;
-    }
-
-    QList<mega::MegaTransfer*> transfersToRetry;
-    auto indexPerThread = (indexes.size() >= threadsToUse) ? (indexes.size() / threadsToUse) : indexes.size();
+    QList<std::shared_ptr<MegaTransfer>> transfersToRetry;
+    QModelIndexList indexesToClear;
 
     mModelMutex.lock();
-
-    auto counter = 0;
-    foreach(auto index, indexes)
+    for (auto tag : tags)
     {
-        const auto transferItem (
-                    qvariant_cast<TransferItem>(index.data(Qt::DisplayRole)));
-        auto d (transferItem.getTransferData());
+        auto row (getRowByTransferTag(tag));
+        auto d (getTransfer(row));
 
         if(d && d->mFailedTransfer)
         {
-            transfersToRetry.append(d->mFailedTransfer->copy());
-        }
-
-        if(counter % indexPerThread == 0)
-        {
-            QtConcurrent::run([transfersToRetry, this](){
-                foreach(auto& failedTransferCopy, transfersToRetry)
-                {
-                    mMegaApi->retryTransfer(failedTransferCopy);
-                    delete failedTransferCopy;
-                }
-            });
-
-            transfersToRetry.clear();
+            transfersToRetry.append(std::shared_ptr<MegaTransfer>(d->mFailedTransfer->copy()));
+            indexesToClear.append(index(row, 0));
         }
-        counter++;
     }
-
     mModelMutex.unlock();
 
-    QtConcurrent::run([transfersToRetry, this](){
-        foreach(auto& failedTransferCopy, transfersToRetry)
-        {
-            mMegaApi->retryTransfer(failedTransferCopy);
-            delete failedTransferCopy;
-        }
-    });
-
-    clearFailedTransfers(indexes);
+    clearFailedTransfers(indexesToClear);
+    mBulkAction->start(transfersToRetry);
 }
 
 void TransfersModel::openFolderByTag(TransferTag tag)
@@ -1258,9 +1082,9 @@ void TransfersModel::cancelAllTransfers(QWidget* canceledFrom)
     mMegaApi->cancelTransfers(MegaTransfer::TYPE_DOWNLOAD);
 }
 
-void TransfersModel::cancelAndClearTransfers(const QModelIndexList& indexes, QWidget* canceledFrom)
+void TransfersModel::cancelAndClearTransfers(const TransferTagSet& tags, QWidget* canceledFrom)
 {
-    if(indexes.isEmpty())
+    if(tags.empty())
     {
         return;
     }
@@ -1268,13 +1092,14 @@ void TransfersModel::cancelAndClearTransfers(const QModelIndexList& indexes, QWi
     QMap<QModelIndex, QExplicitlySharedDataPointer<TransferData>> uploadToClear;
     QMap<QModelIndex, QExplicitlySharedDataPointer<TransferData>> downloadToClear;
 
-    QList<TransferTag> toCancel;
+    TransferTagSet toCancel;
 
     // First clear finished transfers (remove rows), then cancel the others.
     // This way, there is no risk of messing up the rows order with cancel requests.
     mModelMutex.lock();
-    for (auto index : indexes)
+    for (auto tag : tags)
     {
+        auto index (this->index(getRowByTransferTag(tag), 0));
         auto d (getTransfer(index.row()));
 
         // Clear (remove rows of) finished transfers
@@ -1304,7 +1129,7 @@ void TransfersModel::cancelAndClearTransfers(const QModelIndexList& indexes, QWi
             }
             else
             {
-                toCancel.append(d->mTag);
+                toCancel.push_back(d->mTag);
             }
         }
     }
@@ -1315,22 +1140,8 @@ void TransfersModel::cancelAndClearTransfers(const QModelIndexList& indexes, QWi
         clearTransfers(uploadToClear, downloadToClear);
     }
 
-    if(!toCancel.isEmpty())
-    {
-        auto counter(0);
-        // Now cancel transfers
-        for (auto item : toCancel)
-        {
-            mMegaApi->cancelTransferByTag(item);
-
-            //This is done to avoid GUI freezes
-            if(++counter == 100)
-            {
-                counter = 0;
-                MegaSyncApp->processEvents();
-            }
-        }
-    }
+    // Now cancel transfers
+    mBulkAction->start(TransfersBulkAction::CANCEL, std::move(toCancel));
 }
 
 void TransfersModel::showSyncCancelledWarning()
@@ -1425,9 +1236,9 @@ void TransfersModel::clearAllTransfers()
     clearTransfers(uploadToClear, downloadToClear);
 }
 
-void TransfersModel::clearTransfers(const QModelIndexList& indexes)
+void TransfersModel::clearTransfers(const TransferTagSet& tags)
 {   
-    if(indexes.isEmpty())
+    if(tags.empty())
     {
         return;
     }
@@ -1435,9 +1246,9 @@ void TransfersModel::clearTransfers(const QModelIndexList& indexes)
     QMap<QModelIndex, QExplicitlySharedDataPointer<TransferData>> uploadToClear;
     QMap<QModelIndex, QExplicitlySharedDataPointer<TransferData>> downloadToClear;
 
-    for (auto indexToCheck : indexes)
+    for (auto tag : tags)
     {
-        classifyUploadOrDownloadCompletedTransfers(uploadToClear, downloadToClear,indexToCheck);
+        classifyUploadOrDownloadCompletedTransfers(uploadToClear, downloadToClear, index(getRowByTransferTag(tag), 0));
     }
 
     clearTransfers(uploadToClear, downloadToClear);
@@ -1535,55 +1346,62 @@ void TransfersModel::performClearTransfers(const QMap<QModelIndex, QExplicitlySh
     emit transfersProcessChanged();
 }
 
-void TransfersModel::pauseTransfers(const QModelIndexList& indexes, bool pauseState)
+void TransfersModel::pauseTransfers(const TransferTagSet& tags, bool pauseState)
 {
-    if(!indexes.isEmpty())
+    if(!tags.empty())
     {
-        setUiBlockedModeByCounter(indexes.size());
-
-        if(indexes.size() > PAUSE_RESUME_THRESHOLD_THREAD)
-        {
-            QtConcurrent::run([this, indexes, pauseState]()
-            {
-                blockModelSignals(true);
-                performPauseResumeVisibleTransfers(indexes, pauseState, false);
-                blockModelSignals(false);
-
-                emit pauseStateChanged(mAreAllPaused);
-            });
-        }
-        else
-        {
-            performPauseResumeVisibleTransfers(indexes, pauseState, true);
-        }
+        setUiBlockedModeByCounter(static_cast<uint32_t>(tags.size()));
+        mBulkAction->start(pauseState ? TransfersBulkAction::PAUSE : TransfersBulkAction::RESUME, tags);
     }
 }
 
-int TransfersModel::performPauseResumeVisibleTransfers(const QModelIndexList& indexes, bool pauseState, bool useEventUpdater)
+QList<TransferTag> TransfersModel::pauseResumeTransfersByTag(TransferTagSet::const_iterator first,
+                                                             TransferTagSet::const_iterator last, bool pauseState)
 {
-    EventUpdater updater(indexes.size(), 1000);
-    auto tagsUpdated(0);
+    QList<TransferTag> tagsToSend;
+    auto firstRow (std::numeric_limits<int>::max());
+    auto lastRow (-1);
 
-    QMutexLocker lock(&mModelMutex);
-
-    for (auto index : indexes)
+    mModelMutex.lock();
+    for (auto it = first; it != last; ++it)
     {
-        auto d = getTransfer(index.row());
-        if((pauseState && d->getState() & TransferData::PAUSABLE_STATES_MASK)
-                || (!pauseState && d->getState() & TransferData::TRANSFER_PAUSED))
+        auto row (getRowByTransferTag(*it));
+        auto d  = getTransfer(row);
+        if(d && ((pauseState && d->getState() & TransferData::PAUSABLE_STATES_MASK)
+                 || (!pauseState && d->getState() & TransferData::TRANSFER_PAUSED)))
         {
-            pauseResumeTransferByTag(d->mTag, pauseState);
+            d->setPauseResume(pauseState);
+            d->resetStateHasChanged();
+            tagsToSend.append(d->mTag);
+
+            firstRow = std::min(firstRow, row);
+            lastRow = std::max(lastRow, row);
         }
+    }
+    mModelMutex.unlock();
 
-        tagsUpdated++;
+    if(!tagsToSend.isEmpty() && !pauseState && mAreAllPaused)
+    {
+        mMegaApi->pauseTransfers(false);
+        mAreAllPaused = false;
+        emit pauseStateChangedByTransferResume();
+    }
 
-        if(useEventUpdater)
-        {
-            updater.update(tagsUpdated);
-        }
+    // One signal for the whole chunk
+    if(lastRow >= 0 && !signalsBlocked())
+    {
+        emit dataChanged(index(firstRow, 0, DEFAULT_IDX), index(lastRow, 0, DEFAULT_IDX));
     }
 
-    return tagsUpdated;
+    return tagsToSend;
+}
+
+void TransfersModel::onBulkActionFinished(int action)
+{
+    if(action == TransfersBulkAction::PAUSE || action == TransfersBulkAction::RESUME)
+    {
+        emit pauseStateChanged(mAreAllPaused);
+    }
 }
 
 void TransfersModel::blockModelSignals(bool state)
@@ -1726,12 +1544,12 @@ void TransfersModel::lockModelMutex(bool lock)
 
 long long TransfersModel::getNumberOfTransfersForFileType(Utilities::FileType fileType) const
 {
-    return mTransfersCount.transfersByType.value(fileType);
+    return mTransfersCount.getTransfersByType(fileType);
 }
 
 long long TransfersModel::getNumberOfFinishedForFileType(Utilities::FileType fileType) const
 {
-    return mTransfersCount.transfersFinishedByType.value(fileType);
+    return mTransfersCount.getFinishedByType(fileType);
 }
 
 TransfersCount TransfersModel::getTransfersCount()
@@ -1815,6 +1633,26 @@ void TransfersModel::addTransfer(QExplicitlySharedDataPointer<TransferData> tran
     mTagByOrder.insert(transfer->mTag, QPersistentModelIndex(index(rowCount(DEFAULT_IDX) - 1,0)));
 }
 
+TransferTagSet TransfersModel::getTransferTags(const QVector<int>& rows, TransferData::TransferStates states) const
+{
+    TransferTagSet tags;
+    tags.reserve(static_cast<size_t>(rows.size()));
+
+    QMutexLocker lock(&mModelMutex);
+    for (auto row : rows)
+    {
+        auto d (getTransfer(row));
+        if(d && (states == TransferData::TRANSFER_NONE || d->getState() & states))
+        {
+            tags.push_back(d->mTag);
+        }
+    }
+    lock.unlock();
+
+    sortTransferTagSet(tags);
+    return tags;
+}
+
 QExplicitlySharedDataPointer<TransferData> TransfersModel::getTransferByTag(int tag) const
 {
     return getTransfer(getRowByTransferTag(tag));
@@ -1997,9 +1835,9 @@ void TransfersModel::askForMostPriorityTransfer()
 {
     auto task = QtConcurrent::run([this]()
     {
-        std::unique_ptr<MegaTransfer> nextUTransfer(MegaSyncApp->getMegaApi()->getFirstTransfer(MegaTransfer::TYPE_UPLOAD));
+        std::unique_ptr<MegaTransfer> nextUTransfer(mMegaApi->getFirstTransfer(MegaTransfer::TYPE_UPLOAD));
         auto UTag = nextUTransfer ? nextUTransfer->getTag() : -1;
-        std::unique_ptr<MegaTransfer> nextDTransfer(MegaSyncApp->getMegaApi()->getFirstTransfer(MegaTransfer::TYPE_DOWNLOAD));
+        std::unique_ptr<MegaTransfer> nextDTransfer(mMegaApi->getFirstTransfer(MegaTransfer::TYPE_DOWNLOAD));
         auto DTag = nextDTransfer ? nextDTransfer->getTag() : -1;
 
         return qMakePair(UTag, DTag);
@@ -2040,94 +1878,119 @@ bool TransfersModel::moveRows(const QModelIndex &sourceParent, int sourceRow, in
     return QAbstractItemModel::moveRows(sourceParent, sourceRow, count, destinationParent, destinationChild);
 }
 
-void TransfersModel::ignoreMoveRowsSignal(bool state)
+void TransfersModel::moveTransfers(const QList<TransferTag>& tags, TransferTag target)
 {
-    mIgnoreMoveSignal = state;
+    moveTransfers(tags, target, tags);
 }
 
-void TransfersModel::inverseMoveRowsSignal(bool state)
+void TransfersModel::moveTransfers(const QList<TransferTag>& tags, TransferTag target,
+                                   const QList<TransferTag>& tagsToSelect)
 {
-    mInverseMoveSignal = state;
-}
+    std::vector<TransferTag> tagsToMove;
+    auto firstRow (std::numeric_limits<int>::max());
+    auto lastRow (-1);
 
-bool TransfersModel::moveTransferPriority(const QModelIndex &sourceParent, const QList<int>& rows,
-                              const QModelIndex &destinationParent, int destinationChild)
-{
-    bool result(false);
+    mModelMutex.lock();
 
-    if(!rows.isEmpty())
+    auto targetData (target >= 0 ? getTransferByTag(target) : QExplicitlySharedDataPointer<TransferData>());
+    if(target >= 0 && (!targetData || targetData->isFinished()))
     {
-        foreach(auto sourceRow, rows)
+        mModelMutex.unlock();
+        return;
+    }
+
+    QSet<TransferTag> movedTags;
+    for (auto tag : tags)
+    {
+        auto d (getTransferByTag(tag));
+        if(d && !d->isFinished() && tag != target && !movedTags.contains(tag))
         {
-            //TODO MOVE TO TOP THE SECOND ITEM
-            int lastRow (sourceRow);
+            movedTags.insert(tag);
+            tagsToMove.push_back(tag);
+        }
+    }
 
-            if (sourceParent == destinationParent
-                    && (destinationChild < sourceRow || destinationChild > lastRow))
+    if(!tagsToMove.empty())
+    {
+        // Neighbours of the block among the transfers that stay, by priority
+        const auto keysNeeded (static_cast<unsigned long long>(tagsToMove.size()) + 1);
+        unsigned long long lower (0);
+        unsigned long long upper (std::numeric_limits<unsigned long long>::max());
+        bool hasLower (false);
+        bool hasUpper (false);
+
+        if(targetData)
+        {
+            upper = targetData->mPriority;
+            hasUpper = true;
+        }
+
+        for (const auto& d : qAsConst(mTransfers))
+        {
+            if(d->isFinished() || movedTags.contains(d->mTag))
             {
-                // To keep order, do from first to last if destination is before first,
-                // and from last to first if destination is after last.
-                bool ascending (destinationChild < sourceRow ? false : true);
+                continue;
+            }
 
-                QList<TransferTag> tagsToMove;
+            if(target == TransfersBulkAction::MOVE_TO_TOP)
+            {
+                upper = std::min(upper, d->mPriority);
+                hasUpper = true;
+            }
+            else if(target == TransfersBulkAction::MOVE_TO_BOTTOM || d->mPriority < upper)
+            {
+                lower = std::max(lower, d->mPriority);
+                hasLower = true;
+            }
+        }
 
-                QMutexLocker lock(&mModelMutex);
+        if(hasLower && !hasUpper)
+        {
+            upper = lower + std::min(std::numeric_limits<unsigned long long>::max() - lower, keysNeeded * PRIORITY_STEP);
+        }
+        else if(hasUpper && !hasLower)
+        {
+            lower = upper - std::min(upper, keysNeeded * PRIORITY_STEP);
+        }
 
-                for (auto row (sourceRow); row <= lastRow; ++row)
-                {
-                    auto tag(getTransfer(row)->mTag);
+        // The block gets evenly spread keys between its neighbours, so the proxy shows it in its new place
+        // before the SDK confirms the move. If there is no room left, the SDK updates reorder the rows.
+        const auto step ((upper - lower) / keysNeeded);
+        if((hasLower || hasUpper) && step > 0)
+        {
+            auto key (lower);
+            for (auto tag : tagsToMove)
+            {
+                key += step;
 
-                    if(tag)
-                    {
-                        if (ascending)
-                        {
-                            tagsToMove.push_back(tag);
-                        }
-                        else
-                        {
-                            tagsToMove.push_front(tag);
-                        }
-                    }
-                }
+                auto row (getRowByTransferTag(tag));
+                getTransfer(row)->mPriority = key;
 
-                for (auto tag : tagsToMove)
-                {
-                    if(destinationChild == -1)
-                    {
-                        mMegaApi->moveTransferToFirstByTag(tag);
-                    }
-                    else if (destinationChild == -2)
-                    {
-                        mMegaApi->moveTransferToLastByTag(tag);
-                    }
-                    else
-                    {
-                        // Get target
-                        auto target (getTransfer(destinationChild));
+                firstRow = std::min(firstRow, row);
+                lastRow = std::max(lastRow, row);
+            }
+        }
+    }
 
-                        if(target)
-                        {
-                            mMegaApi->moveTransferBeforeByTag(tag, target->mTag);
+    mModelMutex.unlock();
 
-                            if(!mIgnoreMoveSignal && mInverseMoveSignal)
-                            {
-                                emit rowsAboutToBeMoved(target->mTag);
-                            }
-                        }
-                    }
+    if(tagsToMove.empty())
+    {
+        return;
+    }
 
-                    if(!mIgnoreMoveSignal && !mInverseMoveSignal)
-                    {  
-                        emit rowsAboutToBeMoved(tag);
-                    }
-                }
+    // One signal for the whole block
+    if(lastRow >= 0 && !signalsBlocked())
+    {
+        emit dataChanged(index(firstRow, 0, DEFAULT_IDX), index(lastRow, 0, DEFAULT_IDX));
+    }
 
-                result = true;
-            }
-        }
+    if(!tagsToSelect.isEmpty())
+    {
+        emit rowsAboutToBeMoved(tagsToSelect);
     }
 
-    return result;
+    mBulkAction->startMove(std::move(tagsToMove), target);
 }
 
 void TransfersModel::resetModel()
@@ -2144,6 +2007,7 @@ void TransfersModel::resetModel()
     mUpdateMostPriorityTransfer = 0;
     mUiBlockedCounter = 0;
     mTagByOrder.clear();
+    mLinksResolver->clearCache();
 
     endResetModel();
 }
@@ -2207,30 +2071,34 @@ bool TransfersModel::dropMimeData(const QMimeData* data, Qt::DropAction action,
                                   int column, const QModelIndex& parent)
 {
     Q_UNUSED(column)
+    Q_UNUSED(parent)
 
     if (destRow >= 0 && destRow <= rowCount(DEFAULT_IDX) && action == Qt::MoveAction)
     {
-        QList<int> rows = getDragAndDropRows(data);
-
-        moveTransferPriority(parent, rows, parent, destRow);
+        TransferTag target (TransfersBulkAction::MOVE_TO_BOTTOM);
+        if (destRow < rowCount(DEFAULT_IDX))
+        {
+            auto destTransfer (getTransfer(destRow));
+            // The row may have been removed while the drag was running
+            if (!destTransfer)
+            {
+                return false;
+            }
+            target = destTransfer->mTag;
+        }
+        moveTransfers(getDragAndDropTags(data), target);
     }
 
     // Return false to avoid row deletion...dirty!
     return false;
 }
 
-QList<int> TransfersModel::getDragAndDropRows(const QMimeData *data)
+QList<TransferTag> TransfersModel::getDragAndDropTags(const QMimeData *data)
 {
     QByteArray byteArray (data->data(QString::fromUtf8("application/x-qabstractitemmodeldatalist")));
     QDataStream stream (&byteArray, QIODevice::ReadOnly);
     QList<TransferTag> tags;
     stream >> tags;
 
-    QList<int> rows;
-    for (auto tag : qAsConst(tags))
-    {
-        rows.push_back(getRowByTransferTag(tag));
-    }
-
-    return rows;
+    return tags;
 }
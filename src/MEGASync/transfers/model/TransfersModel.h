@@ -4,6 +4,9 @@
 #include "QTMegaTransferListener.h"
 #include "TransferItem.h"
 #include "TransferRemainingTime.h"
+#include "TransfersBulkAction.h"
+#include "TransfersCounters.h"
+#include "TransferLinksResolver.h"
 #include "control/Preferences.h"
 
 #include <megaapi.h>
@@ -16,76 +19,6 @@
 
 #include <set>
 
-struct TransfersCount
-{
-    int totalUploads;
-    int totalDownloads;
-
-    int pendingUploads;
-    int pendingDownloads;
-
-    int failedUploads;
-    int failedDownloads;
-
-    long long completedUploadBytes;
-    long long completedDownloadBytes;
-
-    long long totalUploadBytes;
-    long long totalDownloadBytes;
-
-    QMap<Utilities::FileType, long long> transfersByType;
-    QMap<Utilities::FileType, long long> transfersFinishedByType;
-
-    TransfersCount():
-        totalUploads(0),
-        totalDownloads(0),
-        pendingUploads(0),
-        pendingDownloads(0),
-        failedUploads(0),
-        failedDownloads(0),
-        completedUploadBytes(0),
-        completedDownloadBytes(0),
-        totalUploadBytes(0),
-        totalDownloadBytes(0)
-    {}
-
-    int completedDownloads()const {return totalDownloads - pendingDownloads - failedDownloads;}
-    int completedUploads() const {return totalUploads - pendingUploads - failedUploads;}
-    int pendingTransfers() const {return pendingDownloads + pendingUploads;}
-
-    long long totalFailedTransfers() const {return failedUploads + failedDownloads;}
-
-    void clear()
-    {
-        totalUploads = 0;
-        totalDownloads = 0;
-        pendingUploads = 0;
-        pendingDownloads = 0;
-        failedUploads = 0;
-        failedDownloads = 0;
-        completedUploadBytes = 0;
-        completedDownloadBytes = 0;
-        totalUploadBytes = 0;
-        totalDownloadBytes = 0;
-        transfersByType.clear();
-        transfersFinishedByType.clear();
-    }
-};
-
-struct LastTransfersCount : public TransfersCount
-{
-    QSet<int> completedUploadsByTag;
-    QSet<int> completedDownloadsByTag;
-
-    void clear()
-    {
-        TransfersCount::clear();
-        completedUploadsByTag.clear();
-        completedDownloadsByTag.clear();
-    }
-
-};
-
 class TransferThread :  public QObject,public mega::MegaTransferListener
 {
     Q_OBJECT
@@ -117,7 +50,7 @@ public:
     ~TransferThread(){}
 
     TransfersCount getTransfersCount();
-    LastTransfersCount getLastTransfersCount();
+    TransfersCount getLastTransfersCount();
 
     void resetCompletedUploads(QList<QExplicitlySharedDataPointer<TransferData> > transfersToReset);
     void resetCompletedDownloads(QList<QExplicitlySharedDataPointer<TransferData>> transfersToReset);
@@ -141,6 +74,9 @@ private:
     bool checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, mega::MegaTransfer *transfer);
     bool checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, mega::MegaTransfer *transfer);
     bool checkIfRepeatedAndSubstituteInStartTransfers(mega::MegaTransfer *transfer);
+    void addCompletedBytes(mega::MegaTransfer* transfer);
+    void resetCompletedCounters(TransfersCounters::Direction direction,
+                                const QList<QExplicitlySharedDataPointer<TransferData>>& transfersToReset);
 
     struct cacheTransfers
     {
@@ -162,9 +98,7 @@ private:
 
     cacheTransfers mTransfersToProcess;
     QMutex mCacheMutex;
-    QMutex mCountersMutex;
-    TransfersCount mTransfersCount;
-    LastTransfersCount mLastTransfersCount;
+    TransfersCounters mCounters;
     std::atomic<int16_t> mMaxTransfersToProcess;
 };
 
@@ -175,6 +109,8 @@ class TransfersModel : public QAbstractItemModel
 
 public:
     explicit TransfersModel(QObject* parent = 0);
+    // The transfer events are received from megaApi (tests use a fake one)
+    TransfersModel(mega::MegaApi* megaApi, QObject* parent);
     ~TransfersModel();
 
     virtual Qt::ItemFlags flags(const QModelIndex& index) const;
@@ -192,23 +128,30 @@ public:
     bool moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
                   const QModelIndex &destinationParent, int destinationChild) override;
 
-    void ignoreMoveRowsSignal(bool state);
-    void inverseMoveRowsSignal(bool state);
-    bool moveTransferPriority(const QModelIndex& sourceParent, const QList<int>& rows,
-                  const QModelIndex& destinationParent, int destinationChild);
+    // Moves the transfers, keeping the given order, before the transfer tagged target
+    // or to a TransfersBulkAction::MoveDestination. The rows are reordered at once and the
+    // SDK requests are sent in the background.
+    void moveTransfers(const QList<TransferTag>& tags, TransferTag target);
+    // Same, but the transfers selected in the views afterwards are tagsToSelect
+    void moveTransfers(const QList<TransferTag>& tags, TransferTag target,
+                       const QList<TransferTag>& tagsToSelect);
 
     void resetModel();
 
+    // The nodes are resolved in the background, the links are copied or opened when ready
     void getLinks(QList<int>& rows);
     void openInMEGA(QList<int>& rows);
     void openFolderByIndex(const QModelIndex& index);
     void openFolderByTag(TransferTag tag);
     void retryTransferByIndex(const QModelIndex& index);
-    void retryTransfers(QModelIndexList indexes);
-    void cancelAndClearTransfers(const QModelIndexList& indexes, QWidget *canceledFrom);
+    // Tags of the transfers in rows (in the given states), for the bulk actions below
+    TransferTagSet getTransferTags(const QVector<int>& rows,
+                                   TransferData::TransferStates states = TransferData::TRANSFER_NONE) const;
+    void retryTransfers(const TransferTagSet& tags);
+    void cancelAndClearTransfers(const TransferTagSet& tags, QWidget *canceledFrom);
     void cancelAllTransfers(QWidget *canceledFrom);
     void clearAllTransfers();
-    void clearTransfers(const QModelIndexList& indexes);
+    void clearTransfers(const TransferTagSet& tags);
     void clearFailedTransfers(const QModelIndexList& indexes);
     void clearTransfers(const QMap<QModelIndex,QExplicitlySharedDataPointer<TransferData>> uploads,
                         const QMap<QModelIndex,QExplicitlySharedDataPointer<TransferData>> downloads);
@@ -220,8 +163,11 @@ public:
     void classifyUploadOrDownloadFailedTransfers(QMap<QModelIndex, QExplicitlySharedDataPointer<TransferData> > &uploads,
                         QMap<QModelIndex, QExplicitlySharedDataPointer<TransferData> > &downloads,
                                            const QModelIndex &index);
-    void pauseTransfers(const QModelIndexList& indexes, bool pauseState);
+    void pauseTransfers(const TransferTagSet& tags, bool pauseState);
     void pauseResumeTransferByTag(TransferTag tag, bool pauseState);
+    // Updates the model for a chunk of a bulk pause or resume, returns the tags to send to the SDK
+    QList<TransferTag> pauseResumeTransfersByTag(TransferTagSet::const_iterator first, TransferTagSet::const_iterator last,
+                                                 bool pauseState);
     void pauseResumeTransferByIndex(const QModelIndex& index, bool pauseState);
 
     void lockModelMutex(bool lock);
@@ -257,7 +203,7 @@ public:
     void resetSyncInRowsToCancel();
     void showSyncCancelledWarning();
 
-    QList<int> getDragAndDropRows(const QMimeData* data);
+    QList<TransferTag> getDragAndDropTags(const QMimeData* data);
 
 signals:
     void pauseStateChanged(bool pauseState);
@@ -276,7 +222,7 @@ signals:
     void transfersProcessChanged();
     void showInFolderFinished(bool);
     void activeTransfersChanged();
-    void rowsAboutToBeMoved(TransferTag firstRowTag);
+    void rowsAboutToBeMoved(const QList<TransferTag>& tags);
 
 public slots:
     void pauseResumeAllTransfers(bool state);
@@ -294,6 +240,7 @@ private slots:
     void onClearTransfersFinished();
     void onAskForMostPriorityTransfersFinished();
     void onKeepPCAwake();
+    void onBulkActionFinished(int action);
 
 private:
     void removeRows(QModelIndexList &indexesToRemove);
@@ -315,7 +262,8 @@ private:
     void mostPriorityTransferMayChanged(bool state);
 
     int performPauseResumeAllTransfers(int activeTransfers, bool useEventUpdater);
-    int performPauseResumeVisibleTransfers(const QModelIndexList& indexes, bool pauseState, bool useEventUpdater);
+
+    QList<TransferLinksResolver::Request> getLinkRequests(const QList<int>& rows) const;
 
 private:
     mega::MegaApi* mMegaApi;
@@ -323,9 +271,11 @@ private:
     QThread* mTransferEventThread;
     TransferThread* mTransferEventWorker;
     mega::QTMegaTransferListener *mDelegateListener;
+    TransfersBulkAction* mBulkAction;
+    TransferLinksResolver* mLinksResolver;
     QTimer mProcessTransfersTimer;
     TransfersCount mTransfersCount;
-    LastTransfersCount mLastTransfersCount;
+    TransfersCount mLastTransfersCount;
 
     QList<QExplicitlySharedDataPointer<TransferData>> mTransfers;
 
@@ -353,9 +303,6 @@ private:
     bool mAreAllPaused;
     bool mHasActiveTransfers;
     QSet<TransferTag> mActiveTransfers;
-
-    bool mIgnoreMoveSignal;
-    bool mInverseMoveSignal;
 };
 
 Q_DECLARE_METATYPE(QAbstractItemModel::LayoutChangeHint)
@@ -4,6 +4,9 @@ INCLUDEPATH += $$PWD/model
 INCLUDEPATH += $$PWD/gui
 
 SOURCES += $$PWD/model/TransfersModel.cpp \
+           $$PWD/model/TransfersCounters.cpp \
+           $$PWD/model/TransfersBulkAction.cpp \
+           $$PWD/model/TransferLinksResolver.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeDialog.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeInfo.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeItem.cpp \
@@ -35,6 +38,9 @@ HEADERS += $$PWD/model/InfoDialogTransfersProxyModel.h \
            $$PWD/model/TransfersManagerSortFilterProxyModel.h \
            $$PWD/model/TransfersSortFilterProxyBaseModel.h \
            $$PWD/model/TransfersModel.h \
+           $$PWD/model/TransfersCounters.h \
+           $$PWD/model/TransfersBulkAction.h \
+           $$PWD/model/TransferLinksResolver.h \
            $$PWD/gui/InfoDialogTransferDelegateWidget.h \
            $$PWD/gui/InfoDialogTransfersWidget.h \
            $$PWD/gui/MegaTransferDelegate.h  \
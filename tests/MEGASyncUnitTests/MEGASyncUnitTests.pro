@@ -8,8 +8,17 @@ CONFIG += building_tests
 include(../../src/MEGASync/MEGASync.pro)
 include(../3rdparty/catch/catch.pri)
 include(../3rdparty/trompeloeil/trompeloeil.pri)
+
+INCLUDEPATH += $$PWD/../../src/MEGACrashAnalyzer
+HEADERS += $$PWD/../../src/MEGACrashAnalyzer/CrashCorpus.h
+SOURCES += $$PWD/../../src/MEGACrashAnalyzer/CrashCorpus.cpp
 SOURCES += GuestWidgetTest.cpp \
            Utilities.test.cpp \
+           UserAlertAggregator.Test.cpp \
            control/TransferRemainingTime.Test.cpp \
+           control/CrashStack.Test.cpp \
+           control/CrashSignature.Test.cpp \
+           transfers/TransfersCounters.Test.cpp \
+           transfers/TransfersModelReplay.Test.cpp \
            ScaleFactorManager.Test.cpp \
            main.cpp
@@ -0,0 +1,73 @@
+#include <catch.hpp>
+#include "UserAlertAggregator.h"
+
+namespace
+{
+UserAlertAggregator::Summary alert(const char* email, mega::MegaHandle node, long long items)
+{
+    UserAlertAggregator::Summary summary;
+    summary.type = mega::MegaUserAlert::TYPE_NEWSHAREDNODES;
+    summary.email = QString::fromUtf8(email);
+    summary.node = node;
+    summary.alerts = 1;
+    summary.items = items;
+    return summary;
+}
+}
+
+TEST_CASE("Alerts of the same user and node are summarized")
+{
+    UserAlertAggregator aggregator;
+    aggregator.add(0, alert("a@mega.nz", 1, 2));
+    aggregator.add(1000, alert("a@mega.nz", 1, 3));
+    aggregator.add(1500, alert("a@mega.nz", 2, 1));
+
+    // The window slides with every new alert
+    REQUIRE(aggregator.takeReady(UserAlertAggregator::WINDOW_MS).isEmpty());
+    REQUIRE(aggregator.nextRelease(UserAlertAggregator::WINDOW_MS) == 1000 + UserAlertAggregator::WINDOW_MS);
+
+    auto summaries = aggregator.takeReady(1500 + UserAlertAggregator::WINDOW_MS);
+    REQUIRE(summaries.size() == 2);
+    CHECK(summaries[0].node == 1);
+    CHECK(summaries[0].alerts == 2);
+    CHECK(summaries[0].items == 5);
+    CHECK(summaries[1].node == 2);
+    CHECK(summaries[1].items == 1);
+    CHECK(aggregator.nextRelease(0) == -1);
+}
+
+TEST_CASE("Groups are released after the maximum delay even if alerts keep arriving")
+{
+    UserAlertAggregator aggregator;
+    qint64 now = 0;
+    for (; now < UserAlertAggregator::MAX_DELAY_MS; now += UserAlertAggregator::WINDOW_MS / 2)
+    {
+        aggregator.add(now, alert("a@mega.nz", 1, 1));
+    }
+    REQUIRE(aggregator.takeReady(UserAlertAggregator::MAX_DELAY_MS).size() == 1);
+}
+
+TEST_CASE("Notifications of a user are rate limited")
+{
+    UserAlertAggregator aggregator;
+    const int groups = UserAlertAggregator::BURST + 2;
+    for (int node = 0; node < groups; node++)
+    {
+        aggregator.add(node, alert("a@mega.nz", node, 1));
+    }
+    aggregator.add(0, alert("b@mega.nz", 1, 1));
+
+    // Other users have their own bucket
+    const qint64 release = UserAlertAggregator::WINDOW_MS + groups;
+    REQUIRE(aggregator.takeReady(release).size() == UserAlertAggregator::BURST + 1);
+
+    // Alerts keep being added to the groups waiting for a token, the oldest group goes first
+    aggregator.add(release, alert("a@mega.nz", UserAlertAggregator::BURST, 1));
+    REQUIRE(aggregator.nextRelease(release + UserAlertAggregator::WINDOW_MS) == release + UserAlertAggregator::REFILL_MS);
+
+    auto summaries = aggregator.takeReady(release + UserAlertAggregator::REFILL_MS);
+    REQUIRE(summaries.size() == 1);
+    CHECK(summaries[0].node == UserAlertAggregator::BURST);
+    CHECK(summaries[0].items == 2);
+    REQUIRE(aggregator.takeReady(release + 2 * UserAlertAggregator::REFILL_MS).size() == 1);
+}
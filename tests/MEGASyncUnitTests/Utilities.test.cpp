@@ -52,3 +52,18 @@ TEST_CASE("Create time string")
     constexpr auto secondsPrecision{false};
     REQUIRE(Utilities::getTimeString((5*minuteSeconds) + 7, secondsPrecision).toStdString() == expected);
 }
+
+TEST_CASE("Get file type and icon from file name")
+{
+    CHECK(Utilities::getFileType(QString::fromUtf8("song.mp3")) == Utilities::FileType::TYPE_AUDIO);
+    CHECK(Utilities::getFileType(QString::fromUtf8("Movie.MKV")) == Utilities::FileType::TYPE_VIDEO);
+    CHECK(Utilities::getFileType(QString::fromUtf8("backup.tar.gz")) == Utilities::FileType::TYPE_ARCHIVE);
+    CHECK(Utilities::getFileType(QString::fromUtf8("sheet.ods")) == Utilities::FileType::TYPE_DOCUMENT);
+    CHECK(Utilities::getFileType(QString::fromUtf8("photo.tif")) == Utilities::FileType::TYPE_IMAGE);
+    CHECK(Utilities::getFileType(QString::fromUtf8("folder.jpg/file")) == Utilities::FileType::TYPE_OTHER);
+    CHECK(Utilities::getFileType(QString::fromUtf8("file.")) == Utilities::FileType::TYPE_OTHER);
+
+    CHECK(Utilities::getExtensionPixmapName(QString::fromUtf8("notes.TXT"), QString::fromUtf8(":/images/small_")).toStdString()
+          == ":/images/small_text.png");
+    CHECK(Utilities::getExtensionPixmapName(QString::fromUtf8("unknown.xyz"), QString()).toStdString() == "generic.png");
+}
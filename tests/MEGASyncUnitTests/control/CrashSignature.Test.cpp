@@ -0,0 +1,59 @@
+#include <catch.hpp>
+#include "CrashStack.h"
+#include "CrashCorpus.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace
+{
+QString crashReport(const char* faultAddress, const char* frames)
+{
+    return QString::fromUtf8("MEGAprivate ERROR DUMP\n"
+                             "Application: MEGAsync [64 bit]\n"
+                             "Version code: 1.0\n"
+                             "Module name: megasync\n"
+                             "Timestamp: 1000\n"
+                             "Error info:\n"
+                             "Segmentation fault (11) at address %1\n"
+                             "Stacktrace:\n"
+                             "%2")
+            .arg(QString::fromUtf8(faultAddress), QString::fromUtf8(frames));
+}
+
+// What CrashHandler sends for a dump written by the signal handler
+QString sentReport(const QString& dump, const QString& userComment)
+{
+    QString report = dump;
+    report.insert(report.indexOf(QString::fromUtf8("Version code: ")),
+                  QString::fromUtf8("Hash: %1\n").arg(CrashStack::signature(dump)));
+    return report + QString::fromUtf8("------------------------------\n%1\n------------------------------\n")
+            .arg(userComment);
+}
+}
+
+TEST_CASE("Crash report hash is the analyzer group key")
+{
+    auto first = crashReport("0x10", "/usr/bin/megasync+0x1a2b [0x55550001a2b]\n"
+                                     "/lib/libc.so.6+0x42 [0x7f0000000042]\n");
+    auto second = crashReport("0x20", "/opt/megasync+0x1a2b [0x56660001a2b] MegaApplication::run()+0x8\n"
+                                      "/usr/lib/libc.so.6+0x42 [0x7e0000000042] abort+0x12\n");
+    REQUIRE(CrashStack::signature(first) == CrashStack::signature(second));
+
+    QTemporaryDir folder;
+    REQUIRE(folder.isValid());
+    QFile file(folder.filePath(QString::fromUtf8("reports.txt")));
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write(sentReport(first, QString::fromUtf8("first")).toUtf8());
+    file.write(sentReport(second, QString::fromUtf8("second")).toUtf8());
+    file.close();
+
+    CrashCorpus corpus;
+    REQUIRE(corpus.load(folder.path()));
+    REQUIRE(corpus.versions().size() == 1);
+
+    auto groups = corpus.groups(corpus.versions().first());
+    REQUIRE(groups.size() == 1);
+    REQUIRE(groups.first().reports.size() == 2);
+    REQUIRE(groups.first().signature == CrashStack::signature(first));
+}
@@ -0,0 +1,41 @@
+#include <catch.hpp>
+#include "CrashStack.h"
+
+namespace
+{
+QString crashReport(const char* timestamp, const char* faultAddress, const char* frames)
+{
+    return QString::fromUtf8("MEGAprivate ERROR DUMP\n"
+                             "Application: MEGAsync [64 bit]\n"
+                             "Version code: 1.0\n"
+                             "Module name: megasync\n"
+                             "Timestamp: %1\n"
+                             "Error info:\n"
+                             "Segmentation fault (11) at address %2\n"
+                             "Stacktrace:\n"
+                             "%3")
+            .arg(QString::fromUtf8(timestamp), QString::fromUtf8(faultAddress), QString::fromUtf8(frames));
+}
+}
+
+TEST_CASE("Crash stack frames are parsed from module offsets")
+{
+    auto frames = CrashStack::parseFrames(crashReport("1", "0x0",
+                                                      "/usr/bin/megasync+0x1a2b [0x55550001a2b]\n"
+                                                      "/lib/libc.so.6+0x42 [0x7f0000000042] abort+0x12\n"));
+    REQUIRE(frames.size() == 2);
+    REQUIRE(frames[0].module == QString::fromUtf8("/usr/bin/megasync"));
+    REQUIRE(frames[0].offset == 0x1a2b);
+    REQUIRE(frames[0].address == 0x55550001a2bULL);
+    REQUIRE(frames[1].symbol == QString::fromUtf8("abort+0x12"));
+}
+
+TEST_CASE("Crash signature ignores timestamps and load addresses")
+{
+    auto first = crashReport("1000", "0x10", "/usr/bin/megasync+0x1a2b [0x55550001a2b]\n");
+    auto second = crashReport("2000", "0x20", "/opt/megasync+0x1a2b [0x56660001a2b] MegaApplication::run()+0x8\n");
+    auto other = crashReport("1000", "0x10", "/usr/bin/megasync+0x1a2c [0x55550001a2c]\n");
+
+    REQUIRE(CrashStack::signature(first) == CrashStack::signature(second));
+    REQUIRE(CrashStack::signature(first) != CrashStack::signature(other));
+}
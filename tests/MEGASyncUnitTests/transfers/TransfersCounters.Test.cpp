@@ -0,0 +1,46 @@
+#include <catch.hpp>
+#include "TransfersCounters.h"
+
+TEST_CASE("Transfers counters are updated by deltas")
+{
+    TransfersCounters counters;
+    {
+        TransfersCounters::Writer writer(counters);
+        writer.add(TransfersCounters::SCOPE_ALL, TransfersCounters::UPLOAD, TransfersCounters::TOTAL, 2);
+        writer.add(TransfersCounters::SCOPE_ALL, TransfersCounters::UPLOAD, TransfersCounters::PENDING, 2);
+        writer.add(TransfersCounters::SCOPE_ALL, TransfersCounters::DOWNLOAD, TransfersCounters::TOTAL_BYTES, 100);
+        writer.addByType(TransfersCounters::SCOPE_ALL, Utilities::FileType::TYPE_IMAGE, TransfersCounters::TYPE_STARTED, 2);
+    }
+    {
+        TransfersCounters::Writer writer(counters);
+        writer.add(TransfersCounters::SCOPE_ALL, TransfersCounters::UPLOAD, TransfersCounters::PENDING, -1);
+        writer.addByType(TransfersCounters::SCOPE_ALL, Utilities::FileType::TYPE_IMAGE, TransfersCounters::TYPE_FINISHED, 1);
+    }
+
+    auto count = counters.snapshot(TransfersCounters::SCOPE_ALL);
+    REQUIRE(count.totalUploads == 2);
+    REQUIRE(count.pendingUploads == 1);
+    REQUIRE(count.completedUploads() == 1);
+    REQUIRE(count.totalDownloadBytes == 100);
+    REQUIRE(count.getTransfersByType(Utilities::FileType::TYPE_IMAGE) == 2);
+    REQUIRE(count.getFinishedByType(Utilities::FileType::TYPE_IMAGE) == 1);
+    REQUIRE(count.getTransfersByType(Utilities::FileType::TYPE_VIDEO) == 0);
+
+    // The last scope is independent from the global one
+    REQUIRE(counters.snapshot(TransfersCounters::SCOPE_LAST).totalUploads == 0);
+}
+
+TEST_CASE("Clearing the last scope forgets its completed transfers")
+{
+    TransfersCounters counters;
+    {
+        TransfersCounters::Writer writer(counters);
+        writer.add(TransfersCounters::SCOPE_LAST, TransfersCounters::DOWNLOAD, TransfersCounters::TOTAL, 1);
+        writer.markCompleted(TransfersCounters::DOWNLOAD, 7);
+        writer.clear(TransfersCounters::SCOPE_LAST);
+    }
+
+    TransfersCounters::Writer writer(counters);
+    REQUIRE_FALSE(writer.unmarkCompleted(TransfersCounters::DOWNLOAD, 7));
+    REQUIRE(writer.value(TransfersCounters::SCOPE_LAST, TransfersCounters::DOWNLOAD, TransfersCounters::TOTAL) == 0);
+}
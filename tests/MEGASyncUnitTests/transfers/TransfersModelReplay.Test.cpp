@@ -0,0 +1,427 @@
+#include <catch.hpp>
+#include <trompeloeil.hpp>
+#include "TransfersModel.h"
+#include "TransfersManagerSortFilterProxyModel.h"
+#include "InfoDialogTransfersProxyModel.h"
+#include "control/Preferences.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Replays transfer events through the same objects the SDK events go through in the app:
+// QTMegaTransferListener -> TransferThread -> TransfersModel -> transfer proxy models.
+// The events are sent from a thread of their own, as the SDK does, and the test reports the
+// events per second, the p99 of the GUI thread stalls and the peak memory.
+//
+// The tests create no windows, they can be run with QT_QPA_PLATFORM=offscreen:
+//   QT_QPA_PLATFORM=offscreen MEGASyncUnitTests "[replay]"
+// The big replay is hidden, run it with "[benchmark]". It replays the events in the file set in
+// MEGASYNC_TRANSFERS_REPLAY instead of synthetic ones if there is one, with an event per line:
+//   <S|U|E|F> tag type state transferredBytes totalBytes speed isSync fileName
+// (start, update, temporary error, finish; type and state are MegaTransfer::TYPE_* and STATE_*)
+
+namespace
+{
+struct ReplayEvent
+{
+    enum Kind
+    {
+        START,
+        UPDATE,
+        TEMPORARY_ERROR,
+        FINISH
+    };
+
+    Kind kind;
+    int tag;
+    int type;
+    int state;
+    long long transferredBytes;
+    long long totalBytes;
+    long long speed;
+    bool sync;
+    std::string fileName;
+};
+
+class FakeTransfer : public mega::MegaTransfer
+{
+public:
+    FakeTransfer(const ReplayEvent& event, long long notificationNumber, long long deltaSize)
+        : mEvent(event),
+          mNotificationNumber(notificationNumber),
+          mDeltaSize(deltaSize)
+    {}
+
+    MegaTransfer* copy() override {return new FakeTransfer(*this);}
+
+    int getType() const override {return mEvent.type;}
+    int getTag() const override {return mEvent.tag;}
+    int getState() const override {return mEvent.state;}
+    const char* getPath() const override {return mEvent.fileName.c_str();}
+    const char* getParentPath() const override {return "/";}
+    const char* getFileName() const override {return mEvent.fileName.c_str();}
+    long long getTransferredBytes() const override {return mEvent.transferredBytes;}
+    long long getTotalBytes() const override {return mEvent.totalBytes;}
+    long long getDeltaSize() const override {return mDeltaSize;}
+    long long getSpeed() const override {return mEvent.speed;}
+    long long getMeanSpeed() const override {return mEvent.speed;}
+    int64_t getUpdateTime() const override {return 0;}
+    unsigned long long getPriority() const override {return static_cast<unsigned long long>(mEvent.tag);}
+    long long getNotificationNumber() const override {return mNotificationNumber;}
+    bool isSyncTransfer() const override {return mEvent.sync;}
+    bool isStreamingTransfer() const override {return false;}
+    bool isFolderTransfer() const override {return false;}
+    const mega::MegaError* getLastErrorExtended() const override {return nullptr;}
+    mega::MegaHandle getNodeHandle() const override {return mega::INVALID_HANDLE;}
+    mega::MegaHandle getParentHandle() const override {return mega::INVALID_HANDLE;}
+
+private:
+    ReplayEvent mEvent;
+    long long mNotificationNumber;
+    long long mDeltaSize;
+};
+
+class MegaApiMock : public mega::MegaApi
+{
+public:
+    MegaApiMock():mega::MegaApi("appKey"){};
+    MAKE_MOCK1(addTransferListener, void(mega::MegaTransferListener* listener), override);
+    MAKE_MOCK1(removeTransferListener, void(mega::MegaTransferListener* listener), override);
+    MAKE_MOCK2(pauseTransfers, void(bool pause, mega::MegaRequestListener* listener), override);
+    MAKE_MOCK3(pauseTransferByTag, void(int transferTag, bool pause, mega::MegaRequestListener* listener), override);
+    MAKE_MOCK1(getFirstTransfer, mega::MegaTransfer*(int type), override);
+};
+
+struct ReplayStats
+{
+    size_t events = 0;
+    double seconds = 0.;
+    qint64 p99StallMs = 0;
+    qint64 maxStallMs = 0;
+    long long peakMemoryBytes = 0;
+    int rows = 0;
+    int completedRows = 0;
+    int failedRows = 0;
+    int unfinishedRows = 0;
+};
+
+long long peakMemoryBytes()
+{
+#ifdef WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))
+            ? static_cast<long long>(counters.PeakWorkingSetSize) : 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<long long>(usage.ru_maxrss);
+#else
+    return static_cast<long long>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// Transfers run in groups of concurrent ones, as the SDK does: every transfer of a group is
+// started, updated a few times and finished. Some finish failed and some get a temporary error
+std::vector<ReplayEvent> syntheticEvents(int transfers, int concurrent, int updates)
+{
+    const char* names[] = {"photo.jpg", "clip.mp4", "notes.txt", "backup.zip", "song.mp3", "data.bin"};
+    std::mt19937 random(42);
+    std::uniform_int_distribution<long long> sizes(1024, 64 * 1024 * 1024);
+
+    std::vector<ReplayEvent> events;
+    events.reserve(static_cast<size_t>(transfers) * (updates + 3));
+    for (int first = 1; first <= transfers; first += concurrent)
+    {
+        const int last = std::min(transfers, first + concurrent - 1);
+        std::vector<ReplayEvent> group;
+        for (int tag = first; tag <= last; ++tag)
+        {
+            ReplayEvent event;
+            event.kind = ReplayEvent::START;
+            event.tag = tag;
+            event.type = tag % 3 ? mega::MegaTransfer::TYPE_DOWNLOAD : mega::MegaTransfer::TYPE_UPLOAD;
+            event.state = mega::MegaTransfer::STATE_QUEUED;
+            event.transferredBytes = 0;
+            event.totalBytes = sizes(random);
+            event.speed = 0;
+            event.sync = tag % 10 == 1;
+            event.fileName = std::to_string(tag) + names[tag % (sizeof(names) / sizeof(names[0]))];
+            group.push_back(event);
+            events.push_back(event);
+        }
+
+        for (int update = 1; update <= updates; ++update)
+        {
+            for (auto& event : group)
+            {
+                event.kind = (event.tag + update) % 97 ? ReplayEvent::UPDATE : ReplayEvent::TEMPORARY_ERROR;
+                event.state = mega::MegaTransfer::STATE_ACTIVE;
+                event.transferredBytes = event.totalBytes * update / (updates + 1);
+                event.speed = event.totalBytes / 10;
+                events.push_back(event);
+            }
+        }
+
+        for (auto& event : group)
+        {
+            event.kind = ReplayEvent::FINISH;
+            // Failed sync transfers are removed from the model, only the other ones fail here
+            if (!event.sync && event.tag % 50 == 0)
+            {
+                event.state = mega::MegaTransfer::STATE_FAILED;
+            }
+            else
+            {
+                event.state = mega::MegaTransfer::STATE_COMPLETED;
+                event.transferredBytes = event.totalBytes;
+            }
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+std::vector<ReplayEvent> recordedEvents(const QString& path)
+{
+    std::vector<ReplayEvent> events;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return events;
+    }
+
+    while (!file.atEnd())
+    {
+        const QList<QByteArray> fields = file.readLine().trimmed().split(' ');
+        if (fields.size() < 9)
+        {
+            continue;
+        }
+
+        ReplayEvent event;
+        switch (fields[0].at(0))
+        {
+            case 'S': event.kind = ReplayEvent::START; break;
+            case 'U': event.kind = ReplayEvent::UPDATE; break;
+            case 'E': event.kind = ReplayEvent::TEMPORARY_ERROR; break;
+            case 'F': event.kind = ReplayEvent::FINISH; break;
+            default: continue;
+        }
+        event.tag = fields[1].toInt();
+        event.type = fields[2].toInt();
+        event.state = fields[3].toInt();
+        event.transferredBytes = fields[4].toLongLong();
+        event.totalBytes = fields[5].toLongLong();
+        event.speed = fields[6].toLongLong();
+        event.sync = fields[7].toInt() != 0;
+        // File names can have spaces
+        event.fileName = fields.mid(8).join(' ').toStdString();
+        events.push_back(event);
+    }
+    return events;
+}
+
+// Transfers expected in the model at the end and how many of them failed
+void expectedRows(const std::vector<ReplayEvent>& events, int& rows, int& failed)
+{
+    std::map<int, int> finalStates;
+    for (const auto& event : events)
+    {
+        finalStates[event.tag] = event.sync && event.state == mega::MegaTransfer::STATE_FAILED
+                ? mega::MegaTransfer::STATE_CANCELLED : event.state;
+    }
+
+    rows = 0;
+    failed = 0;
+    for (const auto& state : finalStates)
+    {
+        if (state.second != mega::MegaTransfer::STATE_CANCELLED)
+        {
+            rows++;
+            failed += state.second == mega::MegaTransfer::STATE_FAILED;
+        }
+    }
+}
+
+ReplayStats replay(const std::vector<ReplayEvent>& events, int timeoutMs)
+{
+    QTemporaryDir dataDir;
+    auto preferences (Preferences::instance());
+    if (preferences->getDataPath().isEmpty())
+    {
+        preferences->initialize(dataDir.path());
+    }
+
+    int rows = 0;
+    int failed = 0;
+    expectedRows(events, rows, failed);
+
+    mega::MegaTransferListener* listener = nullptr;
+    const auto megaApiMock{std::make_unique<MegaApiMock>()};
+    ALLOW_CALL(*megaApiMock, addTransferListener(trompeloeil::_)).LR_SIDE_EFFECT(listener = _1);
+    ALLOW_CALL(*megaApiMock, removeTransferListener(trompeloeil::_));
+    ALLOW_CALL(*megaApiMock, pauseTransfers(trompeloeil::_, trompeloeil::_));
+    ALLOW_CALL(*megaApiMock, pauseTransferByTag(trompeloeil::_, trompeloeil::_, trompeloeil::_));
+    ALLOW_CALL(*megaApiMock, getFirstTransfer(trompeloeil::_)).RETURN(nullptr);
+
+    ReplayStats stats;
+    stats.events = events.size();
+    {
+        TransfersModel model(megaApiMock.get(), nullptr);
+        TransfersManagerSortFilterProxyModel managerProxy;
+        managerProxy.setSourceModel(&model);
+        InfoDialogTransfersProxyModel infoDialogProxy(nullptr);
+        infoDialogProxy.setSourceModel(&model);
+        REQUIRE(listener);
+
+        // The GUI thread should get a heartbeat tick every interval, any delay is a stall
+        const int heartbeatMs = 5;
+        std::vector<qint64> stalls;
+        QElapsedTimer sinceTick;
+        QTimer heartbeat;
+        heartbeat.setTimerType(Qt::PreciseTimer);
+        heartbeat.setInterval(heartbeatMs);
+        QObject::connect(&heartbeat, &QTimer::timeout, [&]()
+        {
+            stalls.push_back(std::max<qint64>(0, sinceTick.restart() - heartbeatMs));
+        });
+
+        QElapsedTimer elapsed;
+        elapsed.start();
+        sinceTick.start();
+        heartbeat.start();
+
+        std::thread sdkThread([&]()
+        {
+            mega::MegaError ok(mega::MegaError::API_OK);
+            mega::MegaError error(mega::MegaError::API_EFAILED);
+            std::map<int, long long> transferred;
+            long long notificationNumber = 0;
+            for (const auto& event : events)
+            {
+                auto& previous = transferred[event.tag];
+                FakeTransfer transfer(event, ++notificationNumber, event.transferredBytes - previous);
+                previous = event.transferredBytes;
+
+                switch (event.kind)
+                {
+                    case ReplayEvent::START:
+                        listener->onTransferStart(megaApiMock.get(), &transfer);
+                        break;
+                    case ReplayEvent::UPDATE:
+                        listener->onTransferUpdate(megaApiMock.get(), &transfer);
+                        break;
+                    case ReplayEvent::TEMPORARY_ERROR:
+                        listener->onTransferTemporaryError(megaApiMock.get(), &transfer, &error);
+                        break;
+                    case ReplayEvent::FINISH:
+                        listener->onTransferFinish(megaApiMock.get(), &transfer,
+                                                   event.state == mega::MegaTransfer::STATE_FAILED ? &error : &ok);
+                        break;
+                }
+            }
+        });
+
+        // Replay is over when every transfer is in the model in its final state
+        QEventLoop loop;
+        QTimer check;
+        QObject::connect(&check, &QTimer::timeout, [&]()
+        {
+            model.lockModelMutex(true);
+            stats.rows = model.rowCount();
+            stats.completedRows = 0;
+            stats.failedRows = 0;
+            stats.unfinishedRows = 0;
+            for (int row = 0; row < stats.rows; ++row)
+            {
+                auto data = qvariant_cast<TransferItem>(model.index(row, 0).data()).getTransferData();
+                if (data->isCompleted())
+                {
+                    stats.completedRows++;
+                }
+                else if (data->isFailed())
+                {
+                    stats.failedRows++;
+                }
+                else
+                {
+                    stats.unfinishedRows++;
+                }
+            }
+            model.lockModelMutex(false);
+
+            if ((stats.rows == rows && stats.unfinishedRows == 0) || elapsed.elapsed() > timeoutMs)
+            {
+                loop.quit();
+            }
+        });
+        check.start(200);
+        loop.exec();
+
+        stats.seconds = elapsed.elapsed() / 1000.;
+        heartbeat.stop();
+        sdkThread.join();
+
+        // The model uses the mock from worker threads
+        model.pauseModelProcessing(true);
+        QThreadPool::globalInstance()->waitForDone();
+        QCoreApplication::processEvents();
+
+        std::sort(stalls.begin(), stalls.end());
+        if (!stalls.empty())
+        {
+            stats.p99StallMs = stalls[stalls.size() * 99 / 100];
+            stats.maxStallMs = stalls.back();
+        }
+    }
+    stats.peakMemoryBytes = peakMemoryBytes();
+
+    std::cout << "Transfers replay: " << stats.events << " events, "
+              << static_cast<long long>(stats.events / std::max(stats.seconds, 0.001)) << " events/s, "
+              << "p99 GUI stall " << stats.p99StallMs << " ms (max " << stats.maxStallMs << " ms), "
+              << "peak memory " << stats.peakMemoryBytes / (1024 * 1024) << " MB" << std::endl;
+
+    CHECK(stats.rows == rows);
+    CHECK(stats.failedRows == failed);
+    CHECK(stats.unfinishedRows == 0);
+    return stats;
+}
+}
+
+TEST_CASE("Replayed transfer events end up in the transfers model", "[replay]")
+{
+    const auto events = syntheticEvents(5000, 500, 4);
+    replay(events, 120 * 1000);
+}
+
+TEST_CASE("Transfers model replay benchmark", "[.][replay][benchmark]")
+{
+    const QString recording = QString::fromLocal8Bit(qgetenv("MEGASYNC_TRANSFERS_REPLAY"));
+    const auto events = recording.isEmpty() ? syntheticEvents(150000, 2000, 8) : recordedEvents(recording);
+    REQUIRE_FALSE(events.empty());
+    replay(events, 30 * 60 * 1000);
+}